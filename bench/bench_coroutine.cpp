@@ -0,0 +1,119 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "mn_coroutine.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE_SUPPORT == MN_THREAD_CONFIG_YES
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    basic_coro_task consumer(queue::queue_t& q, uint64_t count, latency_recorder* rec,
+                             basic_atomic_gcc<uint64_t>* done) {
+        for(uint64_t k = 0; k < count; k++) {
+            uint64_t _stamp = 0;
+            co_await coro_dequeue(q, &_stamp);
+            rec->add(now_ns() - _stamp);
+        }
+        done->fetch_add(1);
+    }
+
+    basic_coro_task yielder(uint64_t count, basic_atomic_gcc<uint64_t>* done) {
+        for(uint64_t k = 0; k < count; k++)
+            co_await coro_yield();
+        done->fetch_add(1);
+    }
+
+    void wait_done(basic_atomic_gcc<uint64_t>& done, uint64_t n) {
+        while(done.load() != n) vTaskDelay(1);
+    }
+}
+
+/**
+ * n consumer coroutines on one executor task, one producer task enqueues and
+ * wakes the executor. The latency is the time from the enqueue to the resume
+ */
+static void bench_coroutine_queue(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        queue::queue_t _queue(64, sizeof(uint64_t));
+        _queue.create();
+
+        uint64_t _perConsumer = opts.ops / 10 / n;
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perConsumer));
+        basic_atomic_gcc<uint64_t> _done(0);
+
+        basic_coro_executor _executor("coro", basic_task::PriorityNormal, 4096);
+        _executor.start();
+        for(int i = 0; i < n; i++)
+            _executor.spawn(consumer(_queue, _perConsumer, &_recs[i], &_done));
+
+        uint64_t _start = now_ns();
+        for(uint64_t k = 0; k < _perConsumer * n; k++) {
+            uint64_t _stamp = now_ns();
+            _queue.enqueue(&_stamp, portMAX_DELAY);
+            _executor.notify();
+        }
+        wait_done(_done, n);
+
+        result _res("coroutine", "queue_consumers", 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _perConsumer * n;
+
+        _executor.stop();
+        _queue.destroy();
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * n coroutines yield again and again, the cost of one switch on the executor
+ */
+static void bench_coroutine_yield(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        uint64_t _perCoroutine = opts.ops / n;
+        basic_atomic_gcc<uint64_t> _done(0);
+
+        basic_coro_executor _executor("coro", basic_task::PriorityNormal, 4096);
+        _executor.start();
+
+        uint64_t _start = now_ns();
+        for(int i = 0; i < n; i++)
+            _executor.spawn(yielder(_perCoroutine, &_done));
+        wait_done(_done, n);
+
+        result _res("coroutine", "yield", n, 1);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _perCoroutine * n;
+
+        _executor.stop();
+        out.report(_res);
+    }
+}
+
+static void bench_coroutine(const options& opts, reporter& out) {
+    bench_coroutine_queue(opts, out);
+    bench_coroutine_yield(opts, out);
+}
+
+MN_BENCH_REGISTER(coroutine, bench_coroutine)
+
+#endif // MN_THREAD_CONFIG_COROUTINE_SUPPORT
@@ -0,0 +1,73 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "mn_future.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+/**
+ * Request / response round trips: the caller runs a job on a multi engine 
+ * and waits for the result - with async (the item pool) or with a promise 
+ * on the stack and queue_fn. The latency is one round trip
+ */
+static void bench_future_roundtrip(const options& opts, reporter& out, const char* strName, bool useAsync) {
+    for(int n : opts.thread_counts()) {
+        uint64_t _ops = opts.ops / 10;
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, (uint8_t)n);
+        _queue.create();
+
+        latency_recorder _rec(_ops);
+        uint64_t _start = now_ns();
+        uint64_t _sum = 0;
+
+        for(uint64_t i = 0; i < _ops; i++) {
+            uint64_t _begin = now_ns();
+
+            if(useAsync) {
+                future_t<uint64_t> _future = async(_queue, [i]() { return i * 2; }, portMAX_DELAY);
+                _sum += _future.get();
+            } else {
+                promise_t<uint64_t> _promise;
+                future_t<uint64_t> _future = _promise.get_future();
+
+                _queue.queue_fn([&_promise, i]() { _promise.set_value(i * 2); }, portMAX_DELAY);
+                _sum += _future.get();
+            }
+            _rec.add(now_ns() - _begin);
+        }
+
+        result _res("future", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = (_sum != 0) ? _ops : 0;
+
+        _queue.destroy();
+
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+static void bench_future(const options& opts, reporter& out) {
+    bench_future_roundtrip(opts, out, "async_get", true);
+    bench_future_roundtrip(opts, out, "promise_get", false);
+}
+
+MN_BENCH_REGISTER(future, bench_future)
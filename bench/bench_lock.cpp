@@ -0,0 +1,120 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+/**
+ * n tasks increment one counter under the lock,
+ * the latency is the time to get the lock
+ */
+template <class TLOCK>
+static void bench_lock_contention(const char* strName, const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        TLOCK _lock;
+        uint64_t _counter = 0;
+
+        uint64_t _perTask = opts.ops / n;
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add(strName, [&, _rec]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    _lock.lock(portMAX_DELAY);
+                    _rec->add(now_ns() - _start);
+                    _counter++;
+                    _lock.unlock();
+                }
+            });
+        }
+
+        result _res("lock", strName, n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _counter;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * n pairs of tasks ping pong over two binary semaphores,
+ * the latency is the half round trip time
+ */
+static void bench_lock_handoff(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        // 2 handoffs per round
+        uint64_t _rounds = opts.ops / (2 * n);
+
+        std::vector<binary_semaphore_t*> _ping, _pong;
+        std::vector<latency_recorder> _recs(n, latency_recorder(_rounds));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            binary_semaphore_t* _a = new binary_semaphore_t();
+            binary_semaphore_t* _b = new binary_semaphore_t();
+            // created given, start both empty
+            _a->lock(0); _b->lock(0);
+            _ping.push_back(_a); _pong.push_back(_b);
+
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("ping", [&, _a, _b, _rec]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _rounds; k++) {
+                    uint64_t _start = now_ns();
+                    _a->unlock();
+                    _b->lock(portMAX_DELAY);
+                    _rec->add((now_ns() - _start) / 2);
+                }
+            });
+            _group.add("pong", [&, _a, _b]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _rounds; k++) {
+                    _a->lock(portMAX_DELAY);
+                    _b->unlock();
+                }
+            });
+        }
+
+        result _res("lock", "binary_semaphore_handoff", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _rounds * 2 * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+
+        for(int i = 0; i < n; i++) { delete _ping[i]; delete _pong[i]; }
+    }
+}
+
+static void bench_lock(const options& opts, reporter& out) {
+    bench_lock_contention<mutex_t>("mutex_contention", opts, out);
+    bench_lock_contention<binary_semaphore_t>("binary_semaphore_contention", opts, out);
+    bench_lock_handoff(opts, out);
+}
+
+MN_BENCH_REGISTER(lock, bench_lock)
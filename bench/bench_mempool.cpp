@@ -0,0 +1,76 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+/**
+ * n tasks allocate and free one chunk in a loop from one pool,
+ * the latency is one allocate + free pair
+ */
+template <class TPOOL>
+static void bench_mempool_alloc_free(const char* strName, const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        TPOOL _pool;
+        _pool.create(portMAX_DELAY);
+
+        // hold the most chunks, so the tasks use the last free chunks
+        std::vector<uint64_t*> _held;
+        for(int i = 0; i < 256 - 16 * n; i++) _held.push_back(_pool.allocate());
+
+        uint64_t _perTask = (opts.ops / 16) / n;
+        if(_perTask == 0) _perTask = 1;
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("alloc", [&, _rec]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    uint64_t* _mem = _pool.allocate();
+                    if(_mem) _pool.free(_mem);
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("mempool", strName, n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        for(auto it = _held.begin(); it != _held.end(); it++) _pool.free(*it);
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+static void bench_mempool(const options& opts, reporter& out) {
+    bench_mempool_alloc_free<memory::basic_mempool_vector<uint64_t, 256> >("vector_alloc_free", opts, out);
+    bench_mempool_alloc_free<memory::basic_mempool_slab<uint64_t, 256> >("slab_alloc_free", opts, out);
+    bench_mempool_alloc_free<memory::basic_mempool_magazine_t<uint64_t, 256> >("magazine_alloc_free", opts, out);
+    bench_mempool_alloc_free<memory::basic_mempool_lockfree<uint64_t, 256> >("lockfree_alloc_free", opts, out);
+}
+
+MN_BENCH_REGISTER(mempool, bench_mempool)
@@ -0,0 +1,97 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_parallel.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    struct less_u32 {
+        bool operator()(uint32_t a, uint32_t b) const { return a < b; }
+    };
+
+    /**
+     * A filter step of a sample buffer, some cpu work for each element
+     */
+    inline float filter_sample(float x) {
+        for(int i = 0; i < 16; i++) x = x * 0.5f + 1.0f / (1.0f + x * x);
+        return x;
+    }
+}
+
+/**
+ * parallel_transform (filter a sample buffer) and parallel_sort (an event log)
+ * with n tasks on a multi engine with n workers. n = 1 is the sequential run
+ */
+static void bench_parallel(const options& opts, reporter& out) {
+    const uint32_t _n = (uint32_t)opts.ops;
+    const uint32_t _rounds = 8;
+
+    std::vector<float> _samples(_n), _filtered(_n);
+    for(uint32_t i = 0; i < _n; i++) _samples[i] = (float)(i % 1000) / 100.0f;
+
+    std::vector<uint32_t> _log(_n), _sorted(_n);
+    uint32_t _x = 2463534242u;
+    for(auto& v : _log) { _x ^= _x << 13; _x ^= _x >> 17; _x ^= _x << 5; v = _x; }
+
+    for(int n : opts.thread_counts()) {
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 16, (uint8_t)n);
+        _queue.create();
+        {
+            latency_recorder _rec(_rounds);
+            uint64_t _start = now_ns();
+
+            for(uint32_t r = 0; r < _rounds; r++) {
+                uint64_t _begin = now_ns();
+                parallel_transform(_queue, _samples.data(), _samples.data() + _n, _filtered.data(),
+                                   filter_sample, 256, (uint8_t)n);
+                _rec.add(now_ns() - _begin);
+            }
+            result _res("parallel", "transform_filter", 1, n);
+            _res.elapsed_ns = now_ns() - _start;
+            _res.ops = (uint64_t)_n * _rounds;
+            _res.set_latency(_rec);
+            out.report(_res);
+        }
+        {
+            latency_recorder _rec(_rounds);
+            uint64_t _elapsed = 0;
+
+            for(uint32_t r = 0; r < _rounds; r++) {
+                _sorted = _log;
+
+                uint64_t _begin = now_ns();
+                parallel_sort(_queue, _sorted.data(), _sorted.data() + _n, less_u32(), 256, (uint8_t)n);
+                uint64_t _time = now_ns() - _begin;
+
+                _elapsed += _time;
+                _rec.add(_time);
+            }
+            result _res("parallel", "sort_u32", 1, n);
+            _res.elapsed_ns = _elapsed;
+            _res.ops = (uint64_t)_n * _rounds;
+            _res.set_latency(_rec);
+            out.report(_res);
+        }
+        _queue.destroy();
+    }
+}
+
+MN_BENCH_REGISTER(parallel, bench_parallel)
@@ -0,0 +1,66 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+/**
+ * n producers send timestamps through one queue to n consumers,
+ * the latency is the time from the enqueue to the dequeue
+ */
+static void bench_queue_mpmc(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        queue::queue_t _queue(64, sizeof(uint64_t));
+        _queue.create();
+
+        uint64_t _perProducer = opts.ops / n;
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perProducer));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            _group.add("producer", [&]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perProducer; k++) {
+                    uint64_t _stamp = now_ns();
+                    _queue.enqueue(&_stamp, portMAX_DELAY);
+                }
+            });
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("consumer", [&, _rec]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perProducer; k++) {
+                    uint64_t _stamp = 0;
+                    _queue.dequeue(&_stamp, portMAX_DELAY);
+                    _rec->add(now_ns() - _stamp);
+                }
+            });
+        }
+
+        result _res("queue", "mpmc", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perProducer * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+MN_BENCH_REGISTER(queue, bench_queue_mpmc)
@@ -0,0 +1,271 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "mn_static_task.hpp"
+#include "mn_task_pool.hpp"
+#include "mn_future.hpp"
+#include "mn_task_list.hpp"
+
+#include <stdio.h>
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    class empty_task : public basic_task {
+    public:
+        empty_task(std::string strName = "bench_empty") 
+            : basic_task(strName, basic_task::PriorityNormal, 2048) { }
+        virtual void* on_task() override { return NULL; }
+    };
+}
+
+/**
+ * n tasks create, start and join a empty task in a loop,
+ * the latency is one start + join cycle
+ */
+static void bench_task_start_join(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        // creating tasks is expensive
+        uint64_t _perTask = (opts.ops / 64) / n;
+        if(_perTask == 0) _perTask = 1;
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("starter", [&, _rec]() {
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    empty_task* _task = new empty_task();
+                    _task->start();
+                    _task->join();
+                    delete _task;
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("task", "start_join", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * n tasks start and join a basic_static_task with a empty callable in a loop,
+ * the object is reused - the latency is one start + join cycle
+ */
+static void bench_task_static_start_join(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        uint64_t _perTask = (opts.ops / 64) / n;
+        if(_perTask == 0) _perTask = 1;
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("starter", [&, _rec]() {
+                auto _task = make_static_task<2048>("bench_static", []() { });
+
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    _task.start();
+                    _task.join();
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("task", "static_start_join", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * n tasks run a empty callable on a task pool with n not pinned tasks and 
+ * wait for the end - the latency is one run + wait round trip
+ */
+static void bench_task_pool_run(const options& opts, reporter& out) {
+    for(int n : opts.thread_counts()) {
+        uint64_t _perTask = (opts.ops / 4) / n;
+
+        basic_task_pool _pool;
+        _pool.create(0, n);
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("starter", [&, _rec]() {
+                basic_future_state<void> _done;
+
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    _done.reset();
+                    _pool.run_fn([&_done]() { _done.set_value(); });
+                    _done.wait(portMAX_DELAY);
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("task", "pool_run", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        _pool.destroy();
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * n tasks start 16 empty tasks and join them one by one or with join_all,
+ * the latency is one fan-out + fan-in
+ */
+static void bench_task_fanout(const options& opts, reporter& out, bool joinAll) {
+    const int _fanOut = 16;
+
+    for(int n : opts.thread_counts()) {
+        uint64_t _perTask = (opts.ops / 1024) / n;
+        if(_perTask == 0) _perTask = 1;
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("starter", [&, _rec]() {
+                empty_task _tasks[_fanOut];
+                basic_task* _list[_fanOut];
+                for(int t = 0; t < _fanOut; t++) _list[t] = &_tasks[t];
+
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    uint64_t _start = now_ns();
+                    for(int t = 0; t < _fanOut; t++) _tasks[t].start();
+
+                    if(joinAll) basic_task::join_all(_list, _fanOut);
+                    else for(int t = 0; t < _fanOut; t++) _tasks[t].join();
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("task", joinAll ? "fanout_join_all" : "fanout_join", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+}
+
+/**
+ * 256 tasks are in the basic_task_list, n tasks get a task by id and 
+ * by name in a loop - the latency is one lookup
+ */
+static void bench_task_list_get(const options& opts, reporter& out) {
+    const int _numTasks = 256;
+
+    basic_task_list& _list = basic_task_list::instance();
+    std::vector<empty_task*> _tasks;
+
+    for(int i = 0; i < _numTasks; i++) {
+        char _name[16];
+        snprintf(_name, sizeof(_name), "bench_%d", i);
+
+        empty_task* _task = new empty_task(_name);
+        _task->start();
+        _task->join();
+
+        _list.add_task(_task);
+        _tasks.push_back(_task);
+    }
+
+    for(int n : opts.thread_counts()) {
+        uint64_t _perTask = opts.ops / n;
+
+        std::vector<latency_recorder> _recs(n, latency_recorder(_perTask));
+        task_group _group;
+
+        for(int i = 0; i < n; i++) {
+            latency_recorder* _rec = &_recs[i];
+
+            _group.add("reader", [&, _rec, i]() {
+                char _name[16];
+
+                _group.wait_for_start();
+                for(uint64_t k = 0; k < _perTask; k++) {
+                    empty_task* _task = _tasks[(k + i) % _numTasks];
+                    snprintf(_name, sizeof(_name), "bench_%d", (int)((k + i) % _numTasks));
+
+                    uint64_t _start = now_ns();
+                    if(k & 1) _list.get_task(_name);
+                    else _list.get_task(_task->get_id());
+                    _rec->add(now_ns() - _start);
+                }
+            });
+        }
+
+        result _res("task", "list_get", n, n);
+        _res.elapsed_ns = _group.run();
+        _res.ops = _perTask * n;
+
+        for(int i = 1; i < n; i++) _recs[0].merge(_recs[i]);
+        _res.set_latency(_recs[0]);
+        out.report(_res);
+    }
+
+    for(size_t i = 0; i < _tasks.size(); i++)
+        delete _tasks[i];
+}
+
+static void bench_task_suite(const options& opts, reporter& out) {
+    bench_task_start_join(opts, out);
+    bench_task_static_start_join(opts, out);
+    bench_task_pool_run(opts, out);
+    bench_task_list_get(opts, out);
+    bench_task_fanout(opts, out, false);
+    bench_task_fanout(opts, out, true);
+}
+
+MN_BENCH_REGISTER(task, bench_task_suite)
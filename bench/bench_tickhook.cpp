@@ -0,0 +1,81 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+
+#if ( configUSE_TICK_HOOK == 1 )
+
+#include "mn_tickhook.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    class bench_entry : public base_tickhook_entry {
+    public:
+        bench_entry() : base_tickhook_entry(0, false), calls(0) { }
+
+        uint64_t calls;
+    protected:
+        virtual void onTick(const unsigned int) override { calls++; }
+    };
+
+    // static, the tickhook holds only the pointers
+    bench_entry g_entries[8];
+}
+
+/**
+ * Dispatch one tick with k registered entries in a loop,
+ * the latency is one dispatch of all entries
+ */
+static void bench_tickhook_dispatch(const options& opts, reporter& out) {
+    const int _entries[] = { 1, 4, 8 };
+    base_tickhook& _hook = base_tickhook::instance();
+
+    for(int k : _entries) {
+        uint64_t _ticks = opts.ops / 16;
+        latency_recorder _rec(_ticks);
+
+        _hook.clear();
+        for(int i = 0; i < k; i++) {
+            g_entries[i].calls = 0;
+            g_entries[i].start();
+            _hook.enqueue(&g_entries[i]);
+        }
+
+        uint64_t _start = now_ns();
+        for(uint64_t t = 0; t < _ticks; t++) {
+            uint64_t _tick = now_ns();
+            _hook.onApplicationTickHook();
+            _rec.add(now_ns() - _tick);
+        }
+
+        result _res("tickhook", "dispatch", k, 1);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _ticks;
+
+        for(int i = 0; i < k; i++) g_entries[i].stop();
+        _hook.clear();
+
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+MN_BENCH_REGISTER(tickhook, bench_tickhook_dispatch)
+
+#endif
@@ -0,0 +1,250 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A preallocated work item, stamp the enqueue and the done time
+     */
+    class bench_item : public queue::work_queue_item_t {
+    public:
+        bench_item() : queue::work_queue_item_t(false), enqueued(0), done(0), spin_ns(0), 
+            sleep_ns(0), counter(NULL) { }
+
+        virtual bool on_work() override {
+            // simulate a cpu bound job, to show the scaling with the worker count
+            if(spin_ns != 0) {
+                uint64_t _end = now_ns() + spin_ns;
+                while(now_ns() < _end) { }
+            }
+            // simulate a blocking job (i.e. I/O), scale with the worker count on one core too
+            if(sleep_ns != 0) {
+                struct timespec ts = { 0, (long)sleep_ns };
+                nanosleep(&ts, NULL);
+            }
+            done = now_ns();
+            (*counter)++;
+            return true;
+        }
+
+        uint64_t enqueued;
+        uint64_t done;
+        uint64_t spin_ns;
+        uint64_t sleep_ns;
+        atomic_uint64_t* counter;
+    };
+
+    /**
+     * A heap allocated work item, deleted from the work queue after the run
+     */
+    class heap_item : public queue::work_queue_item_t {
+    public:
+        explicit heap_item(atomic_uint64_t* c) : queue::work_queue_item_t(true), counter(c) { }
+
+        virtual bool on_work() override { (*counter)++; return true; }
+
+        atomic_uint64_t* counter;
+    };
+}
+
+/**
+ * One producer queue items to a multi engine work queue with n workers,
+ * the latency is the time from the queue call to the end of on_work
+ */
+static void bench_workqueue_run(const options& opts, reporter& out, const char* strName, 
+                                uint64_t ops, uint64_t spin_ns, uint64_t sleep_ns) {
+    for(int n : opts.thread_counts()) {
+        atomic_uint64_t _done(0);
+
+        std::vector<bench_item> _items(ops);
+        for(auto& it : _items) { it.counter = &_done; it.spin_ns = spin_ns; it.sleep_ns = sleep_ns; }
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, (uint8_t)n);
+        _queue.create();
+
+        uint64_t _start = now_ns();
+
+        for(auto& it : _items) {
+            it.enqueued = now_ns();
+            _queue.queue(&it, portMAX_DELAY);
+        }
+        while(_done.load() < ops) vTaskDelay(1);
+
+        result _res("workqueue", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = ops;
+
+        _queue.destroy();
+
+        latency_recorder _rec(ops);
+        for(auto& it : _items) _rec.add(it.done - it.enqueued);
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+/**
+ * One producer queue bursts of 64 items and waits for the end of each burst,
+ * with queue() for each item or with one queue_bulk() for the burst 
+ */
+static void bench_workqueue_burst(const options& opts, reporter& out, const char* strName, bool bulk) {
+    const uint32_t _burst = 64;
+
+    for(int n : opts.thread_counts()) {
+        uint64_t _ops = (opts.ops / 4 / _burst) * _burst;
+        atomic_uint64_t _done(0);
+
+        std::vector<bench_item> _items(_ops);
+        std::vector<queue::work_queue_item_t*> _ptrs(_ops);
+        for(uint64_t i = 0; i < _ops; i++) { _items[i].counter = &_done; _ptrs[i] = &_items[i]; }
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, _burst, (uint8_t)n);
+        _queue.create();
+
+        uint64_t _start = now_ns();
+
+        for(uint64_t b = 0; b < _ops; b += _burst) {
+            uint64_t _now = now_ns();
+            for(uint32_t i = 0; i < _burst; i++) _items[b + i].enqueued = _now;
+
+            if(bulk) {
+                _queue.queue_bulk(&_ptrs[b], _burst, portMAX_DELAY);
+            } else {
+                for(uint32_t i = 0; i < _burst; i++) _queue.queue(_ptrs[b + i], portMAX_DELAY);
+            }
+            while(_done.load() < b + _burst) taskYIELD();
+        }
+
+        result _res("workqueue", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _ops;
+
+        _queue.destroy();
+
+        latency_recorder _rec(_ops);
+        for(auto& it : _items) _rec.add(it.done - it.enqueued);
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+/**
+ * One producer queue bursts of 32 blocking items (100us), a elastic pool starts 
+ * with one worker and grows up to n workers, a fixed pool runs always n workers
+ */
+static void bench_workqueue_elastic(const options& opts, reporter& out, const char* strName, bool elastic) {
+    const uint32_t _burst = 32;
+
+    for(int n : opts.thread_counts()) {
+        uint64_t _ops = (opts.ops / 200 / _burst) * _burst;
+        atomic_uint64_t _done(0);
+
+        std::vector<bench_item> _items(_ops);
+        for(auto& it : _items) { it.counter = &_done; it.sleep_ns = 100000; }
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, 
+                                            (uint8_t)n, elastic ? 1 : (uint8_t)n);
+        _queue.create();
+
+        uint64_t _start = now_ns();
+
+        for(uint64_t b = 0; b < _ops; b += _burst) {
+            for(uint32_t i = 0; i < _burst; i++) {
+                _items[b + i].enqueued = now_ns();
+                _queue.queue(&_items[b + i], portMAX_DELAY);
+            }
+            while(_done.load() < b + _burst) vTaskDelay(1);
+        }
+
+        result _res("workqueue", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _ops;
+
+        _queue.destroy();
+
+        latency_recorder _rec(_ops);
+        for(auto& it : _items) _rec.add(it.done - it.enqueued);
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+/**
+ * One producer submits empty jobs, each job a new heap item (deleted after the 
+ * run) or a lambda with queue_fn in the item pool of the work queue. The 
+ * latency is the time of the submit call
+ */
+static void bench_workqueue_alloc(const options& opts, reporter& out, const char* strName, bool pooled) {
+    for(int n : opts.thread_counts()) {
+        uint64_t _ops = opts.ops / 4;
+        atomic_uint64_t _done(0);
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, (uint8_t)n);
+        _queue.create();
+
+        latency_recorder _rec(_ops);
+        uint64_t _start = now_ns();
+
+        for(uint64_t i = 0; i < _ops; i++) {
+            uint64_t _begin = now_ns();
+
+            if(pooled) {
+                // the pool is empty, wait for the workers
+                while(_queue.queue_fn([&_done]() { _done++; }, portMAX_DELAY) != ERR_WORKQUEUE_OK)
+                    taskYIELD();
+            } else {
+                _queue.queue(new heap_item(&_done), portMAX_DELAY);
+            }
+            _rec.add(now_ns() - _begin);
+        }
+        while(_done.load() < _ops) vTaskDelay(1);
+
+        result _res("workqueue", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _ops;
+
+        _queue.destroy();
+
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+static void bench_workqueue_multi(const options& opts, reporter& out) {
+    // empty jobs, the engine overhead
+    bench_workqueue_run(opts, out, "multi_throughput", opts.ops / 4, 0, 0);
+    // 20us cpu bound jobs, the scaling with the worker count up to the core count
+    bench_workqueue_run(opts, out, "multi_cpu", opts.ops / 20, 20000, 0);
+    // 100us blocking jobs, the workers must run the jobs concurrently
+    bench_workqueue_run(opts, out, "multi_blocking", opts.ops / 100, 0, 100000);
+    // bursts of 64 items, per item queue() vs queue_bulk()
+    bench_workqueue_burst(opts, out, "multi_burst_item", false);
+    bench_workqueue_burst(opts, out, "multi_burst_bulk", true);
+    // bursts of blocking jobs, fixed pool vs elastic pool (1 to n workers)
+    bench_workqueue_elastic(opts, out, "multi_fixed_burst", false);
+    bench_workqueue_elastic(opts, out, "multi_elastic_burst", true);
+    // empty jobs, new / delete for each item vs the item pool
+    bench_workqueue_alloc(opts, out, "multi_new_item", false);
+    bench_workqueue_alloc(opts, out, "multi_pool_fn", true);
+}
+
+MN_BENCH_REGISTER(workqueue, bench_workqueue_multi)
@@ -0,0 +1,103 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_graph.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A graph node item, empty or a blocking job (i.e. I/O)
+     */
+    class graph_item : public queue::work_queue_item_t {
+    public:
+        graph_item() : queue::work_queue_item_t(false), sleep_ns(0) { }
+
+        virtual bool on_work() override {
+            if(sleep_ns != 0) {
+                struct timespec ts = { 0, (long)sleep_ns };
+                nanosleep(&ts, NULL);
+            }
+            return true;
+        }
+        uint64_t sleep_ns;
+    };
+}
+
+/**
+ * Run a graph again and again on a multi engine with n workers. The ops are
+ * the run nodes, the latency is the time of one graph run
+ *
+ * @param fanout false: a chain of nodes, true: one root, the nodes parallel
+ * and one join node
+ */
+static void bench_graph_run(const options& opts, reporter& out, const char* strName,
+                            uint32_t nodes, bool fanout, uint64_t sleep_ns, uint64_t runs) {
+    for(int n : opts.thread_counts()) {
+        std::vector<graph_item> _items(nodes);
+        for(auto& it : _items) it.sleep_ns = sleep_ns;
+
+        queue::basic_work_graph _graph;
+        std::vector<queue::work_graph_node*> _nodes;
+        for(auto& it : _items) _nodes.push_back(_graph.add(&it));
+
+        for(uint32_t i = 1; i < nodes; i++) {
+            if(!fanout)
+                _nodes[i]->succeed(_nodes[i - 1]);
+            else if(i == nodes - 1)
+                for(uint32_t j = 1; j < nodes - 1; j++) _nodes[i]->succeed(_nodes[j]);
+            else
+                _nodes[i]->succeed(_nodes[0]);
+        }
+
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, (uint8_t)n);
+        _queue.create();
+
+        latency_recorder _rec(runs);
+        uint64_t _start = now_ns();
+
+        for(uint64_t r = 0; r < runs; r++) {
+            uint64_t _begin = now_ns();
+            _graph.run(_queue);
+            _rec.add(now_ns() - _begin);
+        }
+
+        result _res("workqueue_graph", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = runs * nodes;
+
+        _queue.destroy();
+
+        _res.set_latency(_rec);
+        out.report(_res);
+    }
+}
+
+static void bench_workqueue_graph(const options& opts, reporter& out) {
+    uint64_t _runs = opts.ops / 64;
+
+    // empty nodes, the per node overhead - a chain runs without queueing
+    bench_graph_run(opts, out, "chain_64", 64, false, 0, _runs);
+    bench_graph_run(opts, out, "fanout_64", 64, true, 0, _runs);
+    // 100us blocking nodes, the parallel branches run on all workers
+    bench_graph_run(opts, out, "fanout_blocking_16", 16, true, 100000, _runs / 100);
+}
+
+MN_BENCH_REGISTER(workqueue_graph, bench_workqueue_graph)
@@ -0,0 +1,99 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_prio.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A preallocated work item, the low priority items spin 5us (bulk logging),
+     * the high priority items are empty (control loop)
+     */
+    class prio_item : public queue::work_queue_item_t {
+    public:
+        prio_item() : queue::work_queue_item_t(false), enqueued(0), done(0), counter(NULL) { }
+
+        virtual bool on_work() override {
+            if(get_priority() == 0) {
+                uint64_t _end = now_ns() + 5000;
+                while(now_ns() < _end) { }
+            }
+            done = now_ns();
+            (*counter)++;
+            return true;
+        }
+
+        uint64_t enqueued;
+        uint64_t done;
+        atomic_uint64_t* counter;
+    };
+}
+
+/**
+ * One producer floods low priority items, each 16th item is high priority, 
+ * one worker - the latency is the queue to done time of the high priority items
+ */
+template <class TQUEUE>
+static void bench_prio_flood(const options& opts, reporter& out, const char* strName, TQUEUE& wq) {
+    uint64_t _ops = opts.ops / 20;
+    atomic_uint64_t _done(0);
+
+    std::vector<prio_item> _items(_ops);
+    for(uint64_t i = 0; i < _ops; i++) {
+        _items[i].counter = &_done;
+        _items[i].set_priority( (i % 16 == 0) ? 3 : 0 );
+    }
+    wq.create();
+
+    uint64_t _start = now_ns();
+
+    for(auto& it : _items) {
+        it.enqueued = now_ns();
+        wq.queue(&it, portMAX_DELAY);
+    }
+    while(_done.load() < _ops) vTaskDelay(1);
+
+    result _res("workqueue_prio", strName, 1, 1);
+    _res.elapsed_ns = now_ns() - _start;
+    _res.ops = _ops;
+
+    wq.destroy();
+
+    latency_recorder _rec(_ops / 16 + 1);
+    for(auto& it : _items) 
+        if(it.get_priority() != 0) _rec.add(it.done - it.enqueued);
+    _res.set_latency(_rec);
+    out.report(_res);
+}
+
+static void bench_workqueue_prio(const options& opts, reporter& out) {
+    {
+        // fifo: the high priority items wait behind the flood
+        queue::basic_work_queue_multi _fifo(basic_task::PriorityNormal, 4096, 64, 1);
+        bench_prio_flood(opts, out, "flood_fifo_high", _fifo);
+    }
+    {
+        queue::basic_work_queue_prio _prio(basic_task::PriorityNormal, 4096, 64, 4, 1, 0);
+        bench_prio_flood(opts, out, "flood_prio_high", _prio);
+    }
+}
+
+MN_BENCH_REGISTER(workqueue_prio, bench_workqueue_prio)
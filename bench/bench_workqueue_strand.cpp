@@ -0,0 +1,108 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_single.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_strand.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A device job, a blocking access (i.e. a I2C transfer)
+     */
+    class device_item : public queue::work_queue_item_t {
+    public:
+        device_item() : queue::work_queue_item_t(false), enqueued(0), done(0), counter(NULL) { }
+
+        virtual bool on_work() override {
+            struct timespec ts = { 0, 50000 };
+            nanosleep(&ts, NULL);
+
+            done = now_ns();
+            (*counter)++;
+            return true;
+        }
+        uint64_t enqueued;
+        uint64_t done;
+        atomic_uint64_t* counter;
+    };
+}
+
+/**
+ * 12 devices, each with serial jobs: a single engine for each device (12 tasks)
+ * or 12 strands on one multi engine with n workers. The latency is the time 
+ * from the post to the end of the job
+ */
+static void bench_strand_devices(const options& opts, reporter& out, const char* strName, bool strands) {
+    const uint32_t _devices = 12;
+    const uint64_t _ops = (opts.ops / 200 / _devices) * _devices;
+
+    for(int n : opts.thread_counts()) {
+        atomic_uint64_t _done(0);
+        std::vector<device_item> _items(_ops);
+        for(auto& it : _items) it.counter = &_done;
+
+        std::vector<queue::basic_work_queue_single*> _singles;
+        queue::basic_work_queue_multi _pool(basic_task::PriorityNormal, 4096, 64, (uint8_t)n);
+        queue::basic_work_strand_set _set(_pool, _devices);
+
+        if(strands) {
+            _pool.create();
+        } else {
+            for(uint32_t d = 0; d < _devices; d++) {
+                _singles.push_back(new queue::basic_work_queue_single(basic_task::PriorityNormal, 4096, 64));
+                _singles.back()->create();
+            }
+        }
+
+        uint64_t _start = now_ns();
+
+        for(uint64_t i = 0; i < _ops; i++) {
+            uint32_t _dev = (uint32_t)(i % _devices);
+            _items[i].enqueued = now_ns();
+
+            if(strands) _set.post(_dev, &_items[i], portMAX_DELAY);
+            else _singles[_dev]->queue(&_items[i], portMAX_DELAY);
+        }
+        while(_done.load() < _ops) vTaskDelay(1);
+
+        result _res("workqueue_strand", strName, 1, strands ? n : (int)_devices);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _ops;
+
+        if(strands) _pool.destroy();
+        for(auto* q : _singles) { q->destroy(); delete q; }
+
+        latency_recorder _rec(_ops);
+        for(auto& it : _items) _rec.add(it.done - it.enqueued);
+        _res.set_latency(_rec);
+        out.report(_res);
+
+        // the singles are independent of n
+        if(!strands) break;
+    }
+}
+
+static void bench_workqueue_strand(const options& opts, reporter& out) {
+    bench_strand_devices(opts, out, "devices_single_12", false);
+    bench_strand_devices(opts, out, "devices_strand_12", true);
+}
+
+MN_BENCH_REGISTER(workqueue_strand, bench_workqueue_strand)
@@ -0,0 +1,94 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_steal.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A preallocated delayed item, records the time of the run
+     */
+    class timer_item : public queue::work_queue_item_t {
+    public:
+        timer_item() : queue::work_queue_item_t(false), due(0), done(0), counter(NULL) { }
+
+        virtual bool on_work() override {
+            done = now_ns();
+            (*counter)++;
+            return true;
+        }
+
+        uint64_t due;
+        uint64_t done;
+        atomic_uint64_t* counter;
+    };
+}
+
+/**
+ * Many delayed items with delays from 1 to 64 ticks in one workqueue - the
+ * latency is the lateness of the run after the due time
+ */
+template <class TQUEUE>
+static void bench_timer_after(const options& opts, reporter& out, const char* strName, TQUEUE& wq) {
+    uint64_t _ops = opts.ops / 50;
+    atomic_uint64_t _done(0);
+    const uint64_t _tickNs = 1000000ULL * portTICK_PERIOD_MS;
+
+    std::vector<timer_item> _items(_ops);
+    wq.create();
+
+    uint64_t _start = now_ns();
+
+    for(uint64_t i = 0; i < _ops; i++) {
+        unsigned int _delay = (unsigned int)(i % 64) + 1;
+
+        _items[i].counter = &_done;
+        _items[i].due = now_ns() + _delay * _tickNs;
+        wq.queue_after(&_items[i], _delay);
+    }
+    while(_done.load() < _ops) vTaskDelay(1);
+
+    result _res("workqueue_timer", strName, 1, wq.get_num_worker());
+    _res.elapsed_ns = now_ns() - _start;
+    _res.ops = _ops;
+
+    wq.destroy();
+
+    // the tick is the resolution, a item can run up to one tick early
+    latency_recorder _rec(_ops);
+    for(auto& it : _items)
+        _rec.add( (it.done + _tickNs > it.due) ? (it.done + _tickNs - it.due) : 0 );
+    _res.set_latency(_rec);
+    out.report(_res);
+}
+
+static void bench_workqueue_timer(const options& opts, reporter& out) {
+    {
+        queue::basic_work_queue_multi _multi(basic_task::PriorityNormal, 4096, 64, 2);
+        bench_timer_after(opts, out, "after_multi", _multi);
+    }
+    {
+        queue::basic_work_queue_steal _steal(basic_task::PriorityNormal, 4096, 64, 2);
+        bench_timer_after(opts, out, "after_steal", _steal);
+    }
+}
+
+MN_BENCH_REGISTER(workqueue_timer, bench_workqueue_timer)
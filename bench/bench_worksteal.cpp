@@ -0,0 +1,87 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+#include "queue/mn_workqueue_steal.hpp"
+
+using namespace mn;
+using namespace mn::bench;
+
+namespace {
+    /**
+     * A recursive item, spawn two childs from on_work until the depth is 0,
+     * the leafs sleep sleep_ns (blocking job) 
+     */
+    class tree_item : public queue::work_queue_item_t {
+    public:
+        tree_item(queue::basic_work_queue_steal* wq, int depth, uint64_t sleep_ns) 
+            : queue::work_queue_item_t(true), m_wq(wq), m_depth(depth), m_sleep(sleep_ns) { }
+
+        virtual bool on_work() override {
+            if(m_depth == 0) {
+                if(m_sleep != 0) {
+                    struct timespec ts = { 0, (long)m_sleep };
+                    nanosleep(&ts, NULL);
+                }
+                return true;
+            }
+            m_wq->queue(new tree_item(m_wq, m_depth - 1, m_sleep), portMAX_DELAY);
+            m_wq->queue(new tree_item(m_wq, m_depth - 1, m_sleep), portMAX_DELAY);
+            return true;
+        }
+    private:
+        queue::basic_work_queue_steal* m_wq;
+        int m_depth;
+        uint64_t m_sleep;
+    };
+}
+
+/**
+ * Queue one root item, the workers spawn a binary tree of items into the 
+ * own deques and the idle workers steal, ops are all items of the tree
+ */
+static void bench_worksteal_tree(const options& opts, reporter& out, const char* strName, 
+                                 uint64_t leafs, uint64_t sleep_ns) {
+    int _depth = 0;
+    while( (2ULL << _depth) <= leafs ) _depth++;
+
+    for(int n : opts.thread_counts()) {
+        queue::basic_work_queue_steal _queue(basic_task::PriorityNormal, 4096, 16, (uint8_t)n);
+        _queue.create();
+
+        uint64_t _start = now_ns();
+
+        _queue.queue(new tree_item(&_queue, _depth, sleep_ns), portMAX_DELAY);
+        while(!_queue.is_ready()) vTaskDelay(1);
+
+        result _res("worksteal", strName, 1, n);
+        _res.elapsed_ns = now_ns() - _start;
+        _res.ops = _queue.get_num_items_worked();
+
+        _queue.destroy();
+        out.report(_res);
+    }
+}
+
+static void bench_worksteal(const options& opts, reporter& out) {
+    // empty items, the spawn and steal overhead
+    bench_worksteal_tree(opts, out, "tree", opts.ops / 4, 0);
+    // 100us blocking leafs, the scaling with the worker count
+    bench_worksteal_tree(opts, out, "tree_blocking", opts.ops / 100, 100000);
+}
+
+MN_BENCH_REGISTER(worksteal, bench_worksteal)
@@ -0,0 +1,189 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_bench.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+namespace mn {
+    namespace bench {
+        //-----------------------------------
+        //  latency_recorder::percentile
+        //-----------------------------------
+        uint64_t latency_recorder::percentile(double p) {
+            if(m_vSamples.empty()) return 0;
+
+            if(!m_bSorted) {
+                std::sort(m_vSamples.begin(), m_vSamples.end());
+                m_bSorted = true;
+            }
+            size_t _idx = (size_t)(p * (double)(m_vSamples.size() - 1) + 0.5);
+            return m_vSamples[_idx];
+        }
+
+        //-----------------------------------
+        //  result
+        //-----------------------------------
+        void result::set_latency(latency_recorder& rec) {
+            p50_ns = rec.percentile(0.50);
+            p99_ns = rec.percentile(0.99);
+            p999_ns = rec.percentile(0.999);
+        }
+
+        double result::ops_per_sec() const {
+            return (elapsed_ns == 0) ? 0.0 : (double)ops * 1e9 / (double)elapsed_ns;
+        }
+
+        //-----------------------------------
+        //  options::thread_counts
+        //-----------------------------------
+        std::vector<int> options::thread_counts() const {
+            std::vector<int> _ret;
+
+            for(int i = 1; i < max_threads; i *= 2) _ret.push_back(i);
+            _ret.push_back(max_threads);
+
+            return _ret;
+        }
+
+        //-----------------------------------
+        //  options::selected
+        //-----------------------------------
+        bool options::selected(const char* strName) const {
+            std::string _list = "," + filter + ",";
+            std::string _name = std::string(",") + strName + ",";
+
+            return _list.find(_name) != std::string::npos;
+        }
+
+        //-----------------------------------
+        //  reporter::report
+        //-----------------------------------
+        void reporter::report(const result& res) {
+            if(m_format == format::csv) {
+                if(!m_bHeader) {
+                    printf("suite,bench,producers,consumers,ops,seconds,ops_per_sec,p50_ns,p99_ns,p999_ns\n");
+                    m_bHeader = true;
+                }
+                printf("%s,%s,%d,%d,%llu,%.6f,%.1f,%llu,%llu,%llu\n",
+                    res.suite.c_str(), res.name.c_str(), res.producers, res.consumers,
+                    (unsigned long long)res.ops, (double)res.elapsed_ns / 1e9, res.ops_per_sec(),
+                    (unsigned long long)res.p50_ns, (unsigned long long)res.p99_ns,
+                    (unsigned long long)res.p999_ns);
+            } else {
+                printf("{\"suite\":\"%s\",\"bench\":\"%s\",\"producers\":%d,\"consumers\":%d,"
+                       "\"ops\":%llu,\"seconds\":%.6f,\"ops_per_sec\":%.1f,"
+                       "\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu}\n",
+                    res.suite.c_str(), res.name.c_str(), res.producers, res.consumers,
+                    (unsigned long long)res.ops, (double)res.elapsed_ns / 1e9, res.ops_per_sec(),
+                    (unsigned long long)res.p50_ns, (unsigned long long)res.p99_ns,
+                    (unsigned long long)res.p999_ns);
+            }
+            fflush(stdout);
+        }
+
+        //-----------------------------------
+        //  task_group
+        //-----------------------------------
+        task_group::~task_group() {
+            for(auto it = m_vTasks.begin(); it != m_vTasks.end(); it++)
+                delete *it;
+        }
+
+        void task_group::add(const char* strName, std::function<void()> fn) {
+            m_vTasks.push_back(new bench_task(strName, fn));
+        }
+
+        void task_group::wait_for_start() {
+            m_startEvent.wait(1, false, true, portMAX_DELAY);
+        }
+
+        uint64_t task_group::run() {
+            for(auto it = m_vTasks.begin(); it != m_vTasks.end(); it++)
+                (*it)->start();
+
+            uint64_t _start = now_ns();
+            m_startEvent.set(1);
+
+            for(auto it = m_vTasks.begin(); it != m_vTasks.end(); it++)
+                (*it)->join();
+
+            return now_ns() - _start;
+        }
+
+        //-----------------------------------
+        //  registrar
+        //-----------------------------------
+        std::vector<suite_entry>& suites() {
+            static std::vector<suite_entry> _suites;
+            return _suites;
+        }
+
+        registrar::registrar(const char* strName, bench_fn fn) {
+            suites().push_back( suite_entry{ strName, fn } );
+        }
+    }
+}
+
+static void usage(const char* name) {
+    printf("usage: %s [options]\n"
+           "  --ops=N        operations per run (default 200000)\n"
+           "  --threads=N    max producers / consumers / workers (default 4)\n"
+           "  --filter=A,B   run only the named suites\n"
+           "  --format=F     json (json lines, default) or csv\n"
+           "  --list         list all suites\n", name);
+}
+
+int main(int argc, char** argv) {
+    mn::bench::options _opts;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if(strncmp(arg, "--ops=", 6) == 0) {
+            _opts.ops = strtoull(arg + 6, NULL, 10);
+        } else if(strncmp(arg, "--threads=", 10) == 0) {
+            _opts.max_threads = atoi(arg + 10);
+        } else if(strncmp(arg, "--filter=", 9) == 0) {
+            _opts.filter = arg + 9;
+        } else if(strcmp(arg, "--format=csv") == 0) {
+            _opts.output = mn::bench::format::csv;
+        } else if(strcmp(arg, "--format=json") == 0) {
+            _opts.output = mn::bench::format::json;
+        } else if(strcmp(arg, "--list") == 0) {
+            for(auto& s : mn::bench::suites()) printf("%s\n", s.name);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return (strcmp(arg, "--help") == 0) ? 0 : 1;
+        }
+    }
+    if(_opts.max_threads < 1) _opts.max_threads = 1;
+    if(_opts.ops < 1000) _opts.ops = 1000;
+
+    mn::bench::reporter _out(_opts.output);
+
+    for(auto& s : mn::bench::suites()) {
+        if(!_opts.filter.empty() && !_opts.selected(s.name))
+            continue;
+        s.fn(_opts, _out);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef _MINLIB_BENCH_H_
+#define _MINLIB_BENCH_H_
+
+// the std headers first, mn_iterator.hpp defines a for_each macro
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "miniThread.hpp"
+
+namespace mn {
+    namespace bench {
+        /**
+         * @return The monotonic time in nano seconds
+         */
+        inline uint64_t now_ns() {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+        }
+
+        /**
+         * Collect latency samples in nano seconds and calculate the percentiles
+         */
+        class latency_recorder {
+        public:
+            latency_recorder(size_t reserve = 0) { m_vSamples.reserve(reserve); }
+
+            void add(uint64_t ns) {
+                m_vSamples.push_back( (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns );
+            }
+            void merge(const latency_recorder& other) {
+                m_vSamples.insert(m_vSamples.end(), other.m_vSamples.begin(), other.m_vSamples.end());
+            }
+            size_t size() const { return m_vSamples.size(); }
+
+            /**
+             * Get the percentile, sort the samples on the first call
+             * @param p The percentile 0.0 - 1.0
+             */
+            uint64_t percentile(double p);
+        private:
+            std::vector<uint32_t> m_vSamples;
+            bool m_bSorted = false;
+        };
+
+        /**
+         * The result of one benchmark run
+         */
+        struct result {
+            std::string suite;
+            std::string name;
+            int producers;
+            int consumers;
+            uint64_t ops;
+            uint64_t elapsed_ns;
+            uint64_t p50_ns;
+            uint64_t p99_ns;
+            uint64_t p999_ns;
+
+            result(const char* strSuite, const char* strName, int iProducers, int iConsumers)
+                : suite(strSuite), name(strName), producers(iProducers), consumers(iConsumers),
+                  ops(0), elapsed_ns(0), p50_ns(0), p99_ns(0), p999_ns(0) { }
+
+            /** Set the percentiles from the recorder */
+            void set_latency(latency_recorder& rec);
+            double ops_per_sec() const;
+        };
+
+        enum class format { json, csv };
+
+        /**
+         * The options from the command line
+         */
+        struct options {
+            uint64_t ops = 200000;          ///< operations per run, expensive suites use less
+            int max_threads = 4;            ///< the max producers / consumers / workers
+            std::string filter;             ///< comma separated list of suites to run, empty for all
+            format output = format::json;
+
+            /**
+             * @return The thread counts for the runs 1, 2, 4 ... max_threads
+             */
+            std::vector<int> thread_counts() const;
+            /**
+             * @return True when the suite is in the filter list
+             */
+            bool selected(const char* strName) const;
+        };
+
+        /**
+         * Print the results as json lines or csv
+         */
+        class reporter {
+        public:
+            reporter(format f) : m_format(f), m_bHeader(false) { }
+            void report(const result& res);
+        private:
+            format m_format;
+            bool m_bHeader;
+        };
+
+        /**
+         * A task that run a callable, used for the producers and consumers
+         */
+        class bench_task : public basic_task {
+        public:
+            bench_task(const char* strName, std::function<void()> fn)
+                : basic_task(strName, basic_task::PriorityNormal, 4096), m_fn(fn) { }
+
+            virtual void* on_task() override { m_fn(); return NULL; }
+        private:
+            std::function<void()> m_fn;
+        };
+
+        /**
+         * Start a group of tasks at the same time and wait for all
+         */
+        class task_group {
+        public:
+            ~task_group();
+
+            void add(const char* strName, std::function<void()> fn);
+            /**
+             * Start all tasks, release them together and join all
+             * @return The elapsed time in nano seconds from the release to the last join
+             */
+            uint64_t run();
+
+            /** Called from the tasks, wait for the release */
+            void wait_for_start();
+        private:
+            std::vector<bench_task*> m_vTasks;
+            event_group_t m_startEvent;
+        };
+
+        using bench_fn = void (*)(const options& opts, reporter& out);
+
+        /**
+         * Register a benchmark suite, use MN_BENCH_REGISTER
+         */
+        struct registrar {
+            registrar(const char* strName, bench_fn fn);
+        };
+
+        struct suite_entry {
+            const char* name;
+            bench_fn fn;
+        };
+        std::vector<suite_entry>& suites();
+    }
+}
+
+#define MN_BENCH_REGISTER(name, fn) \
+    static mn::bench::registrar __mn_bench_registrar_##name(#name, fn);
+
+#endif
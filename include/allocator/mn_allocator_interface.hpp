@@ -41,6 +41,8 @@ namespace mn {
             allocator_interface(size_t maxSize) 
                 : m_szeMaxSize(maxSize), m_szeAllocted(0) { }
 
+            virtual ~allocator_interface() { }
+
             /**
              * @brief Alloc a n size of bytes
              * 
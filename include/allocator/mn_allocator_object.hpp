@@ -19,6 +19,8 @@
 #ifndef _MINLIB_ALLOCATOR_OBJCT_H_
 #define _MINLIB_ALLOCATOR_OBJCT_H_
 
+#include <stddef.h>
+
       
 /**
  * @brief Defines when the class the mn::allocator to create the object, 
@@ -51,8 +53,8 @@ using allocator_type = AlloCator; \
 private: \
 static allocator_type m_acObject; \
 public:  \
-    void* operator new (unsigned int size) { return m_acObject.alloc(size ); }  \
-    void* operator new[] (unsigned int size) { return m_acObject.alloc(size ); }  \
+    void* operator new (::size_t size) { return m_acObject.alloc(size ); }  \
+    void* operator new[] (::size_t size) { return m_acObject.alloc(size ); }  \
     void  operator delete(void* pObject) { m_acObject.free(pObject); } \
     void  operator delete[] (void* pObject) { m_acObject.free(pObject); } \
     allocator_type get_allocator() { return m_acObject; } \
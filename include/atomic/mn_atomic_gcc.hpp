@@ -78,60 +78,68 @@ namespace mn {
 
         value_type get() { return __tValue; }
 
+        /**
+         * The failure order for compare exchange can not be a release order
+         */
+        static constexpr int failure_order(memory_order order) {
+            return (order == memory_order::AcqRel) ? int(memory_order::Acquire) :
+                   (order == memory_order::Release) ? int(memory_order::Relaxed) : int(order);
+        }
+
         void store (value_type v, memory_order order = memory_order::SeqCst)
-            { __atomic_store_n (&__tValue, v, order); }
+            { __atomic_store_n (&__tValue, v, int(order)); }
 
         value_type load (memory_order order = memory_order::SeqCst) const
-            { return __atomic_load_n (&__tValue, order); }
+            { return __atomic_load_n (&__tValue, int(order)); }
 
         value_type exchange (value_type v, memory_order order = memory_order::SeqCst)
-            { return __atomic_exchange_n (&__tValue, v, order); }
+            { return __atomic_exchange_n (&__tValue, v, int(order)); }
 
         bool compare_exchange_n (value_type& expected, value_type& desired, bool b, memory_order order = memory_order::SeqCst)
-            { return __atomic_compare_exchange_n (&__tValue, &expected, desired, b, order, order); }
+            { return __atomic_compare_exchange_n (&__tValue, &expected, desired, b, int(order), failure_order(order)); }
 
         bool compare_exchange_t (value_type& expected, value_type& desired, memory_order order = memory_order::SeqCst)
-            { return compare_exchange_n (&expected, desired, true, order); }
+            { return compare_exchange_n (expected, desired, true, order); }
 
         bool compare_exchange_f (value_type& expected, value_type& desired, memory_order order = memory_order::SeqCst)
-            { return compare_exchange_n (&expected, desired, false, order); }
+            { return compare_exchange_n (expected, desired, false, order); }
 
 
         bool compare_exchange_strong(value_type& expected, value_type& desired, memory_order order = memory_order::SeqCst)
-            { return _atomic_compare_exchange (&__tValue, &expected, &desired, 0, order, order); }
+            { return __atomic_compare_exchange_n (&__tValue, &expected, desired, false, int(order), failure_order(order)); }
 
         bool compare_exchange_weak(value_type& expected, value_type& desired, memory_order order = memory_order::SeqCst)
-            { return _atomic_compare_exchange (&__tValue, &expected, &desired, 1, order, order); }
+            { return __atomic_compare_exchange_n (&__tValue, &expected, desired, true, int(order), failure_order(order)); }
 
         value_type fetch_add (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_fetch_add (&__tValue, v, order); }
+            { return __atomic_fetch_add (&__tValue, v, int(order)); }
 
         value_type fetch_sub (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_fetch_sub (&__tValue, v, order); }
+            { return __atomic_fetch_sub (&__tValue, v, int(order)); }
 
         value_type fetch_and (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_fetch_and (&__tValue, v, order); }
+            { return __atomic_fetch_and (&__tValue, v, int(order)); }
 
         value_type fetch_or (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_fetch_or (&__tValue, v, order); }
+            { return __atomic_fetch_or (&__tValue, v, int(order)); }
 
         value_type fetch_xor (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_fetch_xor (&__tValue, v, order); }
+            { return __atomic_fetch_xor (&__tValue, v, int(order)); }
 
         value_type add_fetch (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_add_fetch (&__tValue, v, order); }
+            { return __atomic_add_fetch (&__tValue, v, int(order)); }
 
         value_type sub_fetch (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_sub_fetch (&__tValue, v, order); }
+            { return __atomic_sub_fetch (&__tValue, v, int(order)); }
 
         value_type and_fetch (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_and_fetch (&__tValue, v, order); }
+            { return __atomic_and_fetch (&__tValue, v, int(order)); }
 
         value_type or_fetch (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_or_fetch (&__tValue, v, order); }
+            { return __atomic_or_fetch (&__tValue, v, int(order)); }
 
         value_type xor_fetch (value_type v, memory_order order = memory_order::SeqCst )
-            { return __atomic_xor_fetch (&__tValue, v, order); }
+            { return __atomic_xor_fetch (&__tValue, v, int(order)); }
 
         bool is_lock_free() const
             { return __atomic_is_lock_free (sizeof(value_type), &__tValue); }
@@ -142,13 +150,13 @@ namespace mn {
         inline operator value_type() const	         { return load(); }
         inline operator value_type() const volatile  { return load(); }
 
-        inline value_type operator ++ (int)          { return add_fetch (1); }
-        inline value_type operator -- (int)          { return sub_fetch (1); }
+        inline value_type operator ++ (int)          { return fetch_add (1); }
+        inline value_type operator -- (int)          { return fetch_sub (1); }
         inline value_type operator ++ ()             { return add_fetch (1); }
         inline value_type operator -- ()             { return sub_fetch (1); }
 
-        inline value_type operator ++ (int) volatile { return add_fetch (1); }
-        inline value_type operator -- (int) volatile { return sub_fetch (1); }
+        inline value_type operator ++ (int) volatile { return fetch_add (1); }
+        inline value_type operator -- (int) volatile { return fetch_sub (1); }
         inline value_type operator ++ ()    volatile { return add_fetch (1); }
         inline value_type operator -- ()    volatile { return sub_fetch (1); }
 
@@ -164,6 +172,14 @@ namespace mn {
 
         volatile value_type __tValue;
     };
+
+    /**
+     * Memory synchronization ordering of non-atomic and relaxed atomic accesses
+     * @param order The memory order of this fence
+     */
+    inline void atomic_thread_fence(memory_order order) {
+        __atomic_thread_fence(int(order));
+    }
 }
 
 #endif
\ No newline at end of file
@@ -92,6 +92,7 @@ namespace mn {
             using value_type = T;
             using pointer = value_type*;
             using reference = value_type&;
+            using const_reference = const value_type&;
             using difference_type = ptrdiff_t;
 
             using iterator = pointer;
@@ -155,14 +156,14 @@ namespace mn {
             const pointer data() const              { return empty() ? 0 : m_begin; }
 
             reference front()                       { assert(!empty()); return *begin(); }
-            const reference cfront() const          { assert(!empty());  return *begin(); }
+            const_reference cfront() const          { assert(!empty());  return *begin(); }
             reference back()                        { assert(!empty()); return *(end() - 1);  }
-            const reference cback() const           { assert(!empty()); return *(end() - 1); }
+            const_reference cback() const           { assert(!empty()); return *(end() - 1); }
 
             reference at(size_type i)               { assert(i < size()); return m_begin[i]; }
-            const reference at(size_type i) const   { assert(i < size()); return m_begin[i]; }
+            const_reference at(size_type i) const   { assert(i < size()); return m_begin[i]; }
             
-            void push_back(const reference v) {
+            void push_back(const_reference v) {
                 if (m_end >= m_capacityEnd) grow(); 
                 mn::copy_construct(m_end++, v);
             }
@@ -192,7 +193,7 @@ namespace mn {
                 assert(invariant());
             }
 
-            void insert(size_type index, size_type n, const reference val) {
+            void insert(size_type index, size_type n, const_reference val) {
                 assert(invariant());
 
                 const size_type indexEnd = index + n;
@@ -230,13 +231,13 @@ namespace mn {
                 m_end += n; 
             }
 
-            void insert(iterator it, size_type n, const reference val) {
+            void insert(iterator it, size_type n, const_reference val) {
                 assert(validate_iterator(it));
                 assert(invariant());
                 insert(size_type(it - m_begin), n, val);
             }
 
-            iterator insert(iterator it, const reference val) {
+            iterator insert(iterator it, const_reference val) {
                 assert(validate_iterator(it));
                 assert(invariant());
 
@@ -328,7 +329,7 @@ namespace mn {
                 reallocate(newCapacity, size());
             }
 
-            size_type index_of(const reference item, size_type index = 0) const {
+            size_type index_of(const_reference item, size_type index = 0) const {
                 assert(index >= 0 && index < size());
                 size_type _pos = npos;
 
@@ -339,7 +340,7 @@ namespace mn {
                 }
                 return _pos;
             }
-            iterator find(const reference item) {
+            iterator find(const_reference item) {
                 iterator itEnd = end();
 
                 for (iterator it = begin(); it != itEnd; ++it)
@@ -356,7 +357,7 @@ namespace mn {
             }
 
             bool validate_iterator(const_iterator it) const {
-                return it >= begin() && it <= end();
+                return it >= cbegin() && it <= cend();
             }
 
             basic_vector& operator=(const basic_vector& rhs) {
@@ -367,7 +368,7 @@ namespace mn {
                 return at(i);
             }
 
-            const reference operator[](size_type i) const {
+            const_reference operator[](size_type i) const {
                 return at(i);
             }
         private:
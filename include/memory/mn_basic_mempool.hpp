@@ -107,6 +107,7 @@ namespace mn {
                 TickType_t xTicksRemaining = xTicksToWait;
 
                 pointer buffer = nullptr;
+                basic_task* task = basic_task::get_self();
 
                 for(auto it = m_vChunks.begin(); 
                     (it != m_vChunks.end() && (xTicksRemaining <= xTicksToWait) ); it++) {
@@ -115,8 +116,6 @@ namespace mn {
                     {
                         chunk_type* entry = *it;
 
-                        basic_task* task = basic_task::get_self();
-
                         if(task)
                             buffer = static_cast<pointer>( entry->construct(oFreedSelf, task->get_id() ) );
                         else 
@@ -151,19 +150,18 @@ namespace mn {
                 TickType_t xTicksRemaining = xTicksToWait;
                 bool _ret = false, _wasCurropted = false;
 
-                basic_task* task = NULL;
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
 
                 for(auto it = m_vChunks.begin(); 
                     (it != m_vChunks.end() ) && (xTicksRemaining <= xTicksToWait); it++) {
 
                     _MEMPOOL_CLASS_LOCK(m_mutex, xTicksRemaining);
-                    task = basic_task::get_self();
 
-                   
-                    if( (*it)->deconstruct(mem, task->get_id(), _wasCurropted) ) {
+                    if( (*it)->deconstruct(mem, taskID, _wasCurropted) ) {
                         if(wasCurropted) *wasCurropted = _wasCurropted;
-                        _MEMPOOL_CLASS_UNLOCK_BREAK(m_mutex);
                         _ret = true;
+                        _MEMPOOL_CLASS_UNLOCK_BREAK(m_mutex);
                     }
 
                     if (xTicksToWait != portMAX_DELAY) {
@@ -174,6 +172,71 @@ namespace mn {
                 return _ret;
             }
 
+            /**
+             * Allocate up to count chunks, that all tasks can free, under one lock
+             * @param[out] items The array for the allocated chunks 
+             * @param count The max number of chunks to allocate
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return The number of allocated chunks
+             */
+            virtual unsigned int allocate_bulk(pointer* items, unsigned int count, 
+                                               unsigned long xTicksToWait = portMAX_DELAY) {
+                basic_task* task = basic_task::get_self();
+                unsigned int _ret = 0;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return 0;
+
+                for(auto it = m_vChunks.begin(); (it != m_vChunks.end()) && (_ret < count); it++) {
+                    pointer buffer = static_cast<pointer>( (*it)->construct(false, (task) ? task->get_id() : 0 ) );
+                    if(buffer != nullptr) items[_ret++] = buffer;
+                }
+
+                m_mutex.unlock();
+                return _ret;
+            }
+
+            /**
+             * Free count chunks under one lock
+             * @param items The array with the chunks to free
+             * @param count The number of chunks in the array
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return The number of freed chunks
+             */
+            virtual unsigned int free_bulk(pointer* items, unsigned int count, 
+                                           unsigned long xTicksToWait = portMAX_DELAY) {
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
+                unsigned int _ret = 0;
+                bool _wasCurropted = false;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return 0;
+
+                for(unsigned int i = 0; i < count; i++) {
+                    for(auto it = m_vChunks.begin(); it != m_vChunks.end(); it++) {
+                        if( (*it)->deconstruct(items[i], taskID, _wasCurropted) ) { _ret++; break; }
+                    }
+                }
+
+                m_mutex.unlock();
+                return _ret;
+            }
+
+            /**
+             * Is the memory a used chunk of this pool, that all tasks can free?
+             * @param mem The pointer to check
+             */
+            virtual bool is_shared(pointer mem) {
+                lock_gurd_type lock(m_mutex);
+
+                for(auto it = m_vChunks.begin(); it != m_vChunks.end(); it++) {
+                    if((*it)->theBuffer == mem) 
+                        return ((*it)->state == vmempool_chunk_state::Used) && !(*it)->is_owner_free();
+                }
+                return false;
+            }
+
             /**
             * Return the number of chunks in the mempool
             * @return The number of chunks in the mempool
@@ -255,7 +318,7 @@ namespace mn {
             */ 
             vmempool_chunk_state get_state(const int id) {
                 lock_gurd_type lock(m_mutex);
-                return (id < size) ?  m_vChunks.at(id)->state : vmempool_chunk_state::NotHandle;
+                return (id < size()) ?  m_vChunks.at(id)->state : vmempool_chunk_state::NotHandle;
             }
 
             /**
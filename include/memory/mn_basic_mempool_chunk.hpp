@@ -39,14 +39,14 @@ namespace mn {
         class vmempool_chunk {
             MNALLOC_OBJECT(TALLOCATOR);
 
-            static const size_t XUnionSize = mn::value2size_raw<char[2]>::size +  
-                                             mn::value2size_raw<vmempool_chunk_state>::size +
+            static const size_t XUnionSize = size_t(mn::value2size_raw<char[2]>::size) +  
+                                             size_t(mn::value2size_raw<vmempool_chunk_state>::size) +
                                              TBufferSize;
         public:
             union {
                 struct {
                     void* theBuffer;
-                    char theMagicGuard[2];              /*!< The magic guard bytes for detect heap memory corruption */
+                    unsigned char theMagicGuard[2];     /*!< The magic guard bytes for detect heap memory corruption */
                     vmempool_chunk_state state;          /*!< The state for a memory chunk */
                     
                 };
@@ -88,6 +88,7 @@ namespace mn {
                 if(state == vmempool_chunk_state::Free) {
                     set_owner( taskID );
                     set_free( (oFreedSelf) ? VMEM_CHUNK_OWNER_FREE : VMEM_CHUNK_ALL_FREE );
+                    state = vmempool_chunk_state::Used;
 
                     _retBuffer = theBuffer;
                 }
@@ -120,6 +121,11 @@ namespace mn {
              */
             void set_free(bool t) { m_cfree = t ? 1 : 0; }
 
+            /**
+             * @brief Can only the owner task free this chunk?
+             */
+            bool is_owner_free() { return m_cfree == VMEM_CHUNK_OWNER_FREE; }
+
             bool is_corupted() {
                 return !(theMagicGuard[0] == MN_THREAD_CONFIG_MEMPOOL_MAGIC_START &&
                          theMagicGuard[1] == MN_THREAD_CONFIG_MEMPOOL_MAGIC_END);
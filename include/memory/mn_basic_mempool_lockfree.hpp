@@ -0,0 +1,253 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify  
+*it under the terms of the GNU Lesser General Public License as published by  
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but 
+*WITHOUT ANY WARRANTY; without even the implied warranty of 
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.  
+*/
+#ifndef _MINLIB_LOCKFREE_MEMPOOL_H_
+#define _MINLIB_LOCKFREE_MEMPOOL_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "../mn_error.hpp"
+#include "../atomic/mn_atomic_gcc.hpp"
+#include "../allocator/mn_allocator_interface.hpp"
+
+namespace mn {
+    namespace memory {
+        /**
+         * A lock free fixed size mempool for task and ISR context. The free blocks 
+         * are a Treiber stack, the head holds the block index and a tag 
+         * (generation) in one word, the tag is incremented on each change 
+         * so a ABA swap is detected from the compare exchange. 
+         * 
+         * The head is 64 bit with a 32 bit tag, when the target has a lock free 
+         * 64 bit compare exchange. Else (i.e. the ESP32) the head is 32 bit and the 
+         * tag gets all bits, that the index does not need: 16 bits with up to 65534 
+         * blocks, 24 bits with up to 254 blocks. A ABA swap is only missed, when a 
+         * task is preempted in allocate and the other tasks change the pool exactly 
+         * a multiple of 2^tagbits times, so keep nElements small on 32 bit targets.
+         * 
+         * Each block has a state, deallocate rejects double frees and foreign pointers.
+         * 
+         * The blocks are a member of the pool, no heap is used, so the pool can 
+         * be the allocator of MNALLOC_OBJECT types and containers. 
+         * 
+         * @note alloc returns NULL for sizes bigger then one block
+         * 
+         * @tparam TType The type of the elements, one block is sizeof(TType)
+         * @tparam nElements The number of blocks, max 65534 
+         */ 
+        template <typename TType, int nElements>
+        class basic_mempool_lockfree : public allocator_interface {
+            static_assert(nElements > 0 && nElements < 0xffff, "nElements must be 1 - 65534");
+
+            using head_type = typename std::conditional<__atomic_always_lock_free(sizeof(uint64_t), 0),
+                                                        uint64_t, uint32_t>::type;
+
+            /** the bits of the index, EmptyIndex must not be a block */
+            static constexpr int IndexBits = (sizeof(head_type) == sizeof(uint64_t)) ? 32 :
+                                             (nElements < 0xff) ? 8 : 16;
+            static constexpr int TagBits = (int)(sizeof(head_type) * 8) - IndexBits;
+
+            static constexpr head_type IndexMask = ((head_type)1 << IndexBits) - 1;
+            static constexpr head_type TagMask = ((head_type)1 << TagBits) - 1;
+            static constexpr uint16_t EmptyIndex = (uint16_t)(IndexMask > 0xffff ? 0xffff : IndexMask);
+
+            /** the state of a block */
+            enum : uint8_t { BlockFree = 0, BlockUsed = 1 };
+        public:
+            using value_type = TType;
+            using pointer = TType*;
+            using self_type = basic_mempool_lockfree<TType, nElements>;
+
+            basic_mempool_lockfree() 
+                : allocator_interface(), m_head(0), m_used(0) {
+                
+                for(int i = 0; i < nElements; i++) {
+                    m_next[i] = (i + 1 < nElements) ? (uint16_t)(i + 1) : (uint16_t)EmptyIndex;
+                    m_state[i] = BlockFree;
+                }
+            }
+            basic_mempool_lockfree(const basic_mempool_lockfree&) = delete;
+            basic_mempool_lockfree& operator=(const basic_mempool_lockfree&) = delete;
+
+            /**
+             * The blocks are members of the pool, nothing to create
+             * @return Always ERR_MEMPOOL_OK
+             */
+            int create(unsigned long xTicksToWait = 0) { (void)xTicksToWait; return ERR_MEMPOOL_OK; }
+
+            /**
+             * Pop a block from the free stack
+             * @return The block or NULL when the pool is empty
+             */
+            pointer allocate() {
+                head_type _old = m_head.load(memory_order::Acquire);
+                head_type _new;
+
+                do {
+                    uint16_t _index = index_of(_old);
+                    if(_index == EmptyIndex) return NULL;
+
+                    // a stale next is detected with the tag
+                    _new = make_head(tag_of(_old) + 1, m_next[_index]);
+                } while(!m_head.compare_exchange_weak(_old, _new, memory_order::AcqRel));
+
+                uint16_t _index = index_of(_old);
+                __atomic_store_n(&m_state[_index], (uint8_t)BlockUsed, __ATOMIC_RELEASE);
+
+                m_used.fetch_add(1, memory_order::Relaxed);
+                return reinterpret_cast<pointer>(m_blocks[_index]);
+            }
+
+            /**
+             * Push a block back to the free stack
+             * @param mem The block from allocate
+             * @return False when the pointer is not a block of this pool or the
+             * block is already free
+             */
+            bool deallocate(pointer mem) {
+                int _index = get_id(mem);
+                if(_index == -1) return false;
+
+                // only one of two frees of the same block wins
+                uint8_t _expected = BlockUsed;
+                if(!__atomic_compare_exchange_n(&m_state[_index], &_expected, (uint8_t)BlockFree, 
+                                                false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) 
+                    return false;
+
+                head_type _old = m_head.load(memory_order::Relaxed);
+                head_type _new;
+
+                do {
+                    m_next[_index] = index_of(_old);
+                    _new = make_head(tag_of(_old) + 1, (uint16_t)_index);
+                } while(!m_head.compare_exchange_weak(_old, _new, memory_order::AcqRel));
+
+                m_used.fetch_sub(1, memory_order::Relaxed);
+                return true;
+            }
+
+            /**
+             * allocator_interface: Get one block, when n fits in one block
+             */
+            void* alloc(size_t n, unsigned int xTime = __UINT32_MAX__) override {
+                (void)xTime;
+                return (n <= sizeof(TType)) ? allocate() : NULL;
+            }
+
+            /**
+             * allocator_interface: Get one zeroed block, when n * b fits in one block
+             * @return The size of the buffer or 0 on error 
+             */
+            size_t calloc(size_t n, size_t b, void** buf, unsigned int xTime = __UINT32_MAX__) override {
+                *buf = alloc(n * b, xTime);
+                if(*buf == NULL) return 0;
+
+                memset(*buf, 0, sizeof(TType));
+                return n * b;
+            }
+
+            /**
+             * allocator_interface: Free a block 
+             */
+            void free(void* mem, unsigned int xTime = __UINT32_MAX__) override {
+                (void)xTime;
+                deallocate(static_cast<pointer>(mem));
+            }
+
+            /**
+             * Get the block id from a pointer of this pool
+             * @return The id of the block or -1 when the pointer is not from this pool
+             */
+            int get_id(pointer mem) {
+                uintptr_t _addr = reinterpret_cast<uintptr_t>(mem);
+                uintptr_t _base = reinterpret_cast<uintptr_t>(&m_blocks[0][0]);
+
+                if(mem == NULL || _addr < _base) return -1;
+
+                uintptr_t _offset = _addr - _base;
+                if( (_offset % sizeof(m_blocks[0])) != 0 ) return -1;
+
+                uintptr_t _id = _offset / sizeof(m_blocks[0]);
+                return (_id < (uintptr_t)nElements) ? (int)_id : -1;
+            }
+
+            unsigned int size() { return nElements; }
+            unsigned int get_used() { return m_used.load(memory_order::Relaxed); }
+            unsigned int get_free() { return nElements - get_used(); }
+            bool is_empty() { return index_of(m_head.load(memory_order::Acquire)) == EmptyIndex; }
+        private:
+            static uint16_t index_of(head_type head) { return (uint16_t)(head & IndexMask); }
+            static head_type tag_of(head_type head) { return head >> IndexBits; }
+            static head_type make_head(head_type tag, uint16_t index) { 
+                return ((tag & TagMask) << IndexBits) | index; 
+            }
+        private:
+            alignas(TType) unsigned char m_blocks[nElements][sizeof(TType)];
+            volatile uint16_t m_next[nElements];
+            uint8_t m_state[nElements];
+
+            basic_atomic_gcc<head_type> m_head;
+            basic_atomic_gcc<uint32_t>  m_used;
+        };
+
+        /**
+         * A copyable allocator on one static basic_mempool_lockfree for each 
+         * TType and nElements, for MNALLOC_OBJECT types and containers. 
+         * The pool is created on the static initialization, so the allocator 
+         * can use from ISRs.
+         * 
+         * @code
+         * using packet_allocator_t = basic_allocator_lockfree<packet_data, 32>;
+         * 
+         * struct packet {
+         *      MNALLOC_OBJECT(packet_allocator_t);
+         * };
+         * MNALLOC_OBJECT_D0(packet);
+         * @endcode
+         */
+        template <typename TType, int nElements>
+        class basic_allocator_lockfree : public allocator_interface {
+        public:
+            using pool_type = basic_mempool_lockfree<TType, nElements>;
+
+            void* alloc(size_t n, unsigned int xTime = __UINT32_MAX__) override {
+                return m_pool.alloc(n, xTime);
+            }
+            size_t calloc(size_t n, size_t b, void** buf, unsigned int xTime = __UINT32_MAX__) override {
+                return m_pool.calloc(n, b, buf, xTime);
+            }
+            void free(void* mem, unsigned int xTime = __UINT32_MAX__) override {
+                m_pool.free(mem, xTime);
+            }
+
+            /**
+             * Get the pool behind this allocator
+             */
+            static pool_type& get_pool() { return m_pool; }
+        private:
+            static pool_type m_pool;
+        };
+
+        template <typename TType, int nElements>
+        typename basic_allocator_lockfree<TType, nElements>::pool_type 
+            basic_allocator_lockfree<TType, nElements>::m_pool;
+    }
+}
+
+#endif
@@ -0,0 +1,266 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify  
+*it under the terms of the GNU Lesser General Public License as published by  
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but 
+*WITHOUT ANY WARRANTY; without even the implied warranty of 
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.  
+*/
+#ifndef _MINLIB_MAGAZINE_MEMPOOL_H_
+#define _MINLIB_MAGAZINE_MEMPOOL_H_
+
+#include <stdint.h>
+
+#include "../mn_config.hpp"
+#include "../mn_task.hpp"
+#include "../atomic/mn_atomic_gcc.hpp"
+
+#include "mn_basic_mempool_slab.hpp"
+
+namespace mn {
+    namespace memory {
+        /**
+         * The statistics of a basic_mempool_magazine
+         */
+        struct mempool_magazine_stats {
+            uint32_t allocs;        ///< All allocate calls 
+            uint32_t alloc_hits;    ///< Allocations served from a magazine
+            uint32_t frees;         ///< All free calls
+            uint32_t free_hits;     ///< Frees put into a magazine
+            uint32_t refills;       ///< Batch allocations from the pool
+            uint32_t drains;        ///< Batch frees to the pool
+
+            /**
+             * @return The allocation hit rate 0.0 - 1.0
+             */
+            float hit_rate() const { 
+                return (allocs == 0) ? 0.0f : (float)alloc_hits / (float)allocs; 
+            }
+        };
+
+        /**
+         * A per task magazine cache in front of a mempool. Each task gets a small 
+         * private stack of chunks, allocate and free use only this stack and touch 
+         * the shared pool only to refill or drain the half magazine in one batch.
+         * 
+         * The magazines are owned by the pool object, a task claims a free magazine
+         * with the first allocate or free. When all magazines are claimed, 
+         * chunks with owner free (oFreedSelf) and calls from a ISR use the pool direct.
+         * 
+         * @note Chunks in a magazine are still used for the pool, get_used counts them. 
+         * A chunk freed into a magazine is not cleared and not checked for corruption. 
+         * The magazine of a basic_task is given back, when the task ends. The magazine
+         * of a killed task is not given back, a new task with the same handle inherits
+         * it. Tasks not created with basic_task must call flush() before they exit.
+         * 
+         * @tparam TPOOL The pool type, must have allocate_bulk, free_bulk and is_shared
+         * @tparam nMagazineSize The number of chunks per magazine
+         * @tparam nMagazines The number of magazines (tasks)
+         */
+        template <class TPOOL, 
+                  int nMagazineSize = MN_THREAD_CONFIG_MEMPOOL_MAGAZINE_SIZE, 
+                  int nMagazines = MN_THREAD_CONFIG_MEMPOOL_MAGAZINES>
+        class basic_mempool_magazine {
+            static_assert(nMagazineSize >= 2, "a magazine needs 2 or more chunks");
+        public:
+            using pool_type = TPOOL;
+            using value_type = typename pool_type::value_type;
+            using pointer = typename pool_type::pointer;
+            using self_type = basic_mempool_magazine<TPOOL, nMagazineSize, nMagazines>;
+
+            basic_mempool_magazine() { 
+                for(int i = 0; i < nMagazines; i++) {
+                    m_magazines[i].owner.store(NULL);
+                    m_magazines[i].count = 0;
+                    m_magazines[i].reset_stats();
+                }
+                m_exitHook.func = &on_task_exit;
+                m_exitHook.arg = this;
+                basic_task::add_exit_hook(&m_exitHook);
+            }
+            basic_mempool_magazine(const basic_mempool_magazine&) = delete;
+
+            virtual ~basic_mempool_magazine() { 
+                basic_task::remove_exit_hook(&m_exitHook);
+
+                for(int i = 0; i < nMagazines; i++) drain(m_magazines[i], m_magazines[i].count);
+            }
+
+            /**
+             * Create the pool
+             */
+            int create(unsigned long xTicksToWait) { return m_pool.create(xTicksToWait); }
+
+            /**
+             * Allocate a chunk from the magazine of the current task
+             * @param oFreedSelf When true then can only this task free the chunk, 
+             * this chunks are allocated direct from the pool
+             * @param xTicksToWait How long to wait for the pool
+             */
+            pointer allocate(bool oFreedSelf = false, unsigned long xTicksToWait = portMAX_DELAY) {
+                magazine* _mag = (oFreedSelf) ? NULL : get_magazine();
+
+                if(_mag == NULL) return m_pool.allocate(oFreedSelf, xTicksToWait);
+
+                _mag->allocs++;
+
+                if(_mag->count == 0) {
+                    _mag->count = m_pool.allocate_bulk(_mag->items, nMagazineSize / 2, xTicksToWait);
+                    _mag->refills++;
+
+                    if(_mag->count == 0) return NULL;
+                } else {
+                    _mag->alloc_hits++;
+                }
+                return _mag->items[--_mag->count];
+            }
+
+            /**
+             * Free a chunk into the magazine of the current task
+             * @param mem The pointer from allocate 
+             * @param[out] wasCurropted Only set from the pool, false for chunks 
+             * put in a magazine
+             * @param xTicksToWait How long to wait for the pool
+             * 
+             * @return True when the chunk was freed
+             */
+            bool free(pointer mem, bool* wasCurropted = NULL, unsigned long xTicksToWait = portMAX_DELAY) {
+                if(mem == NULL) return false;
+
+                magazine* _mag = get_magazine();
+
+                if(_mag == NULL || !m_pool.is_shared(mem)) 
+                    return m_pool.free(mem, wasCurropted, xTicksToWait);
+
+                _mag->frees++;
+
+                if(_mag->count == nMagazineSize) {
+                    drain(*_mag, nMagazineSize / 2, xTicksToWait);
+                    _mag->drains++;
+
+                    // the pool was locked to long, the magazine is still full
+                    if(_mag->count == nMagazineSize) 
+                        return m_pool.free(mem, wasCurropted, xTicksToWait);
+                } else {
+                    _mag->free_hits++;
+                }
+                if(wasCurropted) *wasCurropted = false;
+
+                _mag->items[_mag->count++] = mem;
+                return true;
+            }
+
+            /**
+             * Give all chunks of the current task magazine back to the pool and 
+             * release the magazine for other tasks
+             */
+            void flush(unsigned long xTicksToWait = portMAX_DELAY) {
+                release(xTaskGetCurrentTaskHandle(), xTicksToWait);
+            }
+
+            /**
+             * Get the statistics of all magazines
+             */
+            mempool_magazine_stats get_stats() {
+                mempool_magazine_stats _stats = { 0, 0, 0, 0, 0, 0 };
+
+                for(int i = 0; i < nMagazines; i++) {
+                    _stats.allocs += m_magazines[i].allocs;
+                    _stats.alloc_hits += m_magazines[i].alloc_hits;
+                    _stats.frees += m_magazines[i].frees;
+                    _stats.free_hits += m_magazines[i].free_hits;
+                    _stats.refills += m_magazines[i].refills;
+                    _stats.drains += m_magazines[i].drains;
+                }
+                return _stats;
+            }
+
+            /**
+             * Get the pool behind the magazines
+             */
+            pool_type& get_pool() { return m_pool; }
+
+            unsigned int size() { return m_pool.size(); }
+            unsigned int get_used() { return m_pool.get_used(); }
+            unsigned int get_free() { return m_pool.get_free(); }
+            unsigned int get_blocked() { return m_pool.get_blocked(); }
+
+            basic_mempool_magazine& operator=(const basic_mempool_magazine&) = delete;
+        private:
+            struct magazine {
+                basic_atomic_gcc<void*> owner;      ///< the task handle of the owner, NULL for free
+                pointer items[nMagazineSize];
+                int count;
+
+                // written only from the owner, read from get_stats
+                basic_atomic_gcc<uint32_t> allocs, alloc_hits, frees, free_hits, refills, drains;
+
+                void reset_stats() { allocs = alloc_hits = frees = free_hits = refills = drains = 0; }
+            };
+
+            /** drain the magazine of the given task and release it */
+            void release(void* handle, unsigned long xTicksToWait = portMAX_DELAY) {
+                magazine* _mag = find_magazine(handle);
+                if(_mag == NULL) return;
+
+                drain(*_mag, _mag->count, xTicksToWait);
+                if(_mag->count == 0) _mag->owner.store(NULL, memory_order::Release);
+            }
+
+            /** the exit hook of basic_task */
+            static void on_task_exit(void* arg, xTaskHandle handle) {
+                static_cast<self_type*>(arg)->release(handle);
+            }
+
+            magazine* find_magazine(void* handle) {
+                for(int i = 0; i < nMagazines; i++) {
+                    if(m_magazines[i].owner.load(memory_order::Acquire) == handle) 
+                        return &m_magazines[i];
+                }
+                return NULL;
+            }
+
+            /** get the magazine of the current task or claim a free one */
+            magazine* get_magazine() {
+                if(xPortInIsrContext()) return NULL;
+
+                void* _self = xTaskGetCurrentTaskHandle();
+                magazine* _mag = find_magazine(_self);
+
+                if(_mag != NULL) return _mag;
+
+                for(int i = 0; i < nMagazines; i++) {
+                    void* _expected = NULL;
+
+                    if(m_magazines[i].owner.compare_exchange_strong(_expected, _self)) 
+                        return &m_magazines[i];
+                }
+                return NULL;
+            }
+
+            /** free the top count chunks of the magazine to the pool */
+            void drain(magazine& mag, int count, unsigned long xTicksToWait = portMAX_DELAY) {
+                if(count <= 0) return;
+
+                // free_bulk fails only, when the lock is not taken
+                if(m_pool.free_bulk(&mag.items[mag.count - count], count, xTicksToWait) > 0) 
+                    mag.count -= count;
+            }
+        private:
+            pool_type m_pool;
+            magazine  m_magazines[nMagazines];
+            basic_task::exit_hook m_exitHook;
+        };
+    }
+}
+
+#endif
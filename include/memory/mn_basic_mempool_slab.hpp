@@ -0,0 +1,407 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify  
+*it under the terms of the GNU Lesser General Public License as published by  
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but 
+*WITHOUT ANY WARRANTY; without even the implied warranty of 
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.  
+*/
+#ifndef _MINLIB_SLAB_MEMPOOL_H_
+#define _MINLIB_SLAB_MEMPOOL_H_
+
+#include <string.h>
+#include <stdint.h>
+
+#include "../mn_autolock.hpp"
+#include "../mn_allocator.hpp"
+#include "../mn_task.hpp"
+#include "mn_basic_mempool_chunk.hpp"
+
+namespace mn {
+    namespace memory {
+        /**
+         * A chunk of the slab mempool, the buffer, the end guard and the header
+         * in one slot. The free chunks are linked intrusive with the chunk index.
+         */
+        template <typename TType>
+        struct slab_mempool_chunk {
+            alignas(TType) unsigned char theBuffer[sizeof(TType)];  /*!< The user memory, must be the first */
+            unsigned char theMagicGuard[2];                         /*!< The guard bytes behind the buffer for detect a overflow */
+            vmempool_chunk_state state;                             /*!< The state for the chunk */
+            uint8_t  m_cfree;                                       /*!< VMEM_CHUNK_OWNER_FREE or VMEM_CHUNK_ALL_FREE */
+            int32_t  m_ownerTask;                                   /*!< The id of the owner task */
+            int32_t  m_iNext;                                       /*!< The next free chunk, -1 for none */
+            int32_t  m_iPrev;                                       /*!< The prev free chunk, -1 for none */
+
+            void reset_guard() {
+                theMagicGuard[0] = MN_THREAD_CONFIG_MEMPOOL_MAGIC_START;
+                theMagicGuard[1] = MN_THREAD_CONFIG_MEMPOOL_MAGIC_END;
+            }
+            bool is_corupted() {
+                return !(theMagicGuard[0] == MN_THREAD_CONFIG_MEMPOOL_MAGIC_START &&
+                         theMagicGuard[1] == MN_THREAD_CONFIG_MEMPOOL_MAGIC_END);
+            }
+        };
+
+        /**
+         * A constant time mempool. All chunks are in one contiguous slab, the free 
+         * chunks are in a intrusive list and a pointer is mapped to the chunk by 
+         * address arithmetic, so allocate and free are O(1). 
+         * The used, free and blocked counts are hold incremental. 
+         * 
+         * The interface is the same as basic_mempool_vector, the owner task and 
+         * Blocked chunk semantics are the same, but the slab can not grow, 
+         * add_memory returns always false.
+         * 
+         * @tparam TType The type of the elements 
+         * @tparam nElements The number of the elements in the slab
+         * @tparam TMUTEX The lock type
+         * @tparam TALLOCATOR The allocator for the slab
+         */ 
+        template <typename TType, int nElements, typename TMUTEX = basic_mutex, class TALLOCATOR = default_allocator_t>
+        class basic_mempool_slab {
+        public:
+            using chunk_type = slab_mempool_chunk<TType>;
+            using chunk_reference = chunk_type&;
+            using chunk_pointer = chunk_type*;
+
+            using value_type = TType;
+            using pointer = TType*;
+
+            using allocator_type = TALLOCATOR;
+            using self_type = basic_mempool_slab<TType, nElements, TMUTEX, TALLOCATOR>;
+            using lock_type = TMUTEX;
+            using lock_gurd_type = basic_autolock<TMUTEX>;
+
+            basic_mempool_slab() 
+                : m_pSlab(NULL), m_iFreeHead(-1), m_uiUsed(0), m_uiBlocked(0) { }
+            basic_mempool_slab(const basic_mempool_slab&) = delete; ///< no copyable 
+
+            virtual ~basic_mempool_slab() {
+                if(m_pSlab) m_allocator.free(m_pSlab);
+            }
+
+            /**
+             * Create the slab and link all chunks in the free list
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return 
+             *  - ERR_MEMPOOL_OK The slab was created
+             *  - ERR_MEMPOOL_CREATE The slab can not be allocated or is created
+             */ 
+            virtual int create(unsigned long xTicksToWait) {
+                lock_gurd_type lock(m_mutex); 
+
+                if(m_pSlab != NULL) return ERR_MEMPOOL_CREATE;
+
+                m_pSlab = static_cast<chunk_pointer>( 
+                    m_allocator.alloc(sizeof(chunk_type) * nElements, xTicksToWait) );
+                if(m_pSlab == NULL) return ERR_MEMPOOL_CREATE;
+
+                for(int i = 0; i < nElements; i++) {
+                    chunk_type& _chunk = m_pSlab[i];
+
+                    memset(_chunk.theBuffer, 0, sizeof(TType));
+                    _chunk.reset_guard();
+                    _chunk.state = vmempool_chunk_state::Free;
+                    _chunk.m_cfree = VMEM_CHUNK_ALL_FREE;
+                    _chunk.m_ownerTask = 0;
+                    _chunk.m_iPrev = i - 1;
+                    _chunk.m_iNext = (i + 1 < nElements) ? i + 1 : -1;
+                }
+                m_iFreeHead = (nElements > 0) ? 0 : -1;
+                m_uiUsed = 0; m_uiBlocked = 0;
+
+                return ERR_MEMPOOL_OK;
+            }
+
+            /**
+             * The slab can not grow
+             * @return Always false
+             */ 
+            virtual bool add_memory(unsigned int elements) { (void)elements; return false; }
+
+            /**
+             * Allocate a chunk from the head of the free list
+             * @param oFreedSelf When true then can only the allocating task free the chunk
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return The pointer to the memory or NULL, when no free chunk 
+             */ 
+            virtual pointer allocate(bool oFreedSelf = false, unsigned long xTicksToWait = portMAX_DELAY) {
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return NULL;
+
+                if(m_iFreeHead == -1) { m_mutex.unlock(); return NULL; }
+
+                chunk_type& _chunk = m_pSlab[m_iFreeHead];
+                unlink(m_iFreeHead);
+
+                _chunk.state = vmempool_chunk_state::Used;
+                _chunk.m_ownerTask = (task) ? taskID : 0;
+                _chunk.m_cfree = (task && oFreedSelf) ? VMEM_CHUNK_OWNER_FREE : VMEM_CHUNK_ALL_FREE;
+                m_uiUsed++;
+
+                m_mutex.unlock();
+
+                return reinterpret_cast<pointer>(_chunk.theBuffer);
+            }
+
+            /**
+             * Free a chunk, the chunk is mapped from the address
+             * @param mem The pointer from allocate
+             * @param[out] wasCurropted When not NULL then is true when the guard behind 
+             * the buffer was overwritten
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return True when the chunk was freed, false when the pointer is not from 
+             * this pool, the chunk is not used or the current task is not the owner
+             */ 
+            virtual bool free(pointer mem, bool* wasCurropted = NULL, unsigned long xTicksToWait = portMAX_DELAY) {
+                int id = get_id(mem);
+                if(id == -1) return false;
+
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return false;
+
+                chunk_type& _chunk = m_pSlab[id];
+
+                if( (_chunk.state != vmempool_chunk_state::Used) ||
+                    (_chunk.m_cfree == VMEM_CHUNK_OWNER_FREE && _chunk.m_ownerTask != taskID) ) {
+                    m_mutex.unlock(); return false;
+                }
+                if(wasCurropted) *wasCurropted = _chunk.is_corupted();
+
+                // arrase the old informations
+                memset(_chunk.theBuffer, 0, sizeof(TType));
+                _chunk.reset_guard();
+                _chunk.state = vmempool_chunk_state::Free;
+                m_uiUsed--;
+
+                push_front(id);
+
+                m_mutex.unlock();
+                return true;
+            }
+
+            /**
+             * Allocate up to count chunks, that all tasks can free, under one lock
+             * @param[out] items The array for the allocated chunks 
+             * @param count The max number of chunks to allocate
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return The number of allocated chunks
+             */
+            virtual unsigned int allocate_bulk(pointer* items, unsigned int count, 
+                                               unsigned long xTicksToWait = portMAX_DELAY) {
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
+                unsigned int _ret = 0;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return 0;
+
+                while( (_ret < count) && (m_iFreeHead != -1) ) {
+                    chunk_type& _chunk = m_pSlab[m_iFreeHead];
+                    unlink(m_iFreeHead);
+
+                    _chunk.state = vmempool_chunk_state::Used;
+                    _chunk.m_ownerTask = taskID;
+                    _chunk.m_cfree = VMEM_CHUNK_ALL_FREE;
+
+                    items[_ret++] = reinterpret_cast<pointer>(_chunk.theBuffer);
+                }
+                m_uiUsed += _ret;
+
+                m_mutex.unlock();
+                return _ret;
+            }
+
+            /**
+             * Free count chunks under one lock
+             * @param items The array with the chunks to free
+             * @param count The number of chunks in the array
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return The number of freed chunks
+             */
+            virtual unsigned int free_bulk(pointer* items, unsigned int count, 
+                                           unsigned long xTicksToWait = portMAX_DELAY) {
+                basic_task* task = basic_task::get_self();
+                int taskID = (task) ? task->get_id() : 0;
+                unsigned int _ret = 0;
+
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return 0;
+
+                for(unsigned int i = 0; i < count; i++) {
+                    int id = get_id(items[i]);
+                    if(id == -1) continue;
+
+                    chunk_type& _chunk = m_pSlab[id];
+
+                    if( (_chunk.state != vmempool_chunk_state::Used) ||
+                        (_chunk.m_cfree == VMEM_CHUNK_OWNER_FREE && _chunk.m_ownerTask != taskID) ) 
+                        continue;
+
+                    memset(_chunk.theBuffer, 0, sizeof(TType));
+                    _chunk.reset_guard();
+                    _chunk.state = vmempool_chunk_state::Free;
+                    push_front(id);
+                    _ret++;
+                }
+                m_uiUsed -= _ret;
+
+                m_mutex.unlock();
+                return _ret;
+            }
+
+            /**
+             * Is the memory a used chunk of this pool, that all tasks can free?
+             * Without lock, the state of a used chunk is changed only from the user 
+             * @param mem The pointer to check
+             */
+            virtual bool is_shared(pointer mem) {
+                int id = get_id(mem);
+                if(id == -1) return false;
+
+                return (m_pSlab[id].state == vmempool_chunk_state::Used) && 
+                       (m_pSlab[id].m_cfree == VMEM_CHUNK_ALL_FREE);
+            }
+
+            /**
+             * Get the chunk id from a pointer of this pool
+             * @return The id of the chunk or -1 when the pointer is not from this pool
+             */
+            int get_id(pointer mem) {
+                if(mem == NULL || m_pSlab == NULL) return -1;
+
+                uintptr_t _addr = reinterpret_cast<uintptr_t>(mem);
+                uintptr_t _base = reinterpret_cast<uintptr_t>(m_pSlab);
+
+                if(_addr < _base) return -1;
+
+                uintptr_t _offset = _addr - _base;
+                if( (_offset % sizeof(chunk_type)) != 0 ) return -1;
+
+                uintptr_t _id = _offset / sizeof(chunk_type);
+                return (_id < (uintptr_t)nElements) ? (int)_id : -1;
+            }
+
+            unsigned int size() { return (m_pSlab) ? nElements : 0; }
+
+            unsigned int get_used() { 
+                lock_gurd_type lock(m_mutex); return m_uiUsed; }
+            unsigned int get_free() { 
+                lock_gurd_type lock(m_mutex); return size() - m_uiUsed - m_uiBlocked; }
+            unsigned int get_blocked() { 
+                lock_gurd_type lock(m_mutex); return m_uiBlocked; }
+
+            template<vmempool_chunk_state state> 
+            int get_num_of_state() {
+                switch(state) {
+                    case vmempool_chunk_state::Free: return get_free();
+                    case vmempool_chunk_state::Used: return get_used();
+                    case vmempool_chunk_state::Blocked: return get_blocked();
+                    default: return 0;
+                }
+            }
+
+            virtual bool is_empty() { 
+                lock_gurd_type lock(m_mutex); return m_iFreeHead == -1; }
+
+            /**
+             * Block or unblock a not used chunk, a blocked chunk can not be allocated
+             * @param id The id of the chunk
+             * @param blocked true for block, false for unblock
+             * @param xTicksToWait How long to wait to get the lock
+             * 
+             * @return True when the state of the chunk is now the wanted state
+             */
+            bool set_blocked(const int id, const bool blocked, unsigned long xTicksToWait = 512) {
+                if(id < 0 || id >= (int)size()) return false;
+                if(m_mutex.lock(xTicksToWait) != NO_ERROR) return false;
+
+                chunk_type& _chunk = m_pSlab[id];
+                bool _ret = (_chunk.state != vmempool_chunk_state::Used);
+
+                if(_ret && blocked && _chunk.state == vmempool_chunk_state::Free) {
+                    unlink(id);
+                    _chunk.state = vmempool_chunk_state::Blocked;
+                    m_uiBlocked++;
+                } else if(_ret && !blocked && _chunk.state == vmempool_chunk_state::Blocked) {
+                    _chunk.state = vmempool_chunk_state::Free;
+                    m_uiBlocked--;
+                    push_front(id);
+                }
+
+                m_mutex.unlock();
+                return _ret;
+            }
+
+            /**
+            * Get the state of the chunk
+            * @param[in] id The id of the chunk
+            * @return The state of the chunk
+            */ 
+            vmempool_chunk_state get_state(const int id) {
+                lock_gurd_type lock(m_mutex);
+                return (id >= 0 && id < (int)size()) ?  m_pSlab[id].state : vmempool_chunk_state::NotHandle;
+            }
+
+            /**
+            * Get the chunk from a given chunk id
+            * @param[in] id The id of the chunk
+            * 
+            * @return The chunk from a given chunk id
+            */ 
+            chunk_type* get_chunk(const int id) {
+                return (id >= 0 && id < (int)size()) ? &m_pSlab[id] : NULL;
+            }
+
+            basic_mempool_slab& operator=(const basic_mempool_slab&) = delete;
+        private:
+            /** remove the chunk from the free list, lock before */
+            void unlink(int id) {
+                chunk_type& _chunk = m_pSlab[id];
+
+                if(_chunk.m_iPrev != -1) m_pSlab[_chunk.m_iPrev].m_iNext = _chunk.m_iNext;
+                else m_iFreeHead = _chunk.m_iNext;
+
+                if(_chunk.m_iNext != -1) m_pSlab[_chunk.m_iNext].m_iPrev = _chunk.m_iPrev;
+
+                _chunk.m_iNext = _chunk.m_iPrev = -1;
+            }
+            /** add the chunk to the head of the free list, lock before */
+            void push_front(int id) {
+                chunk_type& _chunk = m_pSlab[id];
+
+                _chunk.m_iPrev = -1;
+                _chunk.m_iNext = m_iFreeHead;
+
+                if(m_iFreeHead != -1) m_pSlab[m_iFreeHead].m_iPrev = id;
+                m_iFreeHead = id;
+            }
+        private:
+            chunk_pointer  m_pSlab;
+            int32_t        m_iFreeHead;
+            unsigned int   m_uiUsed;
+            unsigned int   m_uiBlocked;
+            allocator_type m_allocator;
+            lock_type      m_mutex;
+        };
+    }
+}
+
+#endif
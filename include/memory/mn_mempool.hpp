@@ -25,6 +25,9 @@
 #include "../mn_allocator.hpp"
 
 #include "mn_basic_mempool.hpp"
+#include "mn_basic_mempool_slab.hpp"
+#include "mn_basic_mempool_magazine.hpp"
+#include "mn_basic_mempool_lockfree.hpp"
 
 namespace mn {
     namespace memory {
@@ -33,6 +36,10 @@ namespace mn {
         template <typename TType, int nElements>
         using basic_mempool_spiram_t = basic_mempool_vector<TType, nElements, 
             basic_mutex, basic_allocator_spiram  >;
+
+        template <typename TType, int nElements>
+        using basic_mempool_slab_spiram_t = basic_mempool_slab<TType, nElements, 
+            basic_mutex, basic_allocator_spiram  >;
     #endif
 
         template <typename TType, int nElements>
@@ -41,6 +48,18 @@ namespace mn {
         template <typename TType, int nElements>
         using basic_mempool_t = basic_mempool_system_t<TType, nElements>;
 
+        /**
+         * The constant time mempool, all chunks in one slab
+         */
+        template <typename TType, int nElements>
+        using basic_mempool_slab_t = basic_mempool_slab<TType, nElements>;
+
+        /**
+         * The slab mempool with a per task magazine cache in front
+         */
+        template <typename TType, int nElements>
+        using basic_mempool_magazine_t = basic_mempool_magazine< basic_mempool_slab<TType, nElements> >;
+
     }
 }
 
@@ -97,6 +97,14 @@
  */ 
 #define MN_THREAD_CONFIG_OTHER      1
 
+/** 
+ * @brief Pre defined values for config items -
+ * @note corrently use for MN_THREAD_CONFIG_BOARD 
+ * Set board type to a linux host, all FreeRTOS calls are mapped to pthreads 
+ * @see include/port/mn_port_posix.hpp
+ */ 
+#define MN_THREAD_CONFIG_LINUX      2
+
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
     #define MN_THREAD_CONFIG_STACK_DEPTH 8192
 #endif
@@ -104,6 +112,10 @@
 #ifndef MN_THREAD_CONFIG_BOARD    
     #define MN_THREAD_CONFIG_BOARD  MN_THREAD_CONFIG_BOARD_NODEFS
 #endif
+
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+    #include "port/mn_port_posix.hpp"
+#endif
 /** 
  * @brief Pre defined on which core must run the task, can override in the create 
  * function
@@ -113,7 +125,11 @@
  * @brief Pre defined on which core must run the work queue task, 
  * can override in the create function
  */ 
-#define MN_THREAD_CONFIG_DEFAULT_WORKQUEUE_CORE     MN_THREAD_CONFIG_CORE_TWO 
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+    #define MN_THREAD_CONFIG_DEFAULT_WORKQUEUE_CORE     MN_THREAD_CONFIG_CORE_IFNO 
+#else
+    #define MN_THREAD_CONFIG_DEFAULT_WORKQUEUE_CORE     MN_THREAD_CONFIG_CORE_TWO 
+#endif
 
 
 /** 
@@ -249,6 +265,64 @@
     #define MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT  512
 #endif
  
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_BATCH_SIZE
+    /**
+     * How many items queue_bulk links to one batch, a batch is one entry 
+     * in the work queue and is run from one worker per wakeup
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_BATCH_SIZE           8
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE
+    /**
+     * How many items has the item pool of each work queue, the items for 
+     * queue_fn and create_item - 0 for no item pool. The pool is allocated 
+     * on the first create_item, a queue without pooled items has no pool
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE            16
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_POOL_BLOCKSIZE
+    /**
+     * The size of one item in the item pool of the work queue in bytes, the 
+     * item with the callable (or the async item with the result) must fit 
+     * in one block
+     * @note default: 16 pointers, 64 bytes on the esp32
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_POOL_BLOCKSIZE       (16 * sizeof(void*))
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STATS
+    /**
+     * Record the queue wait time and the run time of each work item in 
+     * histograms, see basic_work_queue::get_wait_histogram
+     *'MN_THREAD_CONFIG_YES' or 'MN_THREAD_CONFIG_NO' 
+     * @note default: MN_THREAD_CONFIG_YES
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STATS                MN_THREAD_CONFIG_YES
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS
+    /**
+     * How many log2 buckets has a work queue histogram, bucket 0 counts the 
+     * times under 1us, bucket n the times from 2^(n-1) to 2^n us and the last
+     * bucket all longer times 
+     * @note default: 20 (the last bucket from 262ms)
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS         20
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STRAND_BATCH
+    /**
+     * How many items a strand runs in one go, then the strand is queued 
+     * again - so one busy strand does not hold a worker for ever
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STRAND_BATCH         8
+#endif
+
 #ifndef MN_THREAD_CONFIG_WORKQUEUE_SINGLE_MAXITEMS
     /**
      * How many work items to queue in the workqueue single-threaded default: 8
@@ -282,6 +356,41 @@
     #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER         4
 #endif
 
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_MULTI_MINWORKER
+    /**
+     * How many worker threads run at least in the workqueue multi-threaded, 
+     * less as MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER for a elastic worker pool
+     * @note default: MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER (fixed pool)
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_MINWORKER      MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_DEPTH
+    /**
+     * Elastic pool: a new worker is started, when this many items wait in the queue
+     * @note default: 2
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_DEPTH     2
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_WAIT
+    /**
+     * Elastic pool: a new worker is started, when a item waits longer as 
+     * this time in ms in the queue
+     * @note default: 5
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_WAIT      5
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_MULTI_IDLE_TIME
+    /**
+     * Elastic pool: a worker over the min workers ends, when it is idle 
+     * for this time in ms
+     * @note default: 2000
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_IDLE_TIME      2000
+#endif
+
 #ifndef MN_THREAD_CONFIG_WORKQUEUE_MULTI_MAXITEMS
     /**
      * How many work items to queue in the workqueue multi-threaded
@@ -306,6 +415,120 @@
     #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_PRIORITY      basic_task::PriorityLow
 #endif
 
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEAL_WORKER
+    /**
+     * How many worker threads run in the work stealing workqueue
+     * @note default: 2 - one for each esp32 core
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEAL_WORKER         2
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEAL_MAXITEMS
+    /**
+     * How many work items from not worker tasks to queue in the work stealing workqueue
+     * @note default: 16
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEAL_MAXITEMS       16
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEAL_DEQUE_SIZE
+    /**
+     * The size of the work stealing deque for each worker thread, must be a power of two
+     * @note default: 64
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEAL_DEQUE_SIZE     64
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEAL_STACKSIZE
+    /**
+     * Stak size for the work stealing workqueue for all worked thread 
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEAL_STACKSIZE      MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEAL_PRIORITY
+    /**
+     * @note default: Priority for the work stealing workqueue for all worked thread 
+     * @note default: basic_thread::PriorityLow
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEAL_PRIORITY       basic_task::PriorityLow
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_BANDS
+    /**
+     * How many priority bands has the priority workqueue
+     * @note default: 4
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_BANDS           4
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_MAXITEMS
+    /**
+     * How many work items to queue in each band of the priority workqueue
+     * @note default: 8
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_MAXITEMS        8
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_WORKER
+    /**
+     * How many worker threads run in the priority workqueue
+     * @note default: 1
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_WORKER          1
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_AGING
+    /**
+     * The aging time in ms for the priority workqueue, a item that waits longer
+     * is run befor the items of the higher bands - 0 for no aging
+     * @note default: 0
+     */ 
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_AGING           0
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_STACKSIZE
+    /**
+     * Stak size for the priority workqueue for all worked thread 
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_STACKSIZE       MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIO_PRIORITY
+    /**
+     * @note default: Priority for the priority workqueue for all worked thread 
+     * @note default: basic_thread::PriorityLow
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIO_PRIORITY        basic_task::PriorityLow
+#endif
+
+#ifndef MN_THREAD_CONFIG_PARALLEL_TASKS
+    /**
+     * How many tasks run a parallel algorithm (parallel_for, parallel_sort, ...), 
+     * the caller and the helper items in the workqueue 
+     * @note default: 2 (the two cores of the ESP32)
+     */ 
+    #define MN_THREAD_CONFIG_PARALLEL_TASKS                 2
+#endif
+
+#ifndef MN_THREAD_CONFIG_PARALLEL_MAX_TASKS
+    /**
+     * The max tasks of a parallel algorithm, the helper items are on the stack of the caller 
+     * @note default: 8
+     */ 
+    #define MN_THREAD_CONFIG_PARALLEL_MAX_TASKS             8
+#endif
+
+#ifndef MN_THREAD_CONFIG_PARALLEL_GRAINSIZE
+    /**
+     * The min number of elements in a chunk of a parallel algorithm
+     * @note default: 16
+     */ 
+    #define MN_THREAD_CONFIG_PARALLEL_GRAINSIZE             16
+#endif
+
 
 
 #ifndef MN_THREAD_CONFIG_TIMEOUT_SEMAPHORE_DEFAULT
@@ -358,7 +581,87 @@
      * Can override
      * @note default:  (unsigned int) 0xffffffffUL)   
      */ 
-    #define MN_THREAD_CONFIG_TIMEOUT_COROUTINE_DEFAULT  (unsigned int) 0xffffffffUL 
+    #define MN_THREAD_CONFIG_TIMEOUT_COROUTINE_DEFAULT  (unsigned int) 0xffffffffUL
+#endif
+
+#ifndef MN_THREAD_CONFIG_STATIC_TASK_NAME_LEN
+    /**
+     * The size of the inline name buffer of a basic_static_task, with the
+     * null terminator - like configMAX_TASK_NAME_LEN of FreeRTOS
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_STATIC_TASK_NAME_LEN        16
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASKPOOL_FN_SIZE
+    /**
+     * The size of the inline callable buffer of each task in a task pool in 
+     * bytes, the work item with the callable of run_fn must fit
+     * @note default: 16 pointers, 64 bytes on the esp32
+     */
+    #define MN_THREAD_CONFIG_TASKPOOL_FN_SIZE            (16 * sizeof(void*))
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASKPOOL_STACKSIZE
+    /**
+     * The default stack size of the tasks in a task pool
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_TASKPOOL_STACKSIZE          MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_SUPPORT
+    /**
+     * When MN_THREAD_CONFIG_YES then the C++20 coroutine executor and the
+     * awaitables (mn_coroutine.hpp) are available
+     *
+     * @note default: MN_THREAD_CONFIG_YES when the compiler has C++20 coroutines
+     */
+    #if defined(__cpp_impl_coroutine) && defined(__has_include)
+        #if __has_include(<coroutine>)
+            #define MN_THREAD_CONFIG_COROUTINE_SUPPORT      MN_THREAD_CONFIG_YES
+        #endif
+    #endif
+    #ifndef MN_THREAD_CONFIG_COROUTINE_SUPPORT
+        #define MN_THREAD_CONFIG_COROUTINE_SUPPORT          MN_THREAD_CONFIG_NO
+    #endif
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_POLL_TICKS
+    /**
+     * How long the coroutine executor sleeps at most, when a coroutine waits
+     * on a queue, lock or event group - the FreeRTOS objects wake not the
+     * executor, so the waiting coroutines are polled. The poll interval starts
+     * with 1 tick and is doubled up to this value, while no coroutine gets ready
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_POLL_TICKS        8
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_PRIORITY
+    /**
+     * The default priority of the coroutine executor task
+     * @note default: 1 (basic_task::PriorityLow)
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_PRIORITY          basic_task::PriorityLow
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_STACKSIZE
+    /**
+     * The default stack size of the coroutine executor task, the frames of
+     * the coroutines are on the heap
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_STACKSIZE         MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_PERIODIC_HIST_BUCKETS
+    /**
+     * The number of buckets of the jitter histogram of a basic_periodic_task,
+     * the buckets are powers of two micro seconds
+     * @note default: 16 - the last bucket counts 16ms and longer
+     */
+    #define MN_THREAD_CONFIG_PERIODIC_HIST_BUCKETS       16
 #endif
 
 
@@ -381,6 +684,26 @@
     #define MN_THREAD_CONFIG_RECURSIVE_MUTEX_CHEAKING     MN_THREAD_CONFIG_YES   
 #endif
 
+#ifndef MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX
+    /**
+     * The FreeRTOS thread local storage pointer index for basic_task::get_self.
+     * Index 0 is used from the esp-idf pthread component, so set
+     * CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS to 2 or more.
+     * When the index is not available then get_self returns always NULL and
+     * the build gives a warning. Define it as -1 to disable get_self.
+     */ 
+    #define MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX            1
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_SELF_TLS_REQUIRED
+    /**
+     * When set to MN_THREAD_CONFIG_YES then the build fails, when the
+     * thread local storage pointer index for basic_task::get_self is not
+     * available, instead of disable get_self.
+     */ 
+    #define MN_THREAD_CONFIG_TASK_SELF_TLS_REQUIRED         MN_THREAD_CONFIG_NO
+#endif
+
 #ifndef MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST
     /**
      * Add a Task automatic to basic_task_list?
@@ -388,6 +711,14 @@
     #define MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST          MN_THREAD_CONFIG_NO
 #endif
 
+#ifndef MN_THREAD_CONFIG_TASK_LIST_BUCKETS
+    /**
+     * The number of hash buckets of the id and the name index of the
+     * basic_task_list, must be a power of two
+     */
+    #define MN_THREAD_CONFIG_TASK_LIST_BUCKETS              32
+#endif
+
 #ifndef MN_THREAD_CONFIG_DEBUG
     #define  MN_THREAD_CONFIG_DEBUG     MN_THREAD_CONFIG_YES
 #endif
@@ -421,6 +752,22 @@
     #define MN_THREAD_CONFIG_MEMPOOL_USETIMED     MN_THREAD_CONFIG_YES
 #endif
 
+#ifndef MN_THREAD_CONFIG_MEMPOOL_MAGAZINE_SIZE
+    /**
+     * The number of cached chunks per task in basic_mempool_magazine, 
+     * refill and drain use the half
+     */
+    #define MN_THREAD_CONFIG_MEMPOOL_MAGAZINE_SIZE      16
+#endif
+
+#ifndef MN_THREAD_CONFIG_MEMPOOL_MAGAZINES
+    /**
+     * How many tasks can have a magazine in one basic_mempool_magazine,
+     * all other tasks use the pool direct
+     */
+    #define MN_THREAD_CONFIG_MEMPOOL_MAGAZINES          8
+#endif
+
 #ifndef MN_THREAD_CONFIG_ALLOCATOR_DEFAULT
     /**
      * Which allocator use for default_allocator_t
@@ -0,0 +1,580 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_COROUTINE_
+#define MINLIB_ESP32_COROUTINE_
+
+#include "mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE_SUPPORT == MN_THREAD_CONFIG_YES
+
+#include <coroutine>
+#include <vector>
+
+#include "mn_error.hpp"
+#include "mn_lock.hpp"
+#include "mn_mutex.hpp"
+#include "mn_autolock.hpp"
+#include "mn_task.hpp"
+#include "mn_eventgroup.hpp"
+#include "queue/mn_queue.hpp"
+
+namespace mn {
+    class basic_coro_executor;
+
+    /**
+     * A suspended coroutine, that waits on a executor for a condition or a
+     * time. The node lives in the awaiter - in the frame of the coroutine -
+     * so waiting allocates nothing.
+     *
+     * @ingroup task
+     */
+    class coro_waiter {
+        friend class basic_coro_executor;
+    public:
+        /**
+         * @param timeout How long to wait in ticks, portMAX_DELAY waits for ever
+         * @param polled True: the executor calls poll, false: only the time
+         */
+        coro_waiter(unsigned int timeout, bool polled)
+            : m_uiTimeout(timeout), m_bPolled(polled), m_bTimedOut(false),
+              m_uiDeadline(0), m_pNext(NULL) { }
+
+        /**
+         * Try the condition without blocking, called from the executor task
+         * @return True: the condition is done, resume the coroutine
+         */
+        virtual bool poll() { return false; }
+
+        /**
+         * Is the coroutine resumed, because the timeout is over
+         */
+        bool is_timed_out() const { return m_bTimedOut; }
+    protected:
+        /**
+         * Add this waiter to the executor of the coroutine
+         */
+        template <class TPromise>
+        void suspend(std::coroutine_handle<TPromise> handle);
+    private:
+        std::coroutine_handle<> m_hHandle;
+        unsigned int m_uiTimeout;
+        bool m_bPolled;
+        bool m_bTimedOut;
+        TickType_t m_uiDeadline;
+        coro_waiter* m_pNext;
+    };
+
+    /**
+     * The return type of a coroutine, that runs on a basic_coro_executor. The
+     * coroutine starts suspended, spawn it on a executor or co_await it in
+     * a other coroutine - the caller is resumed, when the child is finished.
+     *
+     * Each coroutine allocates his frame once with new, waiting allocates
+     * nothing.
+     *
+     * @code
+     *  basic_coro_task consumer(queue::basic_queue& q) {
+     *      int value;
+     *      while(true) {
+     *          if(co_await coro_dequeue(q, &value, 100) == ERR_QUEUE_OK)
+     *              process(value);
+     *      }
+     *  }
+     *  executor.spawn(consumer(q));
+     * @endcode
+     *
+     * @ingroup task
+     */
+    class basic_coro_task {
+    public:
+        class promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        /**
+         * Resume the awaiting coroutine, when the task is finished - a
+         * spawned task is reaped from his executor
+         */
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle_type handle) noexcept;
+            void await_resume() noexcept { }
+        };
+
+        class promise_type {
+        public:
+            basic_coro_task get_return_object() { return basic_coro_task(handle_type::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return { }; }
+            final_awaiter final_suspend() noexcept { return { }; }
+            void return_void() { }
+            void unhandled_exception() { }
+
+            /**
+             * The executor, that runs this coroutine
+             */
+            basic_coro_executor* executor = NULL;
+            /**
+             * The awaiting coroutine or empty for a spawned task
+             */
+            std::coroutine_handle<> continuation;
+        };
+
+        basic_coro_task() : m_hHandle() { }
+        explicit basic_coro_task(handle_type handle) : m_hHandle(handle) { }
+        basic_coro_task(basic_coro_task&& other) : m_hHandle(other.m_hHandle) { other.m_hHandle = NULL; }
+        ~basic_coro_task() { if(m_hHandle) m_hHandle.destroy(); }
+
+        basic_coro_task& operator = (basic_coro_task&& other) {
+            if(this != &other) {
+                if(m_hHandle) m_hHandle.destroy();
+                m_hHandle = other.m_hHandle; other.m_hHandle = NULL;
+            }
+            return *this;
+        }
+        basic_coro_task(const basic_coro_task&) = delete;
+        basic_coro_task& operator = (const basic_coro_task&) = delete;
+
+        /**
+         * Has this object a coroutine
+         */
+        bool valid() const { return (bool)m_hHandle; }
+        /**
+         * Is the coroutine finished
+         */
+        bool is_done() const { return !m_hHandle || m_hHandle.done(); }
+
+        /**
+         * Take the coroutine from this object, the caller destroys it
+         */
+        handle_type release() { handle_type _ret = m_hHandle; m_hHandle = NULL; return _ret; }
+
+        // co_await a child task: run the child on the executor of the caller
+        bool await_ready() { return is_done(); }
+        template <class TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> caller) {
+            m_hHandle.promise().executor = caller.promise().executor;
+            m_hHandle.promise().continuation = caller;
+            return m_hHandle;
+        }
+        void await_resume() { }
+    private:
+        handle_type m_hHandle;
+    };
+
+    /**
+     * A task, that runs coroutines. All coroutines run in this one task, a
+     * waiting coroutine gives the task to the other coroutines.
+     *
+     * The FreeRTOS objects signal no waiter, so a waiting coroutine polls his
+     * object with timeout 0: the executor tries the waiting coroutines and
+     * then sleeps on his task notification until the next deadline or the
+     * next poll. The poll interval starts with one tick and doubles after each
+     * poll without a ready coroutine, up to MN_THREAD_CONFIG_COROUTINE_POLL_TICKS.
+     * Call notify after a enqueue, unlock or set bits to wake the executor 
+     * without the poll delay, notify is the fast wake path.
+     *
+     * @ingroup task
+     */
+    class basic_coro_executor : public basic_task {
+        friend class coro_waiter;
+        friend struct basic_coro_task::final_awaiter;
+    public:
+        explicit basic_coro_executor(std::string strName = "coro",
+                basic_task::priority uiPriority = MN_THREAD_CONFIG_COROUTINE_PRIORITY,
+                unsigned short usStackDepth = MN_THREAD_CONFIG_COROUTINE_STACKSIZE,
+                unsigned int uiPollTicks = MN_THREAD_CONFIG_COROUTINE_POLL_TICKS)
+            : basic_task(strName, uiPriority, usStackDepth), m_uiPollTicks(uiPollTicks),
+              m_pWaiters(NULL), m_bStop(false), m_uiNumTasks(0) { }
+
+        /**
+         * Stop the executor, when it runs
+         */
+        virtual ~basic_coro_executor() { stop(); }
+
+        /**
+         * Start the executor task
+         */
+        virtual int start(int uiCore = MN_THREAD_CONFIG_DEFAULT_CORE) override {
+            m_bStop = false;
+            return basic_task::start(uiCore);
+        }
+
+        /**
+         * Run a coroutine on this executor, can call from all tasks and from
+         * the coroutines of this executor. The executor owns the coroutine
+         * and destroys it, when it is finished or the executor stops
+         *
+         * @return
+         *  - ERR_COROUTINE_OK The coroutine is scheduled
+         *  - ERR_COROUTINE_CANSHEDULE The task has no coroutine
+         */
+        int spawn(basic_coro_task&& task) {
+            if(!task.valid()) return ERR_COROUTINE_CANSHEDULE;
+
+            basic_coro_task::handle_type _handle = task.release();
+            _handle.promise().executor = this;
+            {
+                automutx_t lock(m_mutexSpawn);
+                m_vSpawned.push_back(_handle);
+            }
+            notify();
+            return ERR_COROUTINE_OK;
+        }
+
+        /**
+         * Wake the executor, the waiting coroutines are polled now
+         */
+        void notify() {
+            xTaskHandle _handle = get_handle();
+            if(_handle != NULL) xTaskNotifyGive(_handle);
+        }
+
+        /**
+         * Stop the executor and wait for his end, the not finished
+         * coroutines are destroyed - also the spawned coroutines of a
+         * not started executor
+         */
+        void stop() {
+            m_bStop = true;
+
+            // a started executor destroys the coroutines on his end
+            if(get_handle() != NULL) {
+                notify();
+                join();
+            } else {
+                destroy_all();
+            }
+        }
+
+        /**
+         * Get the number of the not finished spawned coroutines
+         */
+        uint32_t get_num_tasks() { return m_uiNumTasks; }
+
+        virtual void* on_task() override;
+    private:
+        /**
+         * Called from the coroutine on suspend, only in the executor task
+         */
+        void add_waiter(coro_waiter* waiter) {
+            waiter->m_pNext = m_pWaiters;
+            m_pWaiters = waiter;
+        }
+        /**
+         * A spawned coroutine is finished, destroyed after the resume
+         */
+        void finished(std::coroutine_handle<> handle) {
+            m_vFinished.push_back(handle);
+        }
+        /**
+         * Resume a coroutine and destroy the finished spawned coroutines
+         */
+        void resume(std::coroutine_handle<> handle);
+        /**
+         * Destroy all not finished coroutines, on the end of the task
+         */
+        void destroy_all();
+    private:
+        unsigned int m_uiPollTicks;
+        coro_waiter* m_pWaiters;
+        volatile bool m_bStop;
+        uint32_t m_uiNumTasks;
+
+        mutex_t m_mutexSpawn;
+        /**
+         * The new coroutines, filled from all tasks
+         */
+        std::vector<basic_coro_task::handle_type> m_vSpawned;
+        /**
+         * The running spawned coroutines, only used in the executor task
+         */
+        std::vector<basic_coro_task::handle_type> m_vTasks;
+        std::vector<std::coroutine_handle<> > m_vFinished;
+    };
+
+    //-----------------------------------
+    //  coro_waiter::suspend
+    //-----------------------------------
+    template <class TPromise>
+    inline void coro_waiter::suspend(std::coroutine_handle<TPromise> handle) {
+        m_hHandle = handle;
+        m_bTimedOut = false;
+        if(m_uiTimeout != portMAX_DELAY)
+            m_uiDeadline = xTaskGetTickCount() + m_uiTimeout;
+        handle.promise().executor->add_waiter(this);
+    }
+
+    //-----------------------------------
+    //  basic_coro_task::final_awaiter::await_suspend
+    //-----------------------------------
+    inline std::coroutine_handle<> basic_coro_task::final_awaiter::await_suspend(handle_type handle) noexcept {
+        promise_type& _promise = handle.promise();
+
+        if(_promise.continuation)
+            return _promise.continuation;
+        if(_promise.executor)
+            _promise.executor->finished(handle);
+
+        return std::noop_coroutine();
+    }
+
+    //-----------------------------------
+    //  basic_coro_executor::resume
+    //-----------------------------------
+    inline void basic_coro_executor::resume(std::coroutine_handle<> handle) {
+        handle.resume();
+
+        for(size_t i = 0; i < m_vFinished.size(); i++) {
+            for(size_t j = 0; j < m_vTasks.size(); j++) {
+                if(m_vTasks[j] != m_vFinished[i]) continue;
+
+                m_vTasks[j] = m_vTasks.back();
+                m_vTasks.pop_back();
+                break;
+            }
+            m_vFinished[i].destroy();
+            m_uiNumTasks--;
+        }
+        m_vFinished.clear();
+    }
+
+    //-----------------------------------
+    //  basic_coro_executor::destroy_all
+    //-----------------------------------
+    inline void basic_coro_executor::destroy_all() {
+        // the waiter nodes are in the frames
+        m_pWaiters = NULL;
+
+        automutx_t lock(m_mutexSpawn);
+        for(size_t i = 0; i < m_vSpawned.size(); i++) m_vTasks.push_back(m_vSpawned[i]);
+        m_vSpawned.clear();
+
+        // a frame destroys the awaited child tasks
+        for(size_t i = 0; i < m_vTasks.size(); i++) m_vTasks[i].destroy();
+        m_vTasks.clear();
+        m_uiNumTasks = 0;
+    }
+
+    //-----------------------------------
+    //  basic_coro_executor::on_task
+    //-----------------------------------
+    inline void* basic_coro_executor::on_task() {
+        std::vector<basic_coro_task::handle_type> _spawned;
+        // the poll interval, doubled after each poll without a ready coroutine
+        TickType_t _poll = 1;
+
+        while(!m_bStop) {
+            {
+                automutx_t lock(m_mutexSpawn);
+                _spawned.swap(m_vSpawned);
+            }
+            for(size_t i = 0; i < _spawned.size(); i++) {
+                m_vTasks.push_back(_spawned[i]);
+                m_uiNumTasks++;
+                resume(_spawned[i]);
+            }
+            _spawned.clear();
+
+            // take the list, a resumed coroutine adds his next waiter
+            coro_waiter* _waiter = m_pWaiters;
+            coro_waiter* _ready = NULL;
+            coro_waiter** _readyTail = &_ready;
+            TickType_t _now = xTaskGetTickCount();
+            bool _polledReady = false;
+            m_pWaiters = NULL;
+
+            while(_waiter != NULL) {
+                coro_waiter* _next = _waiter->m_pNext;
+                _waiter->m_pNext = NULL;
+
+                if(_waiter->m_bPolled && _waiter->poll()) {
+                    _polledReady = true;
+                    *_readyTail = _waiter; _readyTail = &_waiter->m_pNext;
+                } else if(_waiter->m_uiTimeout != portMAX_DELAY &&
+                          (int32_t)(_now - _waiter->m_uiDeadline) >= 0) {
+                    _waiter->m_bTimedOut = true;
+                    *_readyTail = _waiter; _readyTail = &_waiter->m_pNext;
+                } else {
+                    _waiter->m_pNext = m_pWaiters;
+                    m_pWaiters = _waiter;
+                }
+                _waiter = _next;
+            }
+            while(_ready != NULL) {
+                coro_waiter* _next = _ready->m_pNext;
+                // the node is gone after the resume
+                resume(_ready->m_hHandle);
+                _ready = _next;
+            }
+
+            // sleep until the next deadline, a notify or the next poll
+            TickType_t _sleep = portMAX_DELAY;
+            _now = xTaskGetTickCount();
+
+            if(_polledReady) _poll = 1;
+            else if(_poll < m_uiPollTicks) _poll = (_poll * 2 < m_uiPollTicks) ? _poll * 2 : m_uiPollTicks;
+
+            for(coro_waiter* w = m_pWaiters; w != NULL; w = w->m_pNext) {
+                if(w->m_bPolled && _poll < _sleep) _sleep = _poll;
+                if(w->m_uiTimeout == portMAX_DELAY) continue;
+
+                int32_t _left = (int32_t)(w->m_uiDeadline - _now);
+                if(_left <= 0) { _sleep = 0; break; }
+                if((TickType_t)_left < _sleep) _sleep = (TickType_t)_left;
+            }
+            // a notify polls again from the first interval
+            if(_sleep != 0 && ulTaskNotifyTake(pdTRUE, _sleep) != 0) _poll = 1;
+        }
+        destroy_all();
+
+        return NULL;
+    }
+
+    /**
+     * Sleep the coroutine, the other coroutines run
+     * @see coro_sleep
+     */
+    class coro_sleep_awaiter : public coro_waiter {
+    public:
+        explicit coro_sleep_awaiter(unsigned int ticks) : coro_waiter(ticks, false) { }
+
+        bool await_ready() { return false; }
+        template <class TPromise>
+        void await_suspend(std::coroutine_handle<TPromise> handle) { suspend(handle); }
+        void await_resume() { }
+    };
+
+    /**
+     * Dequeue a item from a queue
+     * @see coro_dequeue
+     */
+    class coro_dequeue_awaiter : public coro_waiter {
+    public:
+        coro_dequeue_awaiter(queue::basic_queue& q, void* item, unsigned int timeout)
+            : coro_waiter(timeout, true), m_queue(q), m_pItem(item), m_iRet(ERR_QUEUE_REMOVE) { }
+
+        virtual bool poll() override {
+            m_iRet = m_queue.dequeue(m_pItem, 0);
+            return m_iRet == ERR_QUEUE_OK;
+        }
+
+        bool await_ready() { return poll(); }
+        template <class TPromise>
+        void await_suspend(std::coroutine_handle<TPromise> handle) { suspend(handle); }
+        int await_resume() { return m_iRet; }
+    private:
+        queue::basic_queue& m_queue;
+        void* m_pItem;
+        int m_iRet;
+    };
+
+    /**
+     * Lock a lock object (mutex, semaphore ...)
+     * @see coro_lock
+     */
+    class coro_lock_awaiter : public coro_waiter {
+    public:
+        coro_lock_awaiter(ILockObject& lock, unsigned int timeout)
+            : coro_waiter(timeout, true), m_lock(lock), m_iRet(ERR_TIMEOUT) { }
+
+        virtual bool poll() override {
+            m_iRet = m_lock.lock(0);
+            return m_iRet == NO_ERROR;
+        }
+
+        bool await_ready() { return poll(); }
+        template <class TPromise>
+        void await_suspend(std::coroutine_handle<TPromise> handle) { suspend(handle); }
+        int await_resume() { return m_iRet; }
+    private:
+        ILockObject& m_lock;
+        int m_iRet;
+    };
+
+    /**
+     * Wait for bits of a event group
+     * @see coro_wait_bits
+     */
+    class coro_bits_awaiter : public coro_waiter {
+    public:
+        coro_bits_awaiter(basic_event_group& group, EventBits_t bits, bool clearOnExit,
+                          bool waitAll, unsigned int timeout)
+            : coro_waiter(timeout, true), m_group(group), m_uiBits(bits),
+              m_bClear(clearOnExit), m_bAll(waitAll), m_uiRet(0) { }
+
+        virtual bool poll() override {
+            m_uiRet = m_group.wait(m_uiBits, m_bClear, m_bAll, 0);
+            return m_bAll ? ((m_uiRet & m_uiBits) == m_uiBits) : ((m_uiRet & m_uiBits) != 0);
+        }
+
+        bool await_ready() { return poll(); }
+        template <class TPromise>
+        void await_suspend(std::coroutine_handle<TPromise> handle) { suspend(handle); }
+        EventBits_t await_resume() { return m_uiRet; }
+    private:
+        basic_event_group& m_group;
+        EventBits_t m_uiBits;
+        bool m_bClear;
+        bool m_bAll;
+        EventBits_t m_uiRet;
+    };
+
+    /**
+     * co_await: sleep the coroutine for the given ticks
+     */
+    inline coro_sleep_awaiter coro_sleep(unsigned int ticks) { return coro_sleep_awaiter(ticks); }
+
+    /**
+     * co_await: give the executor to the other coroutines
+     */
+    inline coro_sleep_awaiter coro_yield() { return coro_sleep_awaiter(0); }
+
+    /**
+     * co_await: dequeue a item from the queue
+     * @return 'ERR_QUEUE_OK' the item was removed, 'ERR_QUEUE_REMOVE' after the timeout
+     */
+    inline coro_dequeue_awaiter coro_dequeue(queue::basic_queue& q, void* item,
+            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+        return coro_dequeue_awaiter(q, item, timeout);
+    }
+
+    /**
+     * co_await: lock the lock object
+     * @return NO_ERROR the lock is taken, the error of lock(0) after the timeout
+     */
+    inline coro_lock_awaiter coro_lock(ILockObject& lock,
+            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_COROUTINE_DEFAULT) {
+        return coro_lock_awaiter(lock, timeout);
+    }
+
+    /**
+     * co_await: wait for one or all bits of the event group
+     * @return The bits of the event group, like basic_event_group::wait
+     */
+    inline coro_bits_awaiter coro_wait_bits(basic_event_group& group, EventBits_t bits,
+            bool clearOnExit = true, bool waitAll = false,
+            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_COROUTINE_DEFAULT) {
+        return coro_bits_awaiter(group, bits, clearOnExit, waitAll, timeout);
+    }
+
+    using coro_task_t = basic_coro_task;
+    using coro_executor_t = basic_coro_executor;
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE_SUPPORT
+
+#endif
@@ -124,6 +124,10 @@
  * The thread can not start, becourse the thread is allready started
  */
 #define ERR_TASK_ALREADYRUNNING		    0x3005
+/**
+ * The thread is not ended after the timeout
+ */
+#define ERR_TASK_TIMEOUT			    0x3006
 
 // --------------------------------
 
@@ -228,6 +232,14 @@
  * The item can not add to the workqueue
  */
 #define ERR_WORKQUEUE_ADD                   0x7005
+/**
+ * The item is not a delayed or periodic item of the workqueue
+ */
+#define ERR_WORKQUEUE_NOTFOUND              0x7006
+/**
+ * The work graph runs, it can not changed or started
+ */
+#define ERR_WORKQUEUE_BUSY                  0x7007
 
 
 
@@ -250,4 +262,46 @@
 #define ERR_TICKHOOK_ADD                  0x9001 
 #define ERR_TICKHOOK_ENTRY_NULL           0x900A       
 
+/**
+ * No error with the future
+ */
+#define ERR_FUTURE_OK                     NO_ERROR
+/**
+ * The future is not ready after the timeout
+ */
+#define ERR_FUTURE_TIMEOUT                0xA001
+/**
+ * The future has a other waiter or continuation
+ */
+#define ERR_FUTURE_BUSY                   0xA002
+/**
+ * The value of the promise is already set
+ */
+#define ERR_FUTURE_ALREADY                0xA003
+/**
+ * The future has no state (i.e. async could not queue the function)
+ */
+#define ERR_FUTURE_NOSTATE                0xA004
+
+/**
+ * No error with the task pool
+ */
+#define ERR_TASKPOOL_OK                   NO_ERROR
+/**
+ * No idle task in the sub pool after the timeout
+ */
+#define ERR_TASKPOOL_EMPTY                0xB001
+/**
+ * The task pool has no sub pool for the core
+ */
+#define ERR_TASKPOOL_CORE                 0xB002
+/**
+ * The task pool is not created
+ */
+#define ERR_TASKPOOL_NOTCREATED           0xB003
+/**
+ * A task of the pool can not start, the pool is not created
+ */
+#define ERR_TASKPOOL_CREATE               0xB004
+
 #endif
@@ -0,0 +1,459 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_FUTURE_
+#define MINLIB_ESP32_FUTURE_
+
+#include "mn_config.hpp"
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_functional.hpp"
+#include "queue/mn_workqueue.hpp"
+
+namespace mn {
+    /**
+     * The not typed part of a future state: the ready flag and the waiter.
+     * The waiter is one atomic word - empty, ready, a continuation or a 
+     * waiting task - so the setter publishes the value and takes the waiter 
+     * with one exchange and touches the state never after the waiter is 
+     * woken. No lock and no heap.
+     *
+     * @ingroup base
+     */
+    class basic_future_state_base {
+    public:
+        basic_future_state_base() 
+            : m_uiWaiter(Empty), m_bSet(false), m_pThenQueue(NULL), m_pThenItem(NULL) { }
+
+        basic_future_state_base(const basic_future_state_base&) = delete;
+        basic_future_state_base& operator = (const basic_future_state_base&) = delete;
+
+        /**
+         * Is the value set
+         */
+        bool is_ready() { return m_uiWaiter.load(memory_order::Acquire) == Ready; }
+
+        /**
+         * Wait until the value is set, the waiting task blocks on his task 
+         * notification - do not use the task notification of the waiting task 
+         * for other things while waiting. Only one task can wait.
+         *
+         * @param timeout How long to wait in ticks
+         * @return 
+         *  - ERR_FUTURE_OK The value is set
+         *  - ERR_FUTURE_TIMEOUT The value is not set after the timeout
+         *  - ERR_FUTURE_BUSY A other task waits or a continuation is set
+         */
+        int wait(unsigned int timeout);
+
+        /**
+         * Queue a item to the work queue, when the value is set - or now, when 
+         * the value is already set. The state must live until the item runs
+         * 
+         * @return 
+         *  - ERR_FUTURE_OK The continuation is set or queued
+         *  - ERR_FUTURE_BUSY A task waits or a other continuation is set
+         */
+        int then(queue::basic_work_queue& workqueue, queue::work_queue_item_t* item);
+
+        /**
+         * Reset the state for a new value, no task may wait
+         */
+        void reset();
+    protected:
+        /**
+         * Only the first setter sets the value
+         */
+        bool try_set() { 
+            bool _expected = false; bool _desired = true;
+            return m_bSet.compare_exchange_strong(_expected, _desired); 
+        }
+        /**
+         * Publish the value and wake the waiter, called after the value is set
+         */
+        void make_ready();
+        /**
+         * Queue the continuation, or run it here when the queue is full
+         */
+        static void queue_then(queue::basic_work_queue* workqueue, queue::work_queue_item_t* item);
+
+        static constexpr uintptr_t Empty = 0;
+        static constexpr uintptr_t Ready = 1;
+        static constexpr uintptr_t Then = 2;
+        /** then writes the continuation, Then is published after this */
+        static constexpr uintptr_t Claiming = 3;
+    private:
+        /**
+         * Empty, Ready, Then, Claiming or the address of the waiter on the waiting task stack
+         */
+        basic_atomic_gcc<uintptr_t> m_uiWaiter;
+        /**
+         * Set from the first setter
+         */
+        basic_atomic_gcc<bool> m_bSet;
+        /**
+         * The continuation, valid with Then
+         */
+        queue::basic_work_queue* m_pThenQueue;
+        queue::work_queue_item_t* m_pThenItem;
+    };
+
+    /**
+     * The shared state of a future and a promise with the value in place. 
+     * The state is a member of the promise or of the async item, see 
+     * basic_promise and async.
+     *
+     * @tparam T The type of the value
+     *
+     * @ingroup base
+     */
+    template <typename T>
+    class basic_future_state : public basic_future_state_base {
+    public:
+        basic_future_state() { }
+        ~basic_future_state() { destroy_value(); }
+
+        /**
+         * Set the value and wake the waiter
+         * @return 
+         *  - ERR_FUTURE_OK The value is set
+         *  - ERR_FUTURE_ALREADY The value was already set
+         */
+        template <typename U>
+        int set_value(U&& value) {
+            if(!try_set()) return ERR_FUTURE_ALREADY;
+
+            new (&m_value) T(mn::forward<U>(value));
+            make_ready();
+
+            return ERR_FUTURE_OK;
+        }
+
+        /**
+         * Get the value, only when is_ready
+         */
+        T& value() { return *reinterpret_cast<T*>(&m_value); }
+
+        /**
+         * Reset the state for a new value, no task may wait
+         */
+        void reset() { 
+            destroy_value();
+            basic_future_state_base::reset();
+        }
+    private:
+        void destroy_value() { 
+            if(is_ready()) value().~T(); 
+        }
+    private:
+        aligned_storage_t<sizeof(T), alignof(T)> m_value;
+    };
+
+    /**
+     * The shared state of a future without value
+     */
+    template <>
+    class basic_future_state<void> : public basic_future_state_base {
+    public:
+        int set_value() {
+            if(!try_set()) return ERR_FUTURE_ALREADY;
+            make_ready();
+
+            return ERR_FUTURE_OK;
+        }
+        void value() { }
+    };
+
+    namespace internal {
+        template <typename T> struct future_ref { using type = T&; };
+        template <> struct future_ref<void> { using type = void; };
+
+        /**
+         * Release the async item of a future, the last owner gives it back to the pool
+         */
+        inline void future_release(queue::work_queue_item_t* owner) {
+            if(owner && owner->can_release()) owner->release();
+        }
+
+        // the continuation gets the value
+        template <class TFn, typename T>
+        inline auto future_invoke(TFn& fn, basic_future_state<T>* state) -> decltype(fn(state->value())) {
+            return fn(state->value());
+        }
+        // a continuation of a void future gets nothing
+        template <class TFn>
+        inline auto future_invoke(TFn& fn, basic_future_state<void>* state) -> decltype(fn()) {
+            (void)state; return fn();
+        }
+    }
+
+    /**
+     * The reading side of a future state. Not copyable, only movable. 
+     * 
+     * @code
+     *  basic_promise<int> promise;
+     *  basic_future<int> future = promise.get_future();
+     *  workqueue.queue_fn([&promise]() { promise.set_value(read_sensor()); });
+     * 
+     *  if(future.wait_for(100) == ERR_FUTURE_OK) use(future.get());
+     * @endcode
+     *
+     * @tparam T The type of the value, can be void
+     *
+     * @ingroup base
+     */
+    template <typename T>
+    class basic_future {
+    public:
+        using state_type = basic_future_state<T>;
+        using reference = typename internal::future_ref<T>::type;
+
+        basic_future() : m_pState(NULL), m_pOwner(NULL) { }
+
+        /**
+         * @param state The state
+         * @param owner The async item with the state, released from the future
+         */
+        explicit basic_future(state_type* state, queue::work_queue_item_t* owner = NULL) 
+            : m_pState(state), m_pOwner(owner) { }
+
+        basic_future(basic_future&& other) 
+            : m_pState(other.m_pState), m_pOwner(other.m_pOwner) {
+            other.m_pState = NULL; other.m_pOwner = NULL;
+        }
+        basic_future& operator = (basic_future&& other) {
+            if(this != &other) {
+                internal::future_release(m_pOwner);
+                m_pState = other.m_pState; m_pOwner = other.m_pOwner;
+                other.m_pState = NULL; other.m_pOwner = NULL;
+            }
+            return *this;
+        }
+        basic_future(const basic_future&) = delete;
+        basic_future& operator = (const basic_future&) = delete;
+
+        ~basic_future() { internal::future_release(m_pOwner); }
+
+        /**
+         * Has the future a state
+         */
+        bool valid() const { return m_pState != NULL; }
+        /**
+         * Is the value set
+         */
+        bool is_ready() { return m_pState && m_pState->is_ready(); }
+
+        /**
+         * Wait without timeout until the value is set
+         * @see basic_future_state_base::wait
+         */
+        int wait() { return wait_for(portMAX_DELAY); }
+        /**
+         * Wait until the value is set
+         * @param timeout How long to wait in ticks
+         * @return ERR_FUTURE_NOSTATE without state, else see basic_future_state_base::wait
+         */
+        int wait_for(unsigned int timeout) {
+            return m_pState ? m_pState->wait(timeout) : ERR_FUTURE_NOSTATE;
+        }
+
+        /**
+         * Wait without timeout and get the value, the future must be valid
+         */
+        reference get() {
+            wait();
+            return m_pState->value();
+        }
+
+        /**
+         * Queue a item to a work queue, when the value is set. The future
+         * must live until the item runs
+         * @see basic_future_state_base::then
+         */
+        int then(queue::basic_work_queue& workqueue, queue::work_queue_item_t* item) {
+            return m_pState ? m_pState->then(workqueue, item) : ERR_FUTURE_NOSTATE;
+        }
+
+        /**
+         * Run a callable on a work queue, when the value is set. The callable 
+         * gets the value (T&, nothing for void) and returns bool or void. The
+         * continuation is created in the item pool of the work queue and takes 
+         * the state: the future is not valid after a successful call 
+         * 
+         * @return 
+         *  - ERR_FUTURE_OK The continuation is set
+         *  - ERR_FUTURE_NOSTATE The future is not valid
+         *  - ERR_FUTURE_BUSY A task waits or a continuation is set
+         *  - ERR_WORKQUEUE_ADD The item pool is empty
+         */
+        template <class TFn>
+        int then_fn(queue::basic_work_queue& workqueue, TFn fn) {
+            if(m_pState == NULL) return ERR_FUTURE_NOSTATE;
+
+            state_type* _state = m_pState;
+            queue::work_queue_item_t* _owner = m_pOwner;
+
+            auto _then = [_state, _owner, fn]() mutable {
+                auto _call = [_state, &fn]() { return internal::future_invoke(fn, _state); };
+                bool _ret = queue::internal::work_fn_call(_call, 0);
+
+                internal::future_release(_owner);
+                return _ret;
+            };
+            queue::work_queue_item_t* _item = 
+                workqueue.template create_item<queue::work_queue_fn_item<decltype(_then)>>(mn::move(_then));
+            if(_item == NULL) return ERR_WORKQUEUE_ADD;
+
+            int ret = m_pState->then(workqueue, _item);
+            if(ret != ERR_FUTURE_OK) {
+                // not run, the future holds the state
+                _item->release();
+                return ret;
+            }
+            m_pState = NULL; m_pOwner = NULL;
+
+            return ERR_FUTURE_OK;
+        }
+    private:
+        state_type* m_pState;
+        queue::work_queue_item_t* m_pOwner;
+    };
+
+    /**
+     * The writing side of a future state, the state is a member of the 
+     * promise - no heap. The promise must live until the future is ready 
+     * and read (or the continuation ran)
+     *
+     * @tparam T The type of the value, can be void
+     *
+     * @ingroup base
+     */
+    template <typename T>
+    class basic_promise {
+    public:
+        basic_promise() { }
+
+        basic_promise(const basic_promise&) = delete;
+        basic_promise& operator = (const basic_promise&) = delete;
+
+        /**
+         * Get the future of this promise, only one future may wait
+         */
+        basic_future<T> get_future() { return basic_future<T>(&m_state); }
+
+        /**
+         * Set the value (nothing for void) and wake the waiting task or queue
+         * the continuation. After this, the setter does not touch the promise
+         * @return 
+         *  - ERR_FUTURE_OK The value is set
+         *  - ERR_FUTURE_ALREADY The value was already set
+         */
+        template <typename... TArgs>
+        int set_value(TArgs&&... args) { 
+            return m_state.set_value(mn::forward<TArgs>(args)...); 
+        }
+
+        /**
+         * Is the value set
+         */
+        bool is_ready() { return m_state.is_ready(); }
+        /**
+         * Reset the promise for a new value, no task may wait
+         */
+        void reset() { m_state.reset(); }
+    private:
+        basic_future_state<T> m_state;
+    };
+
+    namespace internal {
+        template <class TFn, typename R>
+        inline void async_run(basic_future_state<R>& state, TFn& fn) { state.set_value(fn()); }
+
+        template <class TFn>
+        inline void async_run(basic_future_state<void>& state, TFn& fn) { fn(); state.set_value(); }
+
+        /**
+         * The work item of async: the callable and the state of the future. 
+         * Shared from the work queue and the future, the last gives the 
+         * block back to the item pool
+         */
+        template <class TFn, typename R>
+        class async_item : public queue::work_queue_item_t {
+        public:
+            explicit async_item(TFn fn) 
+                : queue::work_queue_item_t(true), m_fn(mn::move(fn)), m_uiRefs(2) { }
+
+            virtual bool on_work() override { 
+                async_run(m_state, m_fn); 
+                return true; 
+            }
+            virtual bool can_release() override { return --m_uiRefs == 0; }
+
+            basic_future_state<R>* get_state() { return &m_state; }
+        private:
+            TFn m_fn;
+            basic_future_state<R> m_state;
+            atomic_uint32_t m_uiRefs;
+        };
+    }
+
+    /**
+     * Run a callable on a work queue and get the result as future. The 
+     * callable and the result are in one item of the item pool of the work 
+     * queue - no heap. 
+     * 
+     * @code
+     *  auto temp = async(workqueue, []() { return read_temp(); });
+     *  ...
+     *  float t = temp.get();
+     * @endcode
+     *
+     * @param workqueue The work queue
+     * @param fn The callable, the result is the value of the future
+     * @param timeout How long to wait when the queue is full, then the 
+     * callable runs in the calling task
+     * @return The future, not valid when the item pool is empty
+     */
+    template <class TFn>
+    auto async(queue::basic_work_queue& workqueue, TFn fn, 
+               unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) 
+        -> basic_future<decay_t<decltype(fn())>> {
+
+        using result_type = decay_t<decltype(fn())>;
+        using item_type = internal::async_item<TFn, result_type>;
+
+        item_type* _item = workqueue.template create_item<item_type>(mn::move(fn));
+        if(_item == NULL) return basic_future<result_type>();
+
+        basic_future<result_type> _future(_item->get_state(), _item);
+
+        if(workqueue.queue(_item, timeout) != ERR_WORKQUEUE_OK) {
+            // the queue is full, run it here and drop the reference of the queue
+            _item->on_work();
+            internal::future_release(_item);
+        }
+        return _future;
+    }
+
+    template <typename T>
+    using future_t = basic_future<T>;
+
+    template <typename T>
+    using promise_t = basic_promise<T>;
+}
+
+#endif
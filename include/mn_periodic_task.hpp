@@ -0,0 +1,164 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_PERIODIC_TASK_
+#define MINLIB_ESP32_PERIODIC_TASK_
+
+#include "mn_config.hpp"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mn_task.hpp"
+#include "mn_mutex.hpp"
+
+namespace mn {
+    /**
+     * The statistics of a basic_periodic_task. All times are micro seconds,
+     * the jitter is the start of on_period after the release on the period grid
+     *
+     * @ingroup task
+     */
+    struct periodic_stats {
+        /** The number of run periods */
+        uint32_t periods;
+        /** How often on_period ran into the next release */
+        uint32_t overruns;
+        /** How often on_period ended after the deadline */
+        uint32_t misses;
+        /** The skipped releases after overruns, with the policy SkipMissed */
+        uint32_t skipped;
+
+        uint32_t jitter_min;
+        uint32_t jitter_max;
+        uint64_t jitter_sum;
+        /**
+         * The histogram of the jitter: bucket 0 is 0us, bucket i counts
+         * [2^(i-1), 2^i) us and the last bucket all longer
+         */
+        uint32_t jitter_hist[MN_THREAD_CONFIG_PERIODIC_HIST_BUCKETS];
+
+        uint32_t exec_max;
+        uint64_t exec_sum;
+
+        /**
+         * Get the average jitter
+         */
+        uint32_t get_jitter_avg() const { return periods ? (uint32_t)(jitter_sum / periods) : 0; }
+        /**
+         * Get the average execution time of on_period
+         */
+        uint32_t get_exec_avg() const { return periods ? (uint32_t)(exec_sum / periods) : 0; }
+    };
+
+    /**
+     * A task that runs on_period with a fixed period. The releases are on a
+     * fixed grid (vTaskDelayUntil), a late period not shifts the next - the
+     * loop holds his rate, not like a loop with a sleep. Each period is
+     * measured: the jitter of the start, the execution time, overruns and
+     * deadline misses.
+     *
+     * @code
+     *  class control_loop : public basic_periodic_task {
+     *  public:
+     *      control_loop() : basic_periodic_task("control", ms_to_ticks(10)) { }
+     *  protected:
+     *      virtual bool on_period() override { update_pid(); return true; }
+     *  };
+     * @endcode
+     *
+     * @ingroup task
+     */
+    class basic_periodic_task : public basic_task {
+    public:
+        /**
+         * What to do after a overrun
+         */
+        enum overrun_policy {
+            SkipMissed,     /*!< skip the passed releases, the next release is the next on the grid */
+            CatchUp         /*!< run the passed releases at once, like vTaskDelayUntil */
+        };
+
+        /**
+         * @param strName The name of the task
+         * @param uiPeriod The period in ticks
+         * @param uiPhase The offset of the first release in ticks
+         * @param uiDeadline The deadline after the release in ticks, 0 is the period
+         * @param uiPriority The priority of the task
+         * @param usStackDepth The stack depth of the task
+         */
+        basic_periodic_task(std::string strName, unsigned int uiPeriod, unsigned int uiPhase = 0,
+                            unsigned int uiDeadline = 0,
+                            basic_task::priority uiPriority = basic_task::PriorityUrgent,
+                            unsigned short usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE);
+
+        /**
+         * Stop the task after the current period, use join to wait
+         */
+        void stop() { m_bStop = true; }
+
+        /**
+         * Set the overrun policy, before start
+         */
+        void set_overrun_policy(overrun_policy policy) { m_ePolicy = policy; }
+        overrun_policy get_overrun_policy() const { return m_ePolicy; }
+
+        /**
+         * Get the period in ticks
+         */
+        unsigned int get_period() const { return m_uiPeriod; }
+        /**
+         * Get the deadline in ticks
+         */
+        unsigned int get_deadline() const { return m_uiDeadline; }
+
+        /**
+         * Get a copy of the statistics
+         */
+        periodic_stats get_stats();
+        /**
+         * Reset the statistics
+         */
+        void reset_stats();
+    protected:
+        /**
+         * Called each period
+         * @return false to end the task
+         */
+        virtual bool on_period() = 0;
+
+        virtual void* on_task() override;
+    private:
+        /**
+         * Add a period to the statistics
+         */
+        void account(long jitter, unsigned long exec, bool overrun, bool miss, uint32_t skipped);
+    private:
+        unsigned int m_uiPeriod;
+        unsigned int m_uiPhase;
+        unsigned int m_uiDeadline;
+        overrun_policy m_ePolicy;
+        volatile bool m_bStop;
+
+        mutex_t m_statsLock;
+        periodic_stats m_stats;
+    };
+
+    using periodic_task_t = basic_periodic_task;
+}
+
+#endif
@@ -0,0 +1,203 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_STATIC_TASK_
+#define MINLIB_ESP32_STATIC_TASK_
+
+#include "mn_config.hpp"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mn_error.hpp"
+#include "mn_task.hpp"
+#include "mn_future.hpp"
+#include "mn_functional.hpp"
+
+namespace mn {
+    /**
+     * The not templated part of basic_static_task: the name, the handle, the
+     * task buffer and the end signal of the task.
+     *
+     * The task signals his end and then suspends self, the joiner deletes
+     * the suspended task - so the task buffer is never touched after the
+     * join and the task can start again.
+     *
+     * @ingroup task
+     */
+    class basic_static_task_base {
+    public:
+        /**
+         * Join and delete the task, when it was started
+         */
+        ~basic_static_task_base();
+
+        basic_static_task_base(const basic_static_task_base&) = delete;
+        basic_static_task_base& operator = (const basic_static_task_base&) = delete;
+
+        /**
+         * Wait for the end of the callable and delete the task. Only one
+         * task can join at one time
+         *
+         * @param timeout How long to wait in ticks
+         * @return
+         *  - ERR_TASK_OK The task is ended, it can start again
+         *  - ERR_TASK_NOTRUNNING The task was not started
+         *  - ERR_TASK_TIMEOUT The callable runs after the timeout or a other task joins
+         */
+        int join(unsigned int timeout = portMAX_DELAY);
+
+        /**
+         * Is the task started and not joined
+         */
+        bool is_running() const { return m_pHandle != NULL; }
+        /**
+         * Has the callable returned
+         */
+        bool is_finished() { return m_stateDone.is_ready(); }
+
+        /**
+         * Get the name of this task
+         */
+        const char* get_name() const { return m_strName; }
+        /**
+         * Get the priority of this task
+         */
+        basic_task::priority get_priority() const { return m_uiPriority; }
+        /**
+         * Get the FreeRTOS handle of this task, NULL when not running
+         */
+        xTaskHandle get_handle() const { return m_pHandle; }
+    protected:
+        basic_static_task_base(const char* strName, basic_task::priority uiPriority);
+
+        /**
+         * Create the FreeRTOS task
+         *
+         * @return
+         *  - ERR_TASK_OK The task is created
+         *  - ERR_TASK_ALREADYRUNNING The task runs or is not joined
+         *  - ERR_TASK_CANTSTARTTHREAD can't create the task
+         */
+        int create(TaskFunction_t pStub, StackType_t* pStack, uint32_t uiStackDepth, int iCore);
+
+        /**
+         * Called in the task after the callable, signal the end and wait for
+         * the delete
+         */
+        void finished();
+    private:
+        char m_strName[MN_THREAD_CONFIG_STATIC_TASK_NAME_LEN];
+        basic_task::priority m_uiPriority;
+        xTaskHandle m_pHandle;
+        /**
+         * Ready, when the callable has returned
+         */
+        basic_future_state<void> m_stateDone;
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        StaticTask_t m_TaskBuffer;
+    #endif
+    };
+
+    /**
+     * A task, that runs a callable - without heap and without virtual calls.
+     * The name is in a inline buffer, the task control block and the stack
+     * are in this object (xTaskCreateStaticPinnedToCore) and the end is
+     * signaled with the task notification of the joiner.
+     *
+     * Without configSUPPORT_STATIC_ALLOCATION (i.e. the host port) the task
+     * is created with xTaskCreatePinnedToCore.
+     *
+     * @code
+     *  basic_static_task<decltype(fn), 4096> task("sensor", fn);
+     *  task.start();
+     *  task.join();
+     *
+     *  auto blink = make_static_task<2048>("blink", []() { toggle_led(); });
+     * @endcode
+     *
+     * @tparam TFn The callable, void()
+     * @tparam TStackSize The stack depth of the task
+     *
+     * @ingroup task
+     */
+    template <class TFn, unsigned int TStackSize = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE>
+    class basic_static_task : public basic_static_task_base {
+    public:
+        using self_type = basic_static_task<TFn, TStackSize>;
+
+        template <class TFunc>
+        basic_static_task(const char* strName, TFunc&& fn,
+                          basic_task::priority uiPriority = basic_task::PriorityNormal)
+            : basic_static_task_base(strName, uiPriority), m_fn(mn::forward<TFunc>(fn)) { }
+
+        /**
+         * Join the task here, the callable and the stack are destroyed
+         * before the destructor of basic_static_task_base runs
+         */
+        ~basic_static_task() { join(portMAX_DELAY); }
+
+        /**
+         * Create the task, the task runs the callable once
+         *
+         * @param iCore The core of the task or MN_THREAD_CONFIG_CORE_IFNO
+         * @see basic_static_task_base::create
+         */
+        int start(int iCore = MN_THREAD_CONFIG_DEFAULT_CORE) {
+        #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+            return create(&self_type::runtaskstub, m_stackBuffer, TStackSize, iCore);
+        #else
+            return create(&self_type::runtaskstub, NULL, TStackSize, iCore);
+        #endif
+        }
+
+        /**
+         * Get the stack depth of this task
+         */
+        unsigned int get_stackdepth() const { return TStackSize; }
+    private:
+        static void runtaskstub(void* parm) {
+            self_type* _task = static_cast<self_type*>(parm);
+
+            _task->m_fn();
+            _task->finished();
+        }
+    private:
+        TFn m_fn;
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        StackType_t m_stackBuffer[TStackSize];
+    #endif
+    };
+
+    /**
+     * Create a basic_static_task for the callable
+     *
+     * @tparam TStackSize The stack depth of the task
+     */
+    template <unsigned int TStackSize = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE, class TFn>
+    inline basic_static_task<decay_t<TFn>, TStackSize> make_static_task(const char* strName, TFn&& fn,
+            basic_task::priority uiPriority = basic_task::PriorityNormal) {
+        return basic_static_task<decay_t<TFn>, TStackSize>(strName, mn::forward<TFn>(fn), uiPriority);
+    }
+
+    template <class TFn, unsigned int TStackSize = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE>
+    using static_task_t = basic_static_task<TFn, TStackSize>;
+}
+
+#endif
@@ -83,6 +83,7 @@ namespace mn {
    * @ingroup task
    */
   class  basic_task {
+    friend class basic_task_list;
   public:
     /**
      * @brief Task priority 
@@ -106,8 +107,8 @@ namespace mn {
     };
     /** The using events for wait() and join(). */
     enum event { 
-      EventStarted = 1 << 24,     /*!< Event for task started */ 
-      EventJoin = 1 << 25         /*!< Event for task joined */ 
+      EventStarted = 1 << 22,     /*!< Event for task started */ 
+      EventJoin = 1 << 23         /*!< Event for task joined */ 
     };
 
   public:
@@ -186,6 +187,41 @@ namespace mn {
      */
     void                  join(unsigned int timeout = portMAX_DELAY);
 
+    /**
+     * Join many tasks, the calling task blocks once for all tasks - each 
+     * ending task wakes the caller, not a wait on each task
+     * 
+     * @param tasks The tasks to join
+     * @param count The number of tasks
+     * @param timeout The maximum amount of time (specified in 'ticks') to wait
+     * @param finished When not NULL: set to true for each ended task, count entries
+     * 
+     * @return
+     *  - ERR_TASK_OK All tasks are ended
+     *  - ERR_TASK_TIMEOUT Not all tasks are ended, see finished
+     * 
+     * @note Only one caller can join the same task with join_all or join_any at the same time
+     */
+    static int            join_all(basic_task* const* tasks, size_t count,
+                                   unsigned int timeout = portMAX_DELAY, bool* finished = NULL);
+    /**
+     * Wait until one of the tasks is ended, the calling task blocks once
+     * 
+     * @param tasks The tasks to join
+     * @param count The number of tasks
+     * @param timeout The maximum amount of time (specified in 'ticks') to wait
+     * @param index When not NULL: the index of a ended task or -1
+     * @param finished When not NULL: set to true for each ended task, count entries
+     * 
+     * @return
+     *  - ERR_TASK_OK One or more tasks are ended
+     *  - ERR_TASK_TIMEOUT No task is ended
+     * 
+     * @see join_all
+     */
+    static int            join_any(basic_task* const* tasks, size_t count, unsigned int timeout = portMAX_DELAY,
+                                   int* index = NULL, bool* finished = NULL);
+
     /**
      * Is the Task  running?
      *
@@ -416,21 +452,79 @@ namespace mn {
      * 
      */ 
     static bool is_current(basic_task* task) {
-      return basic_task::get_self()->m_pHandle == task->m_pHandle;
+      return xTaskGetCurrentTaskHandle() == task->m_pHandle;
     }
 
     /**
-     * Get the current task
+     * Get the current task, O(1) and without allocation over the thread local
+     * storage pointer MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX 
      * 
-     * @return The current task
+     * @return The basic_task object of the current task or NULL, when the current
+     * task was not created with basic_task
      */ 
     static basic_task* get_self();
+
+    /**
+     * A hook called with the handle of a basic_task that ends, i.e. to 
+     * release per task caches. The object must be alive until remove_exit_hook.
+     * The hook runs in the context of the ending task, it is not called for
+     * killed tasks.
+     */
+    struct exit_hook {
+      void (*func)(void* arg, xTaskHandle handle);
+      void* arg;
+      exit_hook* next;
+    };
+
+    /**
+     * Add a hook called on the end of all basic_task objects
+     */
+    static void add_exit_hook(exit_hook* hook);
+    /**
+     * Remove a hook, after the return the hook is not called anymore
+     */
+    static void remove_exit_hook(exit_hook* hook);
   protected:
     /**
      *  Adapter function that allows you to write a class
      *  specific on_task() function that interfaces with FreeRTOS.
      */
     static void runtaskstub(void* parm);
+  private:
+    /**
+     * The waiter of join_all and join_any, on the stack of the waiter
+     */
+    struct join_waiter {
+      xTaskHandle handle;
+      uint32_t signaled;
+    };
+
+    /**
+     * The shared wait of join_all and join_any
+     * @param waitAll true: wait for all tasks, false: for one task
+     */
+    static int join_many(basic_task* const* tasks, size_t count, unsigned int timeout,
+                         bool waitAll, bool* finished, int* index);
+
+    /**
+     * Has the task left on_task, but EventJoin is not yet set - the waiter
+     * of join_all and join_any is then already taken. Call with m_runningMutex
+     */
+    bool is_ending() {
+      return !m_bRunning && m_pHandle == NULL && (m_event.get() & EventStarted) != 0;
+    }
+
+    /**
+     * Call all exit hooks with the handle of the ending task
+     */
+    static void call_exit_hooks(xTaskHandle handle);
+    /**
+     * The lock of the exit hooks, a function static for the hooks of
+     * static objects
+     */
+    static mutex_t& exit_hook_mutex();
+
+    static exit_hook* m_pExitHooks;
   protected:
     /**
      * Lock Objekt for task safty
@@ -486,6 +580,24 @@ namespace mn {
      */ 
     event_group_t m_event;
 
+    /**
+     * The intrusive links of the basic_task_list, for the id and the name index.
+     * Only the list changes the links
+     */
+    basic_task* m_pListNext[2];
+    basic_task* m_pListPrev[2];
+    /**
+     * The id and the name hash, with them the task is in the list
+     */
+    int32_t m_iListId;
+    uint32_t m_uiListNameHash;
+    bool m_bInTaskList;
+
+    /**
+     * The waiter of join_all or join_any, the ending task wakes him
+     */
+    join_waiter* m_pJoinWaiter;
+
     #if( configSUPPORT_STATIC_ALLOCATION == 1 )
       StaticTask_t m_TaskBuffer;
       StackType_t  m_stackBuffer[MN_THREAD_CONFIG_STACK_DEPTH];
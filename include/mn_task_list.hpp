@@ -18,20 +18,29 @@
 #ifndef MINLIB_ESP32_THREAD_LIST_
 #define MINLIB_ESP32_THREAD_LIST_
 
-class basic_task;
+#include "mn_config.hpp"
 
-#include <list>
-#include <map>
+#include <string>
 
 namespace mn {
+    class basic_task;
     
     /**
-     * A simple task list 
+     * The task list, with a hash index by id and by name. 
+     * 
+     * The tasks are linked in the index with intrusive links in the basic_task, add 
+     * and remove are O(1) and allocate nothing. Add and remove are locked, the lookups 
+     * are lock free: a reader counts himself in the current read epoch, remove_task 
+     * waits until the readers of the epoch before are gone, then the removed task can 
+     * be deleted (RCU like).
      * 
      * @note If MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST activated then automatic added new basic_tasks 
      * to this list. On default is MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST deactivated  
      */ 
     class basic_task_list  {
+        static_assert((MN_THREAD_CONFIG_TASK_LIST_BUCKETS & (MN_THREAD_CONFIG_TASK_LIST_BUCKETS - 1)) == 0,
+            "MN_THREAD_CONFIG_TASK_LIST_BUCKETS must be a power of two");
+
         /**
          * Construtor
          * @note This is a signleton class, only one object 
@@ -47,15 +56,24 @@ namespace mn {
          * The static instance mutex
          */ 
         static mutex_t  m_staticInstanceMux;
+
+        /**
+         * The indexes of the list, the index of the links in the basic_task
+         */
+        enum index {
+            IndexId = 0,
+            IndexName = 1
+        };
     public:
         /**
-         * Add a task to list
+         * Add a task to list, a task in the list is added again
+         * with his new id (start a task again)
          * 
          * @param task The task to add
          */ 
         void add_task(basic_task* task);
         /**
-         * Remove a task from the list
+         * Remove a task from the list, after the return the task can be deleted
          * 
          * @param task The task to remove
          */ 
@@ -69,29 +87,38 @@ namespace mn {
          */ 
         basic_task* get_task(int id);
         /**
-         * Get a task from the list by name
+         * Get a task from the list by name, when more tasks have the name, then
+         * the last added
          * 
          * @param name The name to search 
          * @return The finded task, by name. NULL when not finded a task
          */  
-        basic_task* get_task(std::string name);
-    private:
+        basic_task* get_task(const char* name);
         /**
-         * Get a task from the list by id on a specific core
-         * 
-         * @param id The id to search 
-         * @param core The core
-         * @return The finded task, by id. NULL when not finded a task
-         */ 
-        basic_task* get_task(int core, int id);
+         * Get a task from the list by name
+         * @see get_task(const char*)
+         */
+        basic_task* get_task(std::string name) { return get_task(name.c_str()); }
+
         /**
-         * Get a task from the list by name on a specific core
-         * 
-         * @param name The name to search 
-         * @param core The core
-         * @return The finded task, by name. NULL when not finded a task
-         */ 
-        basic_task* get_task(int core, std::string name);
+         * Get the number of tasks in the list
+         */
+        uint32_t get_size() { return __atomic_load_n(&m_uiSize, __ATOMIC_RELAXED); }
+
+        /**
+         * Call fn(basic_task*) for each task in the list, lock free - do not add 
+         * or remove tasks in fn, the remove waits for the end of fn
+         */
+        template <class TFn>
+        void each_task(TFn fn) {
+            uint32_t _epoch = begin_read();
+
+            for(int i = 0; i < MN_THREAD_CONFIG_TASK_LIST_BUCKETS; i++) {
+                for(basic_task* _task = __atomic_load_n(&m_pBuckets[IndexId][i], __ATOMIC_SEQ_CST); _task != NULL; 
+                    _task = next(_task, IndexId)) fn(_task);
+            }
+            end_read(_epoch);
+        }
     public:
         /**
          * Get the singleton instance 
@@ -99,22 +126,64 @@ namespace mn {
          */ 
         static basic_task_list& instance() {
             automutx_t lock(m_staticInstanceMux);
-            if(m_pInstance != NULL) 
+            if(m_pInstance == NULL) 
                 m_pInstance = new basic_task_list();
             return *m_pInstance;
         }
     private:
         /**
-         * Lock Object for this 
+         * Enter a lock free read, returns the read epoch
+         */
+        uint32_t begin_read();
+        /**
+         * Leave a lock free read
+         */
+        void end_read(uint32_t epoch);
+        /**
+         * Wait until all readers in the list before are gone
+         */
+        void synchronize();
+
+        /**
+         * Get the next task in a bucket
+         */
+        basic_task* next(basic_task* task, int idx);
+        /**
+         * Link the task to the front of the bucket of the index
+         */
+        void link(basic_task* task, int idx, uint32_t bucket);
+        /**
+         * Unlink the task from the bucket of the index
+         */
+        void unlink(basic_task* task, int idx, uint32_t bucket);
+        /**
+         * Unlink the task from both indexes, locked
+         */
+        void unlink_task(basic_task* task);
+
+        /**
+         * The hash of a task name (FNV-1a)
+         */
+        static uint32_t hash_name(const char* name);
+        static uint32_t bucket_of(uint32_t hash) { return hash & (MN_THREAD_CONFIG_TASK_LIST_BUCKETS - 1); }
+    private:
+        /**
+         * Lock Object for add and remove
          */ 
         LockType_t               m_pLock;
         /**
-         * The map for this Task list holder
+         * The buckets of the id and the name index
          */ 
-        std::map<int, std::list<basic_task*> > m_mapTaskOnCore; 
+        basic_task* m_pBuckets[2][MN_THREAD_CONFIG_TASK_LIST_BUCKETS];
+        /**
+         * The read epoch and the readers in the odd and even epochs
+         */
+        uint32_t m_uiEpoch;
+        uint32_t m_uiReaders[2];
+        uint32_t m_uiSize;
     };
 
     using task_list_t = basic_task_list;
 }
 
-#endif
\ No newline at end of file
+#endif
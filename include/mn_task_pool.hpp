@@ -0,0 +1,231 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_TASK_POOL_
+#define MINLIB_ESP32_TASK_POOL_
+
+#include "mn_config.hpp"
+
+#include <new>
+#include <vector>
+
+#include "mn_error.hpp"
+#include "mn_task.hpp"
+#include "mn_mutex.hpp"
+#include "mn_counting_semaphore.hpp"
+#include "mn_functional.hpp"
+#include "queue/mn_workqueue_item.hpp"
+
+namespace mn {
+    class basic_task_pool;
+
+    /**
+     * A task of a task pool. The task parks on his task notification, runs
+     * the handed work item and goes back to his sub pool
+     *
+     * @ingroup task
+     */
+    class basic_pooled_task : public basic_task {
+        friend class basic_task_pool;
+    public:
+        using fn_block_t = aligned_storage_t<MN_THREAD_CONFIG_TASKPOOL_FN_SIZE, alignof(::max_align_t)>;
+
+        basic_pooled_task(const char* strName, basic_task::priority uiPriority,
+                          unsigned short usStackDepth, basic_task_pool* pool, int iSubPool);
+
+        /**
+         * Get the number of the run items of this task
+         */
+        uint32_t get_num_runs() { return m_uiNumRuns; }
+        /**
+         * Get the index of the sub pool of this task
+         */
+        int get_sub_pool() const { return m_iSubPool; }
+    protected:
+        virtual void* on_task() override;
+    private:
+        /**
+         * Hand a item to the parked task and wake it
+         */
+        void hand(queue::work_queue_item_t* item);
+        /**
+         * Stop the parked task, the next wake ends the task
+         */
+        void stop();
+    private:
+        basic_task_pool* m_pPool;
+        int m_iSubPool;
+        queue::work_queue_item_t* volatile m_pItem;
+        volatile bool m_bStop;
+        uint32_t m_uiNumRuns;
+        /**
+         * The next idle task in the sub pool
+         */
+        basic_pooled_task* m_pNextIdle;
+        /**
+         * The item of run_fn with the callable, in place
+         */
+        fn_block_t m_fnBlock;
+    };
+
+    /**
+     * A pool of started tasks, that runs work items and callables. The tasks
+     * are created once and park on a task notification - a run is a
+     * notification round trip, not a task create and delete.
+     *
+     * The pool has a sub pool for each core, the tasks of a sub pool are
+     * pinned to the core, and one sub pool of not pinned tasks. The
+     * iCore argument of run selects the sub pool, MN_THREAD_CONFIG_CORE_IFNO
+     * takes a not pinned task or any idle pinned task.
+     *
+     * @code
+     *  basic_task_pool pool;
+     *  pool.create(2, 2);      // two tasks on each core, two not pinned
+     *
+     *  promise_t<int> result;
+     *  pool.run_fn([&result]() { result.set_value(handle_request()); }, 1);
+     *  int value = result.get_future().get();
+     * @endcode
+     *
+     * @ingroup task
+     */
+    class basic_task_pool {
+        friend class basic_pooled_task;
+    public:
+        /**
+         * @param uiPriority The priority of the tasks
+         * @param usStackDepth The stack depth of the tasks
+         */
+        explicit basic_task_pool(basic_task::priority uiPriority = basic_task::PriorityNormal,
+                                 unsigned short usStackDepth = MN_THREAD_CONFIG_TASKPOOL_STACKSIZE);
+        /**
+         * Stop and delete all tasks
+         */
+        ~basic_task_pool();
+
+        basic_task_pool(const basic_task_pool&) = delete;
+        basic_task_pool& operator = (const basic_task_pool&) = delete;
+
+        /**
+         * Create the sub pools and start the tasks
+         *
+         * @param uiPerCore How many tasks pinned to each core
+         * @param uiUnpinned How many not pinned tasks
+         * @return
+         *  - ERR_TASKPOOL_OK The tasks are started
+         *  - ERR_TASKPOOL_CREATE A task can not start, the pool is destroyed
+         */
+        int create(uint32_t uiPerCore, uint32_t uiUnpinned);
+
+        /**
+         * Stop all tasks and wait for their end, a running item is finished.
+         * Call not while other tasks call run
+         */
+        void destroy();
+
+        /**
+         * Run a work item on a idle task of the pool. A can_delete item is
+         * released after the run
+         *
+         * @param item The item to run
+         * @param iCore The core or MN_THREAD_CONFIG_CORE_IFNO
+         * @param timeout How long to wait for a idle task
+         * @return
+         *  - ERR_TASKPOOL_OK The item runs
+         *  - ERR_TASKPOOL_EMPTY No idle task after the timeout
+         *  - ERR_TASKPOOL_CORE No sub pool for the core
+         *  - ERR_TASKPOOL_NOTCREATED The pool is not created
+         */
+        int run(queue::work_queue_item_t* item, int iCore = MN_THREAD_CONFIG_CORE_IFNO,
+                unsigned int timeout = portMAX_DELAY);
+
+        /**
+         * Run a callable on a idle task of the pool, the callable is stored
+         * in the task - no heap allocation
+         *
+         * @param fn The callable, returns void or bool
+         * @see run
+         */
+        template <class TFn>
+        int run_fn(TFn fn, int iCore = MN_THREAD_CONFIG_CORE_IFNO, unsigned int timeout = portMAX_DELAY) {
+            using item_type = queue::work_queue_fn_item<TFn>;
+            static_assert(sizeof(item_type) <= sizeof(basic_pooled_task::fn_block_t),
+                "callable too big for the task, raise MN_THREAD_CONFIG_TASKPOOL_FN_SIZE");
+
+            basic_pooled_task* _task = NULL;
+            int ret = acquire(iCore, timeout, &_task);
+            if(ret != ERR_TASKPOOL_OK) return ret;
+
+            _task->hand(new (&_task->m_fnBlock) item_type(mn::move(fn)));
+            return ERR_TASKPOOL_OK;
+        }
+
+        /**
+         * Get the number of tasks in the pool
+         */
+        uint32_t get_size() const { return m_vTasks.size(); }
+        /**
+         * Get the number of idle tasks in the sub pool of the core
+         * @param iCore The core or MN_THREAD_CONFIG_CORE_IFNO for the not pinned tasks
+         */
+        uint32_t get_idle(int iCore = MN_THREAD_CONFIG_CORE_IFNO);
+        /**
+         * Is the pool created
+         */
+        bool is_created() const { return !m_vSubPools.empty(); }
+    protected:
+        /**
+         * The idle tasks of one core
+         */
+        struct sub_pool {
+            sub_pool(int count) : idle(0, (count > 0) ? count : 1), head(NULL) { }
+
+            counting_semaphore_t idle;
+            mutex_t lock;
+            basic_pooled_task* head;
+        };
+
+        /**
+         * Take a idle task
+         */
+        int acquire(int iCore, unsigned int timeout, basic_pooled_task** task);
+        /**
+         * Take a task from the sub pool, the idle count is taken
+         */
+        basic_pooled_task* pop(sub_pool* pool);
+        /**
+         * Called from the task after the run, back to his sub pool
+         */
+        void park(basic_pooled_task* task);
+        /**
+         * The index of the sub pool for the core
+         */
+        int sub_pool_index(int iCore) const;
+    private:
+        basic_task::priority m_uiPriority;
+        unsigned short m_usStackDepth;
+        /**
+         * The sub pools: one for each core and the last for the not pinned tasks
+         */
+        std::vector<sub_pool*> m_vSubPools;
+        std::vector<basic_pooled_task*> m_vTasks;
+    };
+
+    using task_pool_t = basic_task_pool;
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_TASK_STATS_
+#define MINLIB_ESP32_TASK_STATS_
+
+#include "mn_config.hpp"
+
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "mn_error.hpp"
+#include "mn_task.hpp"
+
+namespace mn {
+    /**
+     * The runtime statistics of one task. Not all values are available on
+     * all ports, the flags say which values are set:
+     *  - the run time needs configGENERATE_RUN_TIME_STATS and
+     *    configUSE_TRACE_FACILITY (on the host the cpu time of the thread)
+     *  - the task switches and the blocked times are counted only by the
+     *    host port, the FreeRTOS kernel has no such counters
+     *  - the stack high water mark is not measurable on the host
+     *
+     * @ingroup task
+     */
+    struct task_stats {
+        /**
+         * The available values
+         */
+        enum flags {
+            HasRunTime = 1 << 0,     /*!< run_time and utilization */
+            HasSwitches = 1 << 1,    /*!< switches */
+            HasBlocked = 1 << 2,     /*!< blocked_us */
+            HasStack = 1 << 3        /*!< stack_free_min */
+        };
+        /**
+         * Why the task was blocked, the index of blocked_us
+         */
+        enum block_reason {
+            BlockDelay = 0,          /*!< vTaskDelay, vTaskDelayUntil */
+            BlockQueue,              /*!< queues and all semaphore types */
+            BlockNotify,             /*!< task notifications */
+            BlockEvent,              /*!< event groups */
+            BlockSuspend,            /*!< vTaskSuspend */
+            BlockMax
+        };
+
+        xTaskHandle handle;
+        /** The id of the basic_task or -1 */
+        int32_t id;
+        char name[MN_THREAD_CONFIG_STATIC_TASK_NAME_LEN];
+        /** The core of the task or MN_THREAD_CONFIG_CORE_IFNO */
+        int core;
+        uint32_t priority;
+        basic_task::state state;
+
+        /** The run time counter of the task, micro seconds on the host and with the esp_timer clock.
+         *  On the target the counter is 32 bit (ulRunTimeCounter) and wraps */
+        uint64_t run_time;
+        /** The share of the run time on one core in 1/100 percent - since the start (until the first 
+         *  wrap of the counter) or in the snapshot interval */
+        uint32_t utilization;
+        /** How often the task was blocked */
+        uint32_t switches;
+        /** The blocked time per block_reason in micro seconds */
+        uint64_t blocked_us[BlockMax];
+
+        /** The stack depth of the basic_task, 0 for other tasks */
+        uint32_t stack_depth;
+        /** The minimum of the free stack since the start (the high water mark) */
+        uint32_t stack_free_min;
+
+        uint32_t flags;
+
+        bool has(uint32_t flag) const { return (flags & flag) == flag; }
+        /**
+         * Get the max used stack, 0 when unknown
+         */
+        uint32_t get_stack_used() const {
+            return (has(HasStack) && stack_depth > stack_free_min) ? stack_depth - stack_free_min : 0;
+        }
+    };
+
+    /**
+     * Get the total run time counter, the base of the utilization. On the target 
+     * the counter is cut to the width of the task run time (32 bit), so both 
+     * wrap together
+     * @return The counter or 0 without configGENERATE_RUN_TIME_STATS
+     */
+    uint64_t get_run_time_counter();
+
+    /**
+     * Get the statistics of a running basic_task
+     *
+     * @return
+     *  - ERR_TASK_OK The stats are set
+     *  - ERR_TASK_NOTRUNNING The task is not running
+     */
+    int get_task_stats(basic_task* task, task_stats& stats);
+
+    /**
+     * Get the statistics of a FreeRTOS task, the task must be alive
+     * @see get_task_stats
+     */
+    int get_task_stats(xTaskHandle handle, task_stats& stats);
+
+    /**
+     * A snapshot of the statistics of many tasks. Take a snapshot again and
+     * again (i.e. from a monitor task each second), the utilization is then
+     * the share of the run time between the last two snapshots. After the
+     * first snapshots the buffers are allocated and a take allocates
+     * nothing. The 32 bit run time counter of the target wraps (after about
+     * 71 minutes with a micro second clock), take the snapshots more often.
+     *
+     * @code
+     *  basic_task_snapshot snapshot;
+     *  while(true) {
+     *      snapshot.take();
+     *      for(size_t i = 0; i < snapshot.size(); i++)
+     *          if(snapshot[i].utilization > 5000) report_busy(snapshot[i]);
+     *      mn::delay(1000);
+     *  }
+     * @endcode
+     *
+     * @ingroup task
+     */
+    class basic_task_snapshot {
+    public:
+        basic_task_snapshot() : m_uiLastTotal(0), m_uiInterval(0) { }
+
+        /**
+         * Take the stats of all tasks in the basic_task_list, the tasks
+         * are only in the list with MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST
+         *
+         * @return The number of tasks in the snapshot
+         */
+        size_t take();
+        /**
+         * Take the stats of the given tasks, not running tasks are skipped
+         *
+         * @return The number of tasks in the snapshot
+         */
+        size_t take(basic_task* const* tasks, size_t count);
+
+        /**
+         * Get the number of tasks in the snapshot
+         */
+        size_t size() const { return m_vStats.size(); }
+        /**
+         * Get the stats of a task in the snapshot
+         */
+        const task_stats& operator [] (size_t index) const { return m_vStats[index]; }
+        /**
+         * Find the stats of a basic_task by id
+         * @return The stats or NULL
+         */
+        const task_stats* find(int32_t id) const;
+
+        /**
+         * Get the run time counter between the last two snapshots, 0 after the first
+         */
+        uint64_t get_interval() const { return m_uiInterval; }
+    private:
+        void begin();
+        void add(basic_task* task);
+        void end();
+    private:
+        /**
+         * The run time of each task in the last snapshot
+         */
+        struct last_run {
+            xTaskHandle handle;
+            uint64_t run_time;
+        };
+
+        std::vector<task_stats> m_vStats;
+        std::vector<last_run> m_vLast;
+        uint64_t m_uiLastTotal;
+        uint64_t m_uiInterval;
+    };
+
+    using task_snapshot_t = basic_task_snapshot;
+}
+
+#endif
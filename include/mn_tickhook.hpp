@@ -87,14 +87,14 @@ namespace mn {
         /**
          *  Remove an item from the front of the queue.
          *
-         *  @param item Where the item you are removing will be returned to.
+         *  @param entry Where the entry you are removing will be returned to.
          *  @param timeout How long to wait to remove an item to the queue.
          *  @return  - 'ERR_QUEUE_OK' the item was removed 
          *           - 'ERR_QUEUE_REMOVE' on an error
          *           - 'ERR_QUEUE_NOTCREATED' when the queue not created
          *           - 'ERR_TIMEOUT' TimeOut
          */
-        int dequeue(base_tickhook_entry* entry,
+        int dequeue(base_tickhook_entry** entry,
             unsigned int timeout = (unsigned int) 0xffffffffUL);
         /**
          * Clear the list
@@ -0,0 +1,419 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef _MINLIB_PORT_POSIX_H_
+#define _MINLIB_PORT_POSIX_H_
+
+/**
+ * Host port for MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX.
+ *
+ * This header provides the subset of the FreeRTOS / ESP-IDF API that the library
+ * uses, implemented on pthreads (src/port/mn_port_posix.cpp). Every task is a real
+ * pthread, so the library runs truly parallel on a multi-core linux host.
+ * Add include/port/posix to the include path, then the normal
+ * "freertos/FreeRTOS.h" includes resolve to this header.
+ *
+ * Differences to a real FreeRTOS kernel:
+ *  - there is no interrupt context, xPortInIsrContext() is always pdFALSE
+ *  - priorities are stored and reported, but the linux scheduler decides
+ *  - vTaskDelete() and vTaskSuspend() on a other task take effect at the
+ *    next blocking call of that task (delay, queue, semaphore, notify ...)
+ *  - critical sections, interrupt and schedular locks are process wide
+ *    recursive locks, they exclude only other critical sections
+ *
+ * @ingroup port
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+//Config section - can override
+//==================================
+#ifndef configTICK_RATE_HZ
+    #define configTICK_RATE_HZ                          1000
+#endif
+#ifndef configMAX_PRIORITIES
+    #define configMAX_PRIORITIES                        25
+#endif
+#ifndef configMINIMAL_STACK_SIZE
+    #define configMINIMAL_STACK_SIZE                    768
+#endif
+#ifndef configNUM_THREAD_LOCAL_STORAGE_POINTERS
+    #define configNUM_THREAD_LOCAL_STORAGE_POINTERS     5
+#endif
+#ifndef configUSE_TRACE_FACILITY
+    #define configUSE_TRACE_FACILITY                    1
+#endif
+#ifndef configGENERATE_RUN_TIME_STATS
+    /**
+     * The run time counter of a host task is the cpu time of his thread in
+     * micro seconds, the total run time is mn_port_micros
+     */
+    #define configGENERATE_RUN_TIME_STATS               1
+#endif
+#ifndef INCLUDE_uxTaskGetStackHighWaterMark
+    #define INCLUDE_uxTaskGetStackHighWaterMark         1
+#endif
+#ifndef configTIMER_TASK_PRIORITY
+    #define configTIMER_TASK_PRIORITY                   1
+#endif
+#ifndef configUSE_TICK_HOOK
+    /**
+     * When 1 then a host task calls vApplicationTickHook every tick,
+     * the task start with the first created task
+     */
+    #define configUSE_TICK_HOOK                         0
+#endif
+#ifndef configASSERT
+    #define configASSERT(x)                             assert(x)
+#endif
+
+#ifndef MN_PORT_POSIX_MIN_STACK_SIZE
+    /**
+     * The minimal stack size in bytes for a host task. The stack depth from
+     * the application is mesured for the esp32, on a 64 bit host
+     * with libc calls we need more.
+     */
+    #define MN_PORT_POSIX_MIN_STACK_SIZE                (256 * 1024)
+#endif
+
+/** Not supported on the host port */
+#define configSUPPORT_STATIC_ALLOCATION                 0
+#define configSUPPORT_DYNAMIC_ALLOCATION                1
+#define configUSE_RECURSIVE_MUTEXES                     1
+#define configUSE_16_BIT_TICKS                          0
+#define configQUEUE_REGISTRY_SIZE                       0
+
+//Types
+//==================================
+typedef int32_t     BaseType_t;
+typedef uint32_t    UBaseType_t;
+typedef uint32_t    TickType_t;
+typedef uint32_t    EventBits_t;
+typedef uint8_t     StackType_t;
+
+/** The handles are opaque pointers, like the esp-idf FreeRTOS */
+typedef void*       TaskHandle_t;
+typedef void*       QueueHandle_t;
+typedef void*       SemaphoreHandle_t;
+typedef void*       EventGroupHandle_t;
+typedef void*       TimerHandle_t;
+
+typedef TaskHandle_t        xTaskHandle;
+typedef QueueHandle_t       xQueueHandle;
+typedef SemaphoreHandle_t   xSemaphoreHandle;
+typedef TimerHandle_t       xTimerHandle;
+
+typedef void (*TaskFunction_t)( void * );
+typedef void (*TimerCallbackFunction_t)( TimerHandle_t xTimer );
+typedef void (*PendedFunction_t)( void *, uint32_t );
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+/**
+ * Why a host task was blocked, for mn_port_get_task_trace
+ */
+enum mn_port_block_reason {
+    MN_PORT_BLOCK_DELAY = 0,        /*!< vTaskDelay, vTaskDelayUntil */
+    MN_PORT_BLOCK_QUEUE,            /*!< queues and all semaphore types */
+    MN_PORT_BLOCK_NOTIFY,           /*!< task notifications */
+    MN_PORT_BLOCK_EVENT,            /*!< event groups */
+    MN_PORT_BLOCK_SUSPEND,          /*!< vTaskSuspend */
+    MN_PORT_BLOCK_MAX
+};
+
+typedef enum {
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+/**
+ * The task status of vTaskGetInfo, like the esp-idf FreeRTOS
+ */
+typedef struct {
+    TaskHandle_t    xHandle;
+    const char*     pcTaskName;
+    UBaseType_t     xTaskNumber;
+    eTaskState      eCurrentState;
+    UBaseType_t     uxCurrentPriority;
+    UBaseType_t     uxBasePriority;
+    uint32_t        ulRunTimeCounter;
+    StackType_t*    pxStackBase;
+    uint32_t        usStackHighWaterMark;
+    BaseType_t      xCoreID;
+} TaskStatus_t;
+
+/**
+ * The blocking statistics of a host task, the kernel has no such counters
+ */
+typedef struct {
+    /** The cpu time of the task in micro seconds */
+    uint64_t        runTimeUs;
+    /** How often the task was blocked - the task switches away from the task */
+    uint32_t        switches;
+    /** The blocked time per mn_port_block_reason in micro seconds */
+    uint64_t        blockedUs[MN_PORT_BLOCK_MAX];
+} mn_port_task_trace;
+
+/**
+ * A recursive spinlock, the host version of the esp32 portMUX
+ */
+typedef struct {
+    volatile uintptr_t owner;
+    volatile uint32_t  count;
+} portMUX_TYPE;
+
+//Constants
+//==================================
+#define pdFALSE                     ( ( BaseType_t ) 0 )
+#define pdTRUE                      ( ( BaseType_t ) 1 )
+#define pdPASS                      ( pdTRUE )
+#define pdFAIL                      ( pdFALSE )
+#define errQUEUE_EMPTY              ( ( BaseType_t ) 0 )
+#define errQUEUE_FULL               ( ( BaseType_t ) 0 )
+
+#define portMAX_DELAY               ( TickType_t ) 0xffffffffUL
+#define portTICK_PERIOD_MS          ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portTICK_RATE_MS            portTICK_PERIOD_MS
+#define pdMS_TO_TICKS( xTimeInMs )  ( ( TickType_t ) ( ( ( TickType_t ) ( xTimeInMs ) * ( TickType_t ) configTICK_RATE_HZ ) / ( TickType_t ) 1000 ) )
+
+#define portNUM_PROCESSORS          ( mn_port_num_processors() )
+#define tskNO_AFFINITY              ( 0x7FFFFFFF )
+#define tskIDLE_PRIORITY            ( ( UBaseType_t ) 0U )
+
+#define portMUX_FREE_VAL            0
+#define portMUX_NO_TIMEOUT          ( -1 )
+#define portMUX_TRY_LOCK            0
+#define portMUX_INITIALIZER_UNLOCKED { portMUX_FREE_VAL, 0 }
+
+#define IRAM_ATTR
+
+//Port section
+//==================================
+/** @return The number of online cores of the host */
+BaseType_t  mn_port_num_processors();
+/** @return The monotonic time in micro seconds since the first call */
+uint64_t    mn_port_micros();
+/**
+ * Get the blocking statistics of a task
+ * @param xTask The task or NULL for the calling task
+ * @return pdPASS or pdFAIL when the task is not running
+ */
+BaseType_t  mn_port_get_task_trace(TaskHandle_t xTask, mn_port_task_trace* pxTrace);
+
+#define portGET_RUN_TIME_COUNTER_VALUE()    ( (uint32_t)mn_port_micros() )
+
+void        vPortCPUInitializeMutex(portMUX_TYPE *mux);
+bool        vPortCPUAcquireMutexTimeout(portMUX_TYPE *mux, int timeout_cycles);
+void        vPortCPUReleaseMutex(portMUX_TYPE *mux);
+
+void        mn_port_enter_critical(portMUX_TYPE *mux);
+void        mn_port_exit_critical(portMUX_TYPE *mux);
+uint32_t    mn_port_enter_critical_nested();
+void        mn_port_exit_critical_nested(uint32_t state);
+
+#define portENTER_CRITICAL(mux)             mn_port_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)              mn_port_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux)         mn_port_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux)          mn_port_exit_critical(mux)
+#define portENTER_CRITICAL_SAFE(mux)        mn_port_enter_critical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)         mn_port_exit_critical(mux)
+#define taskENTER_CRITICAL(mux)             mn_port_enter_critical(mux)
+#define taskEXIT_CRITICAL(mux)              mn_port_exit_critical(mux)
+#define portENTER_CRITICAL_NESTED()         mn_port_enter_critical_nested()
+#define portEXIT_CRITICAL_NESTED(state)     mn_port_exit_critical_nested(state)
+#define taskDISABLE_INTERRUPTS()            ((void)mn_port_enter_critical_nested())
+#define taskENABLE_INTERRUPTS()             mn_port_exit_critical_nested(1)
+
+/** There is no interrupt context on the host */
+#define xPortInIsrContext()                 ( pdFALSE )
+#define xPortGetCoreID()                    ( mn_port_get_core_id() )
+#define _frxt_setup_switch()                taskYIELD()
+#define portYIELD_FROM_ISR()                taskYIELD()
+#define vPortYieldOtherCore(core)           ((void)(core))
+
+BaseType_t  mn_port_get_core_id();
+BaseType_t  xPortStartScheduler();
+void        vPortEndScheduler();
+
+#if ( configUSE_TICK_HOOK == 1 )
+extern "C" void vApplicationTickHook(void);
+#endif
+
+//Task section
+//==================================
+BaseType_t  xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char * const pcName,
+                const uint32_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority,
+                TaskHandle_t * const pvCreatedTask, const BaseType_t xCoreID);
+BaseType_t  xTaskCreate(TaskFunction_t pvTaskCode, const char * const pcName,
+                const uint32_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority,
+                TaskHandle_t * const pvCreatedTask);
+void        vTaskDelete(TaskHandle_t xTaskToDelete);
+void        vTaskDelay(const TickType_t xTicksToDelay);
+void        vTaskDelayUntil(TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement);
+void        vTaskSuspend(TaskHandle_t xTaskToSuspend);
+void        vTaskResume(TaskHandle_t xTaskToResume);
+BaseType_t  xTaskResumeFromISR(TaskHandle_t xTaskToResume);
+void        vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask);
+UBaseType_t uxTaskPriorityGetFromISR(TaskHandle_t xTask);
+eTaskState  eTaskGetState(TaskHandle_t xTask);
+BaseType_t  xTaskGetAffinity(TaskHandle_t xTask);
+UBaseType_t uxTaskGetNumberOfTasks();
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask);
+void        vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t *pxTaskStatus,
+                BaseType_t xGetFreeStackSpace, eTaskState eState);
+/** The host can not measure the stack, returns the stack depth of the task */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+char*       pcTaskGetTaskName(TaskHandle_t xTaskToQuery);
+TickType_t  xTaskGetTickCount();
+TickType_t  xTaskGetTickCountFromISR();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TaskHandle_t xTaskGetIdleTaskHandle();
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t cpuid);
+void        vTaskStartScheduler();
+void        vTaskEndScheduler();
+void        vTaskSuspendAll();
+BaseType_t  xTaskResumeAll();
+void        taskYIELD();
+
+BaseType_t  xTaskGenericNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                eNotifyAction eAction, uint32_t *pulPreviousNotificationValue);
+BaseType_t  xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                uint32_t *pulNotificationValue, TickType_t xTicksToWait);
+uint32_t    ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+BaseType_t  xTaskNotifyStateClear(TaskHandle_t xTask);
+
+#define xTaskNotify( xTaskToNotify, ulValue, eAction ) \
+    xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) \
+    xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL ) )
+#define xTaskNotifyGive( xTaskToNotify ) \
+    xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement, NULL )
+#define vTaskNotifyGiveFromISR( xTaskToNotify, pxHigherPriorityTaskWoken ) \
+    ((void)(pxHigherPriorityTaskWoken), (void)xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement, NULL ))
+
+void        vTaskSetThreadLocalStoragePointer(TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue);
+void*       pvTaskGetThreadLocalStoragePointer(TaskHandle_t xTaskToQuery, BaseType_t xIndex);
+
+//Queue and semaphore section
+//==================================
+QueueHandle_t   xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+void            vQueueDelete(QueueHandle_t xQueue);
+BaseType_t      xQueueSendToBack(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t      xQueueSendToFront(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t      xQueueOverwrite(QueueHandle_t xQueue, const void * const pvItemToQueue);
+BaseType_t      xQueueReceive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait);
+BaseType_t      xQueuePeek(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait);
+BaseType_t      xQueueReset(QueueHandle_t xQueue);
+UBaseType_t     uxQueueMessagesWaiting(const QueueHandle_t xQueue);
+UBaseType_t     uxQueueSpacesAvailable(const QueueHandle_t xQueue);
+
+#define xQueueSend( xQueue, pvItemToQueue, xTicksToWait )   xQueueSendToBack( ( xQueue ), ( pvItemToQueue ), ( xTicksToWait ) )
+#define xQueueSendToBackFromISR( xQueue, pvItemToQueue, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xQueueSendToBack( ( xQueue ), ( pvItemToQueue ), 0 ) )
+#define xQueueSendToFrontFromISR( xQueue, pvItemToQueue, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xQueueSendToFront( ( xQueue ), ( pvItemToQueue ), 0 ) )
+#define xQueueOverwriteFromISR( xQueue, pvItemToQueue, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xQueueOverwrite( ( xQueue ), ( pvItemToQueue ) ) )
+#define xQueueReceiveFromISR( xQueue, pvBuffer, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xQueueReceive( ( xQueue ), ( pvBuffer ), 0 ) )
+#define xQueuePeekFromISR( xQueue, pvBuffer ) \
+    xQueuePeek( ( xQueue ), ( pvBuffer ), 0 )
+#define vQueueAddToRegistry( xQueue, pcName ) \
+    ((void)(xQueue), (void)(pcName))
+
+SemaphoreHandle_t   xSemaphoreCreateMutex();
+SemaphoreHandle_t   xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t   xSemaphoreCreateBinary();
+SemaphoreHandle_t   xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+BaseType_t          xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait);
+BaseType_t          xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t          xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xTicksToWait);
+BaseType_t          xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex);
+UBaseType_t         uxSemaphoreGetCount(SemaphoreHandle_t xSemaphore);
+TaskHandle_t        xSemaphoreGetMutexHolder(SemaphoreHandle_t xSemaphore);
+
+#define vSemaphoreDelete( xSemaphore )      vQueueDelete( ( xSemaphore ) )
+#define xSemaphoreTakeFromISR( xSemaphore, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xSemaphoreTake( ( xSemaphore ), 0 ) )
+#define xSemaphoreGiveFromISR( xSemaphore, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xSemaphoreGive( ( xSemaphore ) ) )
+#define xSemaphoreTakeRecursiveFromISR( xMutex, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xSemaphoreTakeRecursive( ( xMutex ), 0 ) )
+#define xSemaphoreGiveRecursiveFromISR( xMutex, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xSemaphoreGiveRecursive( ( xMutex ) ) )
+
+//Event group section
+//==================================
+EventGroupHandle_t  xEventGroupCreate();
+void                vEventGroupDelete(EventGroupHandle_t xEventGroup);
+EventBits_t         xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                        const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait);
+EventBits_t         xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet);
+EventBits_t         xEventGroupClearBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear);
+EventBits_t         xEventGroupGetBits(EventGroupHandle_t xEventGroup);
+EventBits_t         xEventGroupSync(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet,
+                        const EventBits_t uxBitsToWaitFor, TickType_t xTicksToWait);
+
+#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xEventGroupSetBits( ( xEventGroup ), ( uxBitsToSet ) ) )
+#define xEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear ) \
+    xEventGroupClearBits( ( xEventGroup ), ( uxBitsToClear ) )
+#define xEventGroupGetBitsFromISR( xEventGroup ) \
+    xEventGroupGetBits( ( xEventGroup ) )
+
+//Timer section
+//==================================
+TimerHandle_t   xTimerCreate(const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+                    const UBaseType_t uxAutoReload, void * const pvTimerID, TimerCallbackFunction_t pxCallbackFunction);
+BaseType_t      xTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t      xTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t      xTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t      xTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t      xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait);
+BaseType_t      xTimerIsTimerActive(TimerHandle_t xTimer);
+void*           pvTimerGetTimerID(const TimerHandle_t xTimer);
+void            vTimerSetTimerID(TimerHandle_t xTimer, void *pvNewID);
+BaseType_t      xTimerPendFunctionCall(PendedFunction_t xFunctionToPend, void *pvParameter1,
+                    uint32_t ulParameter2, TickType_t xTicksToWait);
+
+#define xTimerStartFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTimerStart( ( xTimer ), 0 ) )
+#define xTimerStopFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTimerStop( ( xTimer ), 0 ) )
+#define xTimerResetFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTimerReset( ( xTimer ), 0 ) )
+#define xTimerChangePeriodFromISR( xTimer, xNewPeriod, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTimerChangePeriod( ( xTimer ), ( xNewPeriod ), 0 ) )
+#define xTimerPendFunctionCallFromISR( xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken ) \
+    ( ((void)(pxHigherPriorityTaskWoken)), xTimerPendFunctionCall( ( xFunctionToPend ), ( pvParameter1 ), ( ulParameter2 ), 0 ) )
+
+#endif
@@ -19,12 +19,47 @@
 #ifndef MINLIB_ESP32_WORK_QUEUE_BASE_
 #define MINLIB_ESP32_WORK_QUEUE_BASE_
 
+#include "../mn_atomic.hpp"
+#include "../mn_micros.hpp"
 #include "mn_queue.hpp"
 #include "mn_workqueue_item.hpp"
 #include "mn_workqueue_task.hpp"
+#include "../memory/mn_basic_mempool_lockfree.hpp"
+#include <vector>
+#include <new>
 
 namespace mn {
     namespace queue {
+        template <class TItem> class work_queue_pooled_item;
+
+        /**
+         * A snapshot of a latency histogram of a work queue, the buckets are 
+         * log2 of the time in micros
+         *
+         * @ingroup queue
+         */
+        struct work_queue_histogram {
+            uint64_t count;     ///< How many times are recorded
+            uint64_t sum_us;    ///< The sum of all times
+            uint32_t max_us;    ///< The longest time
+            /**
+             * Bucket 0: under 1us, bucket n: 2^(n-1) to 2^n us, the last 
+             * bucket: all longer times
+             */
+            uint32_t buckets[MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS];
+
+            /**
+             * Get the average time in micros
+             */
+            uint32_t avg_us() const { return (count == 0) ? 0 : (uint32_t)(sum_us / count); }
+            /**
+             * Get the upper bound of the bucket with the given percentile
+             * @param uiPercent The percentile, 1 - 100 (i.e. 99)
+             * @return The time in micros, not over max_us
+             */
+            uint32_t percentile_us(uint32_t uiPercent) const;
+        };
+
         /**
          * This abstract class is the base "engine" class  for all work_queues.
          * basic_work_queue pull work_queue_item off of a FIFO queue and 
@@ -39,12 +74,25 @@ namespace mn {
          */
         class basic_work_queue {
             friend class work_queue_task;
+            template <class TItem> friend class work_queue_pooled_item;
         public:
+            /**
+             * One block of the item pool
+             */
+            using item_block_t = aligned_storage_t<MN_THREAD_CONFIG_WORKQUEUE_POOL_BLOCKSIZE, 
+                                                   alignof(::max_align_t)>;
+            /**
+             * The item pool for create_item and queue_fn
+             */
+            using item_pool_t = memory::basic_mempool_lockfree<item_block_t, 
+                                                   MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE>;
             /**
              * Our constructor.
              * @param Name Name of the task internal to the WorkQueue. 
              * @param uiPriority FreeRTOS priority of this WorkQueue task.
              * @param usStackDepth Number of "words" allocated for the WorkQueue task stack.
+             * @param uiMaxWorkItems Maximum number of items in the job queue, 0 for 
+             * engines with own queues (the job queue is then not created)
              */
             basic_work_queue(basic_task::priority uiPriority,
                             uint16_t usStackDepth,
@@ -85,6 +133,139 @@ namespace mn {
             virtual int queue(work_queue_item_t *work,
                             unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
 
+            /**
+             * Send many work_queue_item_t off to be executed. The items are linked
+             * to batches of MN_THREAD_CONFIG_WORKQUEUE_BATCH_SIZE items, each batch
+             * is one entry in the queue and one worker runs all items of the batch
+             * per wakeup.
+             *
+             * @param items Array of pointers to the work_queue_item_t.
+             * @param n Number of items in the array
+             * @param timeout How long to wait for each batch when the queue is full
+             * @param queued When not NULL: the number of queued items
+             * @note The items of a batch must not be in a other queue at the same time
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK All items are added 
+             *  - ERR_WORKQUEUE_ADD Not all items are added, the first not added
+             *    batch and the following are not queued
+             */ 
+            virtual int queue_bulk(work_queue_item_t **items, uint32_t n,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT,
+                            uint32_t* queued = NULL);
+
+            /**
+             * Send a work_queue_item_t off to be executed after a delay. The delayed 
+             * items are in a timer heap of this workqueue and the workers queue the 
+             * items, when the time is over - no timer object for each item.
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @param delay The delay in ticks
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added 
+             */ 
+            int queue_after(work_queue_item_t *work, unsigned int delay);
+
+            /**
+             * Send a work_queue_item_t off to be executed each period, the first 
+             * time after one period. When the item is at the next period not started
+             * the period is skipped. 
+             *
+             * @param work Pointer to a work_queue_item_t, can_delete must be false.
+             * @param period The period in ticks, must be greater then 0
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added 
+             *  - ERR_WORKQUEUE_ADD can_delete is true or the period is 0
+             */ 
+            int queue_every(work_queue_item_t *work, unsigned int period);
+
+            /**
+             * Remove a delayed or periodic item, a queued item is not removed
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The item is removed
+             *  - ERR_WORKQUEUE_NOTFOUND The item is not delayed or periodic
+             */ 
+            int cancel(work_queue_item_t *work);
+
+            /**
+             * How many items are delayed or periodic
+             */ 
+            uint32_t get_num_timers();
+
+            /**
+             * Create a work item in the item pool of this workqueue, the item 
+             * is constructed in place and can_delete is set - after the run the 
+             * block goes back to the pool. The pool is allocated on the first call 
+             * (returns NULL from a ISR), after this no heap is used.
+             * 
+             * @tparam TItem The type of the item, must fit in one block 
+             * (MN_THREAD_CONFIG_WORKQUEUE_POOL_BLOCKSIZE)
+             * @param args The arguments for the constructor of TItem
+             * @return The new item or NULL when the pool is empty
+             */ 
+            template <class TItem, typename... TArgs>
+            TItem* create_item(TArgs&&... args) {
+                using pooled_type = work_queue_pooled_item<TItem>;
+
+                static_assert(sizeof(pooled_type) <= sizeof(item_block_t), 
+                    "item too large for the item pool, see MN_THREAD_CONFIG_WORKQUEUE_POOL_BLOCKSIZE");
+                static_assert(alignof(pooled_type) <= alignof(item_block_t), "item too aligned");
+
+                void* _mem = alloc_block();
+                if(_mem == NULL) return NULL;
+
+                pooled_type* _item = new (_mem) pooled_type(this, mn::forward<TArgs>(args)...);
+                static_cast<work_queue_item*>(_item)->m_bCanDelete = true;
+
+                return _item;
+            }
+
+            /**
+             * Send a callable off to be executed, the callable is moved in a 
+             * work_queue_fn_item from the item pool - no heap allocation
+             * 
+             * @code
+             *  workqueue.queue_fn([this]() { return read_sensor(); });
+             * @endcode
+             *
+             * @param fn The callable, returns bool (the result of the item) or void
+             * @param timeout How long to wait when the queue is full
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The callable is added 
+             *  - ERR_WORKQUEUE_ADD The pool is empty or the queue is full
+             */ 
+            template <class TFn>
+            int queue_fn(TFn fn, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                work_queue_item_t* _item = create_item<work_queue_fn_item<TFn>>(mn::move(fn));
+                if(_item == NULL) return ERR_WORKQUEUE_ADD;
+
+                int ret = queue(_item, timeout);
+                if(ret != ERR_WORKQUEUE_OK) _item->release();
+
+                return ret;
+            }
+
+            /**
+             * How many items are free in the item pool
+             */ 
+            uint32_t get_pool_free();
+            /**
+             * How many items has the item pool
+             */ 
+            uint32_t get_pool_size();
+
+            /**
+             * Run one queued item in the calling task, for waiting on child 
+             * items without blocking a worker (i.e. parallel_for)
+             * 
+             * @return True when a item was run, false when no item is queued
+             */ 
+            virtual bool try_run_one();
+
             /**
              * Is the workqueue running?
              * 
@@ -95,14 +276,36 @@ namespace mn {
             /**
              * How many items / jobs are sucessfull worked
              */ 
-            uint8_t get_num_items_worked();
+            uint64_t get_num_items_worked();
             /**
              * How many items/jobs are not sucessfull worked
              */ 
-            uint8_t get_num_items_error();
+            uint64_t get_num_items_error();
+            /**
+             * How many items / jobs are queued or in work
+             */ 
+            uint32_t get_num_items_pending();
 
             /**
-             * Is the workqueue ready, all jobs/items are worked?
+             * Get the histogram of the queue wait time, the time from the queue
+             * to the start of on_work. Read without stopping the workers, the
+             * counts of a item in work can be missing
+             * 
+             * @return False when the stats are disabled (MN_THREAD_CONFIG_WORKQUEUE_STATS)
+             */ 
+            bool get_wait_histogram(work_queue_histogram& hist);
+            /**
+             * Get the histogram of the run time, the time of on_work
+             * @see get_wait_histogram
+             */ 
+            bool get_run_histogram(work_queue_histogram& hist);
+            /**
+             * Reset the counters and the histograms
+             */ 
+            virtual void reset_stats();
+
+            /**
+             * Is the workqueue ready, all queued jobs/items are worked?
              * 
              * @return true If workqueue is ready, false If not
              */ 
@@ -116,6 +319,105 @@ namespace mn {
              */ 
             virtual work_queue_item* get_next_item(unsigned int timeout);
 
+            /**
+             * Queue all due delayed and periodic items, called from the worker tasks 
+             * befor waiting for the next item 
+             * 
+             * @param timeout The max wait time of the worker
+             * @return The wait time for the worker, the timeout or the ticks 
+             * to the next due item
+             */ 
+            unsigned int service_timers(unsigned int timeout);
+
+            /**
+             * Wake a waiting worker, the next due item is changed. The default
+             * send a NULL item to the job queue
+             */ 
+            virtual void wake_for_timer();
+
+            /**
+             * Queue a due delayed item, called from service_timers with the
+             * timer lock. The default is queue with no wait
+             *
+             * @return ERR_WORKQUEUE_OK or ERR_WORKQUEUE_ADD, when the queue is full
+             */
+            virtual int queue_due(work_queue_item_t *work) { return queue(work, 0); }
+
+            /**
+             * Called from a worker task, when it found no item. A elastic engine 
+             * can end the worker here. The default ends no worker
+             * 
+             * @param worker The calling worker task
+             * @param idle The ticks since the last item of this worker
+             * @return True when the worker must end, the worker returns then from on_task 
+             */ 
+            virtual bool retire_worker(work_queue_task* worker, TickType_t idle) { 
+                (void)worker; (void)idle; return false; 
+            }
+
+            /**
+             * Run a item / job from the queue, called from the worker tasks 
+             * without any lock, so the workers run the items concurrently
+             * 
+             * @param item The item from get_next_item
+             */ 
+            virtual void run_item(work_queue_item* item);
+
+            /**
+             * Run all items of a batch (or a single item), called from the worker tasks
+             * @param item The first item of the batch
+             */ 
+            virtual void run_batch(work_queue_item* item);
+
+            /**
+             * Release the not run items of a batch (or a single item) on destroy, 
+             * the items are released like after a run, but not run
+             * @param item The first item of the batch
+             */ 
+            void release_batch(work_queue_item* item);
+
+            /**
+             * Unlink the next item of a batch 
+             * @return The next item of the batch or NULL
+             */ 
+            static work_queue_item* unlink_next(work_queue_item* item) {
+                work_queue_item* _next = item->m_pNextBatch;
+                item->m_pNextBatch = NULL;
+                return _next;
+            }
+            /**
+             * Link a item as the next item of a batch
+             */ 
+            static void link_next(work_queue_item* item, work_queue_item* next) {
+                item->m_pNextBatch = next;
+            }
+            /**
+             * Set the time in micros, when the item was queued
+             */ 
+            static void set_queued_time(work_queue_item* item, unsigned long ulTime) {
+                item->m_ulQueued = ulTime;
+            }
+            /**
+             * Set the queued time for the wait histogram, only with the stats
+             */ 
+            static void stamp_queued(work_queue_item* item) {
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS == MN_THREAD_CONFIG_YES
+                item->m_ulQueued = micros();
+#else
+                (void)item;
+#endif
+            }
+
+            /**
+             * Get a block from the item pool
+             * @return The block or NULL when the pool is empty
+             */ 
+            void* alloc_block();
+            /**
+             * Give a block back to the item pool, called from the released item
+             */ 
+            void free_block(void* block);
+
             /**
              * Implementation of your actual create code.
              * You must override this function.
@@ -142,7 +444,7 @@ namespace mn {
             mutex_t  m_ThreadStatus;
             /**
             * Lock Objekt for thread safty
-            * Mutex lock for the job queue
+            * Mutex lock for the engine creating, the job queue self is thread safe
             */ 
             mutex_t  m_ThreadJob;
             
@@ -153,16 +455,97 @@ namespace mn {
             /**
             * Holder of num works are successfull run
             */ 
-            volatile uint8_t m_uiNumWorks;
+            basic_atomic_gcc<uint64_t> m_uiNumWorks;
             /**
             * Holder of num works are not successfull run
             */ 
-            volatile uint8_t m_uiErrorsNumWorks;
+            basic_atomic_gcc<uint64_t> m_uiErrorsNumWorks;
+            /**
+            * Holder of num works are queued and not finished
+            */ 
+            atomic_uint32_t m_uiPending;
+            /**
+            * A delayed or periodic item in the timer heap
+            */ 
+            struct timer_entry {
+                TickType_t due;
+                unsigned int period;
+                work_queue_item_t* item;
+            };
+            /**
+            * The timer heap, the first entry is the next due item
+            */ 
+            std::vector<timer_entry> m_vTimers;
+            /**
+            * Lock for the timer heap
+            */ 
+            mutex_t  m_TimerLock;
+            /**
+            * Holder of the number of delayed and periodic items
+            */ 
+            atomic_uint32_t m_uiTimers;
+            /**
+            * A lock free latency histogram, the workers add and a other
+            * task reads without a lock
+            */ 
+            struct latency_histogram {
+                basic_atomic_gcc<uint32_t> buckets[MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS];
+                basic_atomic_gcc<uint64_t> count;
+                basic_atomic_gcc<uint64_t> sum;
+                basic_atomic_gcc<uint32_t> max;
+
+                latency_histogram() { reset(); }
+
+                void add(uint32_t us);
+                void get(work_queue_histogram& hist);
+                void reset();
+            };
+            /**
+            * The queue wait times
+            */ 
+            latency_histogram m_histWait;
+            /**
+            * The run times
+            */ 
+            latency_histogram m_histRun;
+            /**
+            * The item pool for create_item and queue_fn, allocated on the first use
+            */ 
+            item_pool_t* m_pItemPool;
             /**
             * Flag whether or not the workqueue was started.
             */ 
             volatile bool m_bRunning;
         };
+
+        /**
+         * A item from the item pool of a work queue, see 
+         * basic_work_queue::create_item. The release gives the block back
+         * to the pool of the owner work queue
+         * 
+         * @tparam TItem The type of the user item
+         * 
+         * @ingroup queue
+         */
+        template <class TItem>
+        class work_queue_pooled_item : public TItem {
+        public:
+            template <typename... TArgs>
+            work_queue_pooled_item(basic_work_queue* owner, TArgs&&... args)
+                : TItem(mn::forward<TArgs>(args)...), m_pOwner(owner) { }
+
+            virtual void release() override {
+                basic_work_queue* _owner = m_pOwner;
+
+                this->~work_queue_pooled_item();
+                _owner->free_block(this);
+            }
+        private:
+            /**
+             * The work queue of the pool
+             */
+            basic_work_queue* m_pOwner;
+        };
     }
 }
 
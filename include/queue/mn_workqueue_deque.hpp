@@ -0,0 +1,150 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_DEQUE_
+#define MINLIB_ESP32_WORK_QUEUE_DEQUE_
+
+#include <stdint.h>
+#include "../atomic/mn_atomic_gcc.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * A fixed size lock free Chase-Lev work stealing deque.
+         *
+         * Only the owner task call push and pop, at the bottom (LIFO), all other
+         * tasks can steal from the top (FIFO). The owner needs only a compare
+         * exchange when pop and steal race for the last item.
+         *
+         * The indices are 32 bit counters and wrap around, the size is the
+         * signed difference, the buffer does not grow - push returns false
+         * when the deque is full.
+         *
+         * @tparam TType The type of the elements, a pointer type
+         * @tparam nCapacity The capacity, must be a power of two
+         *
+         * @ingroup queue
+         */
+        template <typename TType, int nCapacity>
+        class basic_work_deque {
+            static_assert(nCapacity > 1 && (nCapacity & (nCapacity - 1)) == 0,
+                "nCapacity must be a power of two");
+
+            static constexpr uint32_t Mask = nCapacity - 1;
+        public:
+            using value_type = TType;
+            using self_type = basic_work_deque<TType, nCapacity>;
+
+            basic_work_deque() : m_top(0), m_bottom(0) {
+                for(int i = 0; i < nCapacity; i++)
+                    m_buffer[i].store(value_type(), memory_order::Relaxed);
+            }
+
+            basic_work_deque(const self_type&) = delete;
+            self_type& operator = (const self_type&) = delete;
+
+            /**
+             * Push a item to the bottom, only from the owner task
+             * @return True when the item is pushed, false when the deque is full
+             */
+            bool push(value_type item) {
+                uint32_t _b = m_bottom.load(memory_order::Relaxed);
+                uint32_t _t = m_top.load(memory_order::Acquire);
+
+                if( (int32_t)(_b - _t) >= nCapacity ) return false;
+
+                m_buffer[_b & Mask].store(item, memory_order::Relaxed);
+                atomic_thread_fence(memory_order::Release);
+                m_bottom.store(_b + 1, memory_order::Relaxed);
+
+                return true;
+            }
+
+            /**
+             * Pop the last pushed item from the bottom, only from the owner task
+             * @return The item or value_type() when the deque is empty
+             */
+            value_type pop() {
+                uint32_t _b = m_bottom.load(memory_order::Relaxed) - 1;
+                m_bottom.store(_b, memory_order::Relaxed);
+                atomic_thread_fence(memory_order::SeqCst);
+                uint32_t _t = m_top.load(memory_order::Relaxed);
+
+                int32_t _size = (int32_t)(_b - _t);
+
+                if(_size < 0) {
+                    m_bottom.store(_b + 1, memory_order::Relaxed);
+                    return value_type();
+                }
+                value_type _item = m_buffer[_b & Mask].load(memory_order::Relaxed);
+
+                if(_size > 0) return _item;
+
+                // the last item, race with the stealers
+                uint32_t _next = _t + 1;
+                if(!m_top.compare_exchange_strong(_t, _next, memory_order::SeqCst))
+                    _item = value_type();
+
+                m_bottom.store(_b + 1, memory_order::Relaxed);
+                return _item;
+            }
+
+            /**
+             * Steal the oldest item from the top, from any task
+             * @return The item or value_type() when the deque is empty or a
+             * other task won the race
+             */
+            value_type steal() {
+                uint32_t _t = m_top.load(memory_order::Acquire);
+                atomic_thread_fence(memory_order::SeqCst);
+                uint32_t _b = m_bottom.load(memory_order::Acquire);
+
+                if( (int32_t)(_b - _t) <= 0 ) return value_type();
+
+                value_type _item = m_buffer[_t & Mask].load(memory_order::Relaxed);
+
+                uint32_t _next = _t + 1;
+                if(!m_top.compare_exchange_strong(_t, _next, memory_order::SeqCst))
+                    return value_type();
+
+                return _item;
+            }
+
+            /**
+             * @return The number of items, only a snapshot from other tasks
+             */
+            uint32_t size() const {
+                int32_t _size = (int32_t)(m_bottom.load(memory_order::Acquire) -
+                                          m_top.load(memory_order::Acquire));
+                return (_size < 0) ? 0 : (uint32_t)_size;
+            }
+
+            bool is_empty() const { return size() == 0; }
+
+            /**
+             * @return The capacity of this deque
+             */
+            constexpr uint32_t capacity() const { return nCapacity; }
+        private:
+            basic_atomic_gcc<uint32_t> m_top;
+            basic_atomic_gcc<uint32_t> m_bottom;
+            basic_atomic_gcc<value_type> m_buffer[nCapacity];
+        };
+    }
+}
+
+#endif
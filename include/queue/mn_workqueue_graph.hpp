@@ -0,0 +1,227 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_GRAPH_
+#define MINLIB_ESP32_WORK_QUEUE_GRAPH_
+
+#include "mn_workqueue.hpp"
+#include "../mn_binary_semaphore.hpp"
+#include <vector>
+
+namespace mn {
+    namespace queue {
+        class basic_work_graph;
+
+        /**
+         * A node of a work graph, runs a work_queue_item_t when all
+         * predecessors of the node are finished
+         *
+         * @ingroup queue
+         */
+        class work_graph_node : public work_queue_item_t {
+            friend class basic_work_graph;
+        public:
+            /**
+             * Run this node after the given node
+             * @return
+             *  - ERR_WORKQUEUE_OK The dependency is added
+             *  - ERR_WORKQUEUE_BUSY The graph runs
+             */
+            int succeed(work_graph_node* node);
+            /**
+             * Run the given node after this node
+             * @see succeed
+             */
+            int precede(work_graph_node* node) { return node->succeed(this); }
+
+            /**
+             * Get the work item of this node
+             */
+            work_queue_item_t* get_work() { return m_pWork; }
+            /**
+             * Get the number of predecessors of this node
+             */
+            uint16_t get_num_predecessors() const { return m_uiNumPreds; }
+
+            /**
+             * Run the work item and then queue the ready successors, the
+             * first ready successor runs in this worker without queueing
+             */
+            virtual bool on_work() override;
+        protected:
+            work_graph_node(basic_work_graph* graph, work_queue_item_t* work);
+
+            /**
+             * Run only this node and count the result in the graph
+             * @return True when the work item returns true
+             */
+            bool run_work();
+        private:
+            /**
+             * The graph of this node
+             */
+            basic_work_graph* m_pGraph;
+            /**
+             * The item of this node
+             */
+            work_queue_item_t* m_pWork;
+            /**
+             * The nodes, that wait for this node
+             */
+            std::vector<work_graph_node*> m_vSuccessors;
+            /**
+             * The next node in the ready list of on_work, when the queue is full
+             */
+            work_graph_node* m_pNextReady;
+            /**
+             * The number of the predecessors
+             */
+            uint16_t m_uiNumPreds;
+            /**
+             * The not finished predecessors in the current run
+             */
+            atomic_uint32_t m_uiWaiting;
+        };
+
+        /**
+         * A graph of work items with dependencies (DAG). A node is queued to the
+         * work queue, when all predecessors are finished - so independent branches
+         * run parallel on the workers of the work queue.
+         *
+         * All nodes and dependencies are allocated on add and succeed, a run
+         * allocates nothing - the graph can run again and again. The graph must
+         * be acyclic, a cycle runs never to the end.
+         *
+         * @code
+         *  basic_work_graph graph;
+         *  work_graph_node* load = graph.add(&loadItem);
+         *  work_graph_node* filter = graph.add(&filterItem);
+         *  work_graph_node* store = graph.add(&storeItem);
+         *  filter->succeed(load); store->succeed(filter);
+         *
+         *  graph.run(workqueue);
+         * @endcode
+         *
+         * @ingroup queue
+         */
+        class basic_work_graph {
+            friend class work_graph_node;
+        public:
+            basic_work_graph();
+            /**
+             * Delete all nodes, not the work items. Wait not for a run
+             */
+            ~basic_work_graph();
+
+            basic_work_graph(const basic_work_graph&) = delete;
+            basic_work_graph& operator = (const basic_work_graph&) = delete;
+
+            /**
+             * Add a node for a work item
+             *
+             * @param work The work item, can_delete must be false. The item must
+             * not be in the graph or in a work queue
+             * @return The new node or NULL when the graph runs or can_delete is true
+             */
+            work_graph_node* add(work_queue_item_t* work);
+
+            /**
+             * Start a run of the graph: queue all nodes without predecessors. Each
+             * run must be ended with wait, befor the graph can start again
+             *
+             * @param queue The work queue for the nodes, must be created
+             * @param timeout How long to wait for each root node, when the queue is
+             * full - after the timeout the caller runs the node self
+             * @return
+             *  - ERR_WORKQUEUE_OK The graph runs
+             *  - ERR_WORKQUEUE_BUSY The graph runs already
+             *  - ERR_WORKQUEUE_ADD The graph has no node without predecessors (a cycle)
+             */
+            int start(basic_work_queue& queue,
+                      unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
+
+            /**
+             * Wait for the end of the current run
+             *
+             * @param timeout How long to wait
+             * @return
+             *  - ERR_WORKQUEUE_OK All nodes are run
+             *  - ERR_WORKQUEUE_BUSY The timeout is over, the graph runs
+             */
+            int wait(unsigned int timeout = portMAX_DELAY);
+
+            /**
+             * Start the graph and wait for the end
+             * @see start, wait
+             */
+            int run(basic_work_queue& queue, unsigned int timeout = portMAX_DELAY);
+
+            /**
+             * Is the graph running, from start until the end is waited
+             */
+            bool is_running() { return m_bRunning.load(); }
+
+            /**
+             * Get the number of nodes
+             */
+            uint32_t get_num_nodes() const { return m_vNodes.size(); }
+            /**
+             * Get the number of nodes, that returned false in the last run
+             */
+            uint32_t get_num_errors() { return m_uiErrors.load(); }
+        protected:
+            /**
+             * Called from a node, when it is ready to run
+             * @return False when the queue is full, the caller runs the node then
+             */
+            bool schedule(work_graph_node* node);
+            /**
+             * Called from a node, when it is run - the last node ends the run
+             */
+            void finished();
+        private:
+            /**
+             * All nodes of the graph
+             */
+            std::vector<work_graph_node*> m_vNodes;
+            /**
+             * The work queue of the current run
+             */
+            basic_work_queue* m_pQueue;
+            /**
+             * The not finished nodes in the current run
+             */
+            atomic_uint32_t m_uiRemaining;
+            /**
+             * The nodes, that returned false in the current run
+             */
+            atomic_uint32_t m_uiErrors;
+            /**
+             * Is the graph running
+             */
+            basic_atomic_gcc<bool> m_bRunning;
+            /**
+             * Given at the end of a run
+             */
+            binary_semaphore_t m_semDone;
+        };
+
+        using work_graph_t = basic_work_graph;
+    }
+}
+
+#endif
@@ -17,6 +17,11 @@
 #ifndef MINLIB_ESP32_WORK_ITEM_QUEUE_
 #define MINLIB_ESP32_WORK_ITEM_QUEUE_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../mn_functional.hpp"
+
 namespace mn {
     namespace queue {
         /**
@@ -28,6 +33,8 @@ namespace mn {
          * @ingroup queue
          */
         class work_queue_item {
+            friend class basic_work_queue;
+            friend class basic_work_strand;
         public:
             /**
              *  Our constructor.
@@ -35,13 +42,16 @@ namespace mn {
              *  @param deleteAffter If you pass in a true, you are 
              *  requesing the work_queue_t itself to delete this work_queue_item after
              *  it has run it. 
+             *  @param uiPriority The priority of this item, only used from the
+             *  priority work queue engine - higher is more important
              *  @note Only set deleteAffter = true if:
              *  1) You dynamically allocated it (i.e. used "new")
              *  2) After you call on_work() you promise never to touch 
              *     this object again. 
              */
-            work_queue_item(bool deleteAffter = false) 
-                : m_bCanDelete(deleteAffter) { }
+            work_queue_item(bool deleteAffter = false, uint8_t uiPriority = 0) 
+                : m_bCanDelete(deleteAffter), m_uiPriority(uiPriority), 
+                  m_ulQueued(0), m_bTimerQueued(false), m_pNextBatch(NULL) { }
 
             /**
              *  Our destructor.
@@ -54,16 +64,93 @@ namespace mn {
              */
             bool can_delete() { return m_bCanDelete; }
 
+            /**
+             *  Get the priority of this item
+             */
+            uint8_t get_priority() const { return m_uiPriority; }
+            /**
+             *  Set the priority of this item, only befor queue this item
+             */
+            void set_priority(uint8_t uiPriority) { m_uiPriority = uiPriority; }
+            /**
+             *  Get the time in micros, when this item was queued - set from
+             *  the priority work queue engine
+             */
+            unsigned long get_queued_time() const { return m_ulQueued; }
+
             /**
              *  Implementation of your actual work_queue_item function.
              *  You must override this function.
              */
             virtual bool on_work() = 0;
+
+            /**
+             *  Called from the work queue after on_work, when can_delete is true.
+             *  The default deletes the item, a item from the item pool of the
+             *  work queue returns here the block to the pool
+             */
+            virtual void release() { delete this; }
+            /**
+             *  Called befor release, a shared item (i.e. the item of a async 
+             *  future) returns false while the other owner uses it
+             */
+            virtual bool can_release() { return true; }
         private:
-            const bool m_bCanDelete;
+            /**
+             * Release the item after the run, set from the constructor or 
+             * from the item pool of the work queue
+             */
+            bool m_bCanDelete;
+            /**
+             * The priority of this item
+             */
+            uint8_t m_uiPriority;
+            /**
+             * The time in micros, when this item was queued
+             */
+            unsigned long m_ulQueued;
+            /**
+             * The periodic item is queued from the timer and not started
+             */
+            volatile bool m_bTimerQueued;
+            /**
+             * The next item in the same batch, set from queue_bulk
+             */
+            work_queue_item* m_pNextBatch;
         };
 
         using work_queue_item_t = work_queue_item;
+
+        namespace internal {
+            // a callable with a result convertible to bool, the result is the item result
+            template <class TFn> 
+            inline auto work_fn_call(TFn& fn, int) -> decltype(bool(fn())) { return fn(); }
+            // a void callable, the item is always successful
+            template <class TFn> 
+            inline bool work_fn_call(TFn& fn, long) { fn(); return true; }
+        }
+
+        /**
+         * A work item, that holds a callable (i.e. a lambda) in place and runs
+         * it in on_work. Created with basic_work_queue::queue_fn from the item 
+         * pool of the work queue, without any heap allocation
+         * 
+         * @tparam TFn The type of the callable, returns bool or void
+         * 
+         * @ingroup queue
+         */
+        template <class TFn>
+        class work_queue_fn_item : public work_queue_item {
+        public:
+            explicit work_queue_fn_item(TFn fn, uint8_t uiPriority = 0) 
+                : work_queue_item(true, uiPriority), m_fn(mn::move(fn)) { }
+
+            virtual bool on_work() override { 
+                return internal::work_fn_call(m_fn, 0); 
+            }
+        private:
+            TFn m_fn;
+        };
     }
 }
 
@@ -26,6 +26,11 @@ namespace mn {
         /**
          * This class is the multi task "engine" for work_queue_items.
          * 
+         * With less min workers as max workers the pool is elastic: a new worker 
+         * is started, when many items wait in the queue or a item waits too long, 
+         * and a worker over the min workers ends after a idle time - so the stack 
+         * RAM of the idle workers is free.
+         * 
          * @ingroup queue
          */
         class basic_work_queue_multi : public basic_work_queue {
@@ -36,18 +41,51 @@ namespace mn {
              * @param uiPriority FreeRTOS priority of this task.
              * @param usStackDepth Number of "words" allocated for the task stack.
              * @param uiMaxWorkItems Maximum number of WorkItems this WorkQueue can hold.
-             * @param uiMaxWorkers How many Worker tasks run with this workqueue
+             * @param uiMaxWorkers How many Worker tasks run max with this workqueue
+             * @param uiMinWorkers How many Worker tasks run min with this workqueue, 
+             * the pool is fixed when it is equal or greater then uiMaxWorkers
              */
             basic_work_queue_multi(basic_task::priority uiPriority = MN_THREAD_CONFIG_WORKQUEUE_MULTI_PRIORITY,
                         uint16_t usStackDepth = MN_THREAD_CONFIG_WORKQUEUE_MULTI_STACKSIZE,
                         uint8_t uiMaxWorkItems = MN_THREAD_CONFIG_WORKQUEUE_MULTI_MAXITEMS,
-                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER);
+                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_MULTI_WORKER,
+                        uint8_t uiMinWorkers = MN_THREAD_CONFIG_WORKQUEUE_MULTI_MINWORKER);
 
             /**
              * Our destructor.
              */
             ~basic_work_queue_multi();
 
+            /**
+             * Send a work_queue_item_t off to be executed, in a elastic pool a new 
+             * worker is started, when many items wait in the queue
+             * 
+             * @see basic_work_queue::queue
+             */
+            virtual int queue(work_queue_item_t *work,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             * Send many work_queue_item_t off to be executed, in a elastic pool a new 
+             * worker is started, when many batches wait in the queue
+             * 
+             * @see basic_work_queue::queue_bulk
+             */
+            virtual int queue_bulk(work_queue_item_t **items, uint32_t n,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT,
+                            uint32_t* queued = NULL) override;
+
+            /**
+             * Set the thresholds to start a new worker
+             * @param uiDepth How many items wait in the queue
+             * @param uiWaitMs How long a item waits in the queue in ms
+             */
+            void set_grow_threshold(uint8_t uiDepth, uint32_t uiWaitMs);
+            /**
+             * Set the time in ms, after a idle worker over the min workers ends
+             */
+            void set_idle_time(uint32_t uiIdleMs);
+
             /**
              * Get the real num worker tasks for this workqueue engine
              * @return The real num worker threads for this workqueue engine
@@ -58,8 +96,21 @@ namespace mn {
              * @return The num worker threads for this workqueue engine
              */ 
             uint8_t get_num_max_worker() const;
+            /**
+             * Get the min num worker tasks for this workqueue engine
+             */ 
+            uint8_t get_num_min_worker() const;
+            /**
+             * How many workers are started from the elastic pool
+             */ 
+            uint32_t get_num_grows();
+            /**
+             * How many idle workers are ended from the elastic pool
+             */ 
+            uint32_t get_num_retires();
             /**
              * Get tde reference ot all workqueue tasks
+             * @note In a elastic pool the vector is changed from the workers
              */ 
             std::vector<work_queue_task*>& workers();
         protected:
@@ -79,6 +130,32 @@ namespace mn {
              */
             void destroy_engine();
 
+            /**
+             * Run a item, in a elastic pool a new worker is started, when the item
+             * waits too long in the queue
+             */
+            virtual void run_item(work_queue_item* item) override;
+
+            /**
+             * End the worker, when it is idle over the idle time and more as
+             * the min workers run
+             */
+            virtual bool retire_worker(work_queue_task* worker, TickType_t idle) override;
+
+            /**
+             * Start a new worker, when less as the max workers run. Never waits
+             * on a other grow or retire
+             */
+            void grow();
+            /**
+             * Join and delete the ended workers, call with m_WorkersLock
+             */
+            void reap();
+            /**
+             * Create a new worker task object
+             */
+            work_queue_task* new_worker();
+
         private:
             /**
              * Vector for all workqueue threads
@@ -88,6 +165,30 @@ namespace mn {
              * Holder of num worker threads for this workqueue engine
              */ 
             uint8_t m_uiMaxWorkers;
+            /**
+             * Holder of min num worker threads for this workqueue engine
+             */ 
+            uint8_t m_uiMinWorkers;
+            /**
+             * The ended workers, for the join and delete
+             */ 
+            std::vector<work_queue_task*> m_vRetired;
+            /**
+             * Lock for the worker vectors
+             */ 
+            mutex_t m_WorkersLock;
+            /**
+             * The number of workers, read without the lock
+             */ 
+            atomic_uint32_t m_uiWorkers;
+            atomic_uint32_t m_uiGrows;
+            atomic_uint32_t m_uiRetires;
+
+            uint8_t m_uiGrowDepth;
+            uint32_t m_uiGrowWait;
+            TickType_t m_uiIdleTime;
+            int m_iCore;
+            int m_iNextName;
         };
 
         using multi_engine_workqueue_t = basic_work_queue_multi;
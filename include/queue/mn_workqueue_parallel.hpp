@@ -0,0 +1,436 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_PARALLEL_
+#define MINLIB_ESP32_WORK_QUEUE_PARALLEL_
+
+#include "mn_workqueue.hpp"
+#include "../mn_binary_semaphore.hpp"
+#include "../utils/mn_sort.hpp"
+#include "../container/mn_vector.hpp"
+
+#include <new>
+
+namespace mn {
+    namespace queue {
+        /**
+         * The base of all parallel algorithms. The range [0, n) is split in chunks,
+         * the caller and the helper items in the work queue take the chunks from a
+         * shared index. The chunks are large at the begin and small at the end
+         * (remaining / (2 * tasks), min the grain size) - so all tasks are ready
+         * at the same time, without a fixed split.
+         *
+         * The caller runs chunks too and runs other queued items while it waits
+         * for the helpers (try_run_one), so it can be a worker of the same work
+         * queue. The helpers are members of the job, a run allocates nothing.
+         *
+         * @ingroup queue
+         */
+        class basic_parallel_job {
+        public:
+            /**
+             * @param queue The work queue for the helper items, must be created
+             * @param uiSize The number of elements
+             * @param uiGrain The min number of elements in a chunk
+             * @param uiTasks How many tasks run the job, the caller and the helpers.
+             * Max MN_THREAD_CONFIG_PARALLEL_MAX_TASKS
+             */
+            basic_parallel_job(basic_work_queue& queue, uint32_t uiSize,
+                               uint32_t uiGrain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                               uint8_t uiTasks = MN_THREAD_CONFIG_PARALLEL_TASKS);
+            virtual ~basic_parallel_job() { }
+
+            basic_parallel_job(const basic_parallel_job&) = delete;
+            basic_parallel_job& operator = (const basic_parallel_job&) = delete;
+
+            /**
+             * Run all chunks and wait until all helpers are finished
+             */
+            void run();
+
+            /**
+             * Get the number of tasks, the slots for on_range
+             */
+            uint8_t get_num_tasks() const { return m_uiTasks; }
+        protected:
+            /**
+             * Implementation of your actual chunk code.
+             *
+             * @param uiFirst The first element of the chunk
+             * @param uiLast The end of the chunk
+             * @param uiSlot The slot of the running task, 0 is the caller - only one
+             * task runs in a slot, for partial results without a lock
+             */
+            virtual void on_range(uint32_t uiFirst, uint32_t uiLast, uint8_t uiSlot) = 0;
+
+            /**
+             * Take the next chunk from the shared index
+             * @return False when all chunks are taken
+             */
+            bool next_chunk(uint32_t& uiFirst, uint32_t& uiLast);
+            /**
+             * Run chunks until all are taken, then count this task as finished
+             * @return True when this was the last running task
+             */
+            bool participate(uint8_t uiSlot);
+        private:
+            /**
+             * The helper item in the work queue
+             */
+            class helper : public work_queue_item_t {
+            public:
+                helper() : work_queue_item_t(false), m_pJob(NULL), m_uiSlot(0) { }
+
+                virtual bool on_work() override;
+
+                basic_parallel_job* m_pJob;
+                uint8_t m_uiSlot;
+            };
+        private:
+            basic_work_queue& m_queue;
+            helper m_helpers[MN_THREAD_CONFIG_PARALLEL_MAX_TASKS - 1];
+
+            uint32_t m_uiSize;
+            uint32_t m_uiGrain;
+            uint8_t m_uiTasks;
+            /**
+             * The first not taken element
+             */
+            atomic_uint32_t m_uiNext;
+            /**
+             * The not finished tasks, the last gives m_semDone
+             */
+            atomic_uint32_t m_uiActive;
+            binary_semaphore_t m_semDone;
+        };
+    }
+
+    namespace internal {
+        /**
+         * The job for parallel_for over a index range
+         */
+        MN_TEMPLATE_FULL_DECL_ONE(class, TFn)
+        class parallel_for_job : public queue::basic_parallel_job {
+        public:
+            parallel_for_job(queue::basic_work_queue& queue, size_t first, size_t last,
+                             TFn& fn, uint32_t grain, uint8_t tasks)
+                : basic_parallel_job(queue, (uint32_t)(last - first), grain, tasks),
+                  m_first(first), m_fn(fn) { }
+        protected:
+            virtual void on_range(uint32_t uiFirst, uint32_t uiLast, uint8_t uiSlot) override {
+                (void)uiSlot;
+                for(uint32_t i = uiFirst; i < uiLast; i++) m_fn(m_first + i);
+            }
+        private:
+            size_t m_first;
+            TFn& m_fn;
+        };
+
+        /**
+         * The job for parallel_transform
+         */
+        MN_TEMPLATE_FULL_DECL_THREE(typename, T, typename, TOut, class, TFn)
+        class parallel_transform_job : public queue::basic_parallel_job {
+        public:
+            parallel_transform_job(queue::basic_work_queue& queue, const T* first, const T* last,
+                                   TOut* dest, TFn& fn, uint32_t grain, uint8_t tasks)
+                : basic_parallel_job(queue, (uint32_t)(last - first), grain, tasks),
+                  m_src(first), m_dest(dest), m_fn(fn) { }
+        protected:
+            virtual void on_range(uint32_t uiFirst, uint32_t uiLast, uint8_t uiSlot) override {
+                (void)uiSlot;
+                for(uint32_t i = uiFirst; i < uiLast; i++) m_dest[i] = m_fn(m_src[i]);
+            }
+        private:
+            const T* m_src;
+            TOut* m_dest;
+            TFn& m_fn;
+        };
+
+        /**
+         * The job for parallel_reduce, one partial result for each slot
+         */
+        MN_TEMPLATE_FULL_DECL_THREE(typename, T, typename, TVal, class, TOp)
+        class parallel_reduce_job : public queue::basic_parallel_job {
+        public:
+            parallel_reduce_job(queue::basic_work_queue& queue, const T* first, const T* last,
+                                TOp& op, uint32_t grain, uint8_t tasks)
+                : basic_parallel_job(queue, (uint32_t)(last - first), grain, tasks),
+                  m_src(first), m_op(op) {
+                for(int i = 0; i < MN_THREAD_CONFIG_PARALLEL_MAX_TASKS; i++) m_has[i] = false;
+            }
+
+            /**
+             * Combine the partial results of all slots with the init value
+             */
+            TVal result(TVal init) {
+                for(int i = 0; i < MN_THREAD_CONFIG_PARALLEL_MAX_TASKS; i++)
+                    if(m_has[i]) init = m_op(init, m_partial[i]);
+                return init;
+            }
+        protected:
+            virtual void on_range(uint32_t uiFirst, uint32_t uiLast, uint8_t uiSlot) override {
+                TVal _local = m_src[uiFirst];
+                for(uint32_t i = uiFirst + 1; i < uiLast; i++) _local = m_op(_local, m_src[i]);
+
+                m_partial[uiSlot] = m_has[uiSlot] ? m_op(m_partial[uiSlot], _local) : _local;
+                m_has[uiSlot] = true;
+            }
+        private:
+            const T* m_src;
+            TOp& m_op;
+            TVal m_partial[MN_THREAD_CONFIG_PARALLEL_MAX_TASKS];
+            bool m_has[MN_THREAD_CONFIG_PARALLEL_MAX_TASKS];
+        };
+
+        /**
+         * Find the split of a merge of a and b: the first k elements of the merge
+         * are a[0, i) and b[0, k - i), equal elements are taken from a first
+         *
+         * @return i
+         */
+        MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
+        size_t merge_split(const T* a, size_t la, const T* b, size_t lb, size_t k, TPredicate pred) {
+            size_t lo = (k > lb) ? k - lb : 0;
+            size_t hi = (k < la) ? k : la;
+
+            while(lo < hi) {
+                size_t i = (lo + hi) / 2;
+                size_t j = k - i;
+
+                // b[j - 1] is not less as a[i], take more from a
+                if(j > 0 && !pred(b[j - 1], a[i])) lo = i + 1;
+                else hi = i;
+            }
+            return lo;
+        }
+
+        /**
+         * The job for one merge level of parallel_sort: each pair of runs is
+         * merged in pieces, each piece is split with merge_split
+         */
+        MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
+        class parallel_merge_job : public queue::basic_parallel_job {
+        public:
+            parallel_merge_job(queue::basic_work_queue& queue, const T* src, T* dest, size_t n,
+                               size_t width, uint32_t pieces, TPredicate& pred, uint8_t tasks)
+                : basic_parallel_job(queue, (uint32_t)(((n + 2 * width - 1) / (2 * width)) * pieces), 1, tasks),
+                  m_src(src), m_dest(dest), m_n(n), m_width(width), m_pieces(pieces), m_pred(pred) { }
+        protected:
+            virtual void on_range(uint32_t uiFirst, uint32_t uiLast, uint8_t uiSlot) override {
+                (void)uiSlot;
+                for(uint32_t p = uiFirst; p < uiLast; p++) merge_piece(p / m_pieces, p % m_pieces);
+            }
+
+            void merge_piece(size_t pair, size_t piece) {
+                size_t _lo = pair * 2 * m_width;
+                size_t _mid = (_lo + m_width < m_n) ? _lo + m_width : m_n;
+                size_t _hi = (_mid + m_width < m_n) ? _mid + m_width : m_n;
+
+                const T* a = m_src + _lo; size_t la = _mid - _lo;
+                const T* b = m_src + _mid; size_t lb = _hi - _mid;
+                size_t _len = la + lb;
+
+                size_t k0 = _len * piece / m_pieces;
+                size_t k1 = _len * (piece + 1) / m_pieces;
+
+                size_t i = merge_split(a, la, b, lb, k0, m_pred);
+                size_t i1 = merge_split(a, la, b, lb, k1, m_pred);
+                size_t j = k0 - i;
+                size_t j1 = k1 - i1;
+
+                T* _out = m_dest + _lo + k0;
+
+                while(i < i1 && j < j1) {
+                    if(m_pred(b[j], a[i])) *_out++ = b[j++];
+                    else *_out++ = a[i++];
+                }
+                while(i < i1) *_out++ = a[i++];
+                while(j < j1) *_out++ = b[j++];
+            }
+        private:
+            const T* m_src;
+            T* m_dest;
+            size_t m_n;
+            size_t m_width;
+            uint32_t m_pieces;
+            TPredicate& m_pred;
+        };
+    }
+
+    /**
+     * Call fn(i) for each i in [first, last) on the caller and the helper
+     * items in the work queue
+     *
+     * @ingroup queue
+     */
+    MN_TEMPLATE_FULL_DECL_ONE(class, TFn)
+    void parallel_for(queue::basic_work_queue& queue, size_t first, size_t last, TFn fn,
+                      uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                      uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        if(last <= first) return;
+
+        internal::parallel_for_job<TFn> _job(queue, first, last, fn, grain, tasks);
+        _job.run();
+    }
+
+    /**
+     * Call fn(element) for each element of the vector
+     */
+    MN_TEMPLATE_FULL_DECL_THREE(typename, T, class, TAllocator, class, TFn)
+    void parallel_for(queue::basic_work_queue& queue, container::basic_vector<T, TAllocator>& v, TFn fn,
+                      uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                      uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        T* _data = v.begin();
+        parallel_for(queue, 0, v.size(), [_data, &fn](size_t i) { fn(_data[i]); }, grain, tasks);
+    }
+
+    /**
+     * dest[i] = fn(first[i]) for each element in [first, last)
+     */
+    MN_TEMPLATE_FULL_DECL_THREE(typename, T, typename, TOut, class, TFn)
+    void parallel_transform(queue::basic_work_queue& queue, const T* first, const T* last,
+                            TOut* dest, TFn fn,
+                            uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                            uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        if(last <= first) return;
+
+        internal::parallel_transform_job<T, TOut, TFn> _job(queue, first, last, dest, fn, grain, tasks);
+        _job.run();
+    }
+
+    /**
+     * dest[i] = fn(src[i]) for each element of src, dest is resized to the size of src
+     */
+    template <typename T, typename TOut, class TAllocator, class TFn>
+    void parallel_transform(queue::basic_work_queue& queue,
+                            const container::basic_vector<T, TAllocator>& src,
+                            container::basic_vector<TOut, TAllocator>& dest, TFn fn,
+                            uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                            uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        dest.resize(src.size());
+        parallel_transform(queue, src.cbegin(), src.cbegin() + src.size(), dest.begin(), fn, grain, tasks);
+    }
+
+    /**
+     * Reduce [first, last) with op, the op must be associative and commutative -
+     * the chunks are combined in any order
+     *
+     * @return op(init, all elements)
+     */
+    MN_TEMPLATE_FULL_DECL_THREE(typename, T, typename, TVal, class, TOp)
+    TVal parallel_reduce(queue::basic_work_queue& queue, const T* first, const T* last,
+                         TVal init, TOp op,
+                         uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                         uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        if(last <= first) return init;
+
+        internal::parallel_reduce_job<T, TVal, TOp> _job(queue, first, last, op, grain, tasks);
+        _job.run();
+
+        return _job.result(init);
+    }
+
+    /**
+     * Reduce all elements of the vector with op
+     * @see parallel_reduce
+     */
+    template <typename T, typename TVal, class TAllocator, class TOp>
+    TVal parallel_reduce(queue::basic_work_queue& queue,
+                         const container::basic_vector<T, TAllocator>& v,
+                         TVal init, TOp op,
+                         uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                         uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        return parallel_reduce(queue, v.cbegin(), v.cbegin() + v.size(), init, op, grain, tasks);
+    }
+
+    /**
+     * A parallel merge sort: the blocks are sorted with quick_sort in parallel,
+     * then all runs are merged level by level, each merge is split in pieces for
+     * all tasks. Needs a buffer of (last - first) elements, T must be default
+     * constructible. Not stable
+     *
+     * @ingroup queue
+     */
+    MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
+    void parallel_sort(queue::basic_work_queue& queue, T* first, T* last, TPredicate pred,
+                       uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                       uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        size_t _n = last - first;
+
+        if(tasks > MN_THREAD_CONFIG_PARALLEL_MAX_TASKS) tasks = MN_THREAD_CONFIG_PARALLEL_MAX_TASKS;
+        if(tasks < 2 || _n < 4 * (size_t)grain) {
+            quick_sort(first, last, pred);
+            return;
+        }
+        // two blocks for each task, a block has min 2 * grain elements
+        size_t _blocks = 2 * tasks;
+        if(_n / _blocks < 2 * (size_t)grain) _blocks = _n / (2 * grain);
+
+        size_t _width = (_n + _blocks - 1) / _blocks;
+        _blocks = (_n + _width - 1) / _width;
+
+        parallel_for(queue, 0, _blocks, [first, _n, _width, &pred](size_t b) {
+            size_t _lo = b * _width;
+            size_t _hi = (_lo + _width < _n) ? _lo + _width : _n;
+            quick_sort(first + _lo, first + _hi, pred);
+        }, 1, tasks);
+
+        T* _buffer = new (std::nothrow) T[_n];
+        if(_buffer == NULL) {
+            // no buffer, merge the sorted blocks self
+            quick_sort(first, last, pred);
+            return;
+        }
+        T* _src = first;
+        T* _dest = _buffer;
+
+        for(; _width < _n; _width *= 2) {
+            size_t _pairs = (_n + 2 * _width - 1) / (2 * _width);
+            uint32_t _pieces = (uint32_t)((2 * tasks + _pairs - 1) / _pairs);
+
+            internal::parallel_merge_job<T, TPredicate> _job(queue, _src, _dest, _n,
+                                                             _width, _pieces, pred, tasks);
+            _job.run();
+
+            T* _tmp = _src; _src = _dest; _dest = _tmp;
+        }
+        if(_src != first) {
+            parallel_for(queue, 0, _n, [first, _src](size_t i) { first[i] = _src[i]; }, grain, tasks);
+        }
+        delete[] _buffer;
+    }
+
+    MN_TEMPLATE_FULL_DECL_ONE(typename, T)
+    void parallel_sort(queue::basic_work_queue& queue, T* first, T* last) {
+        parallel_sort(queue, first, last, less<T>());
+    }
+
+    /**
+     * Sort all elements of the vector
+     * @see parallel_sort
+     */
+    MN_TEMPLATE_FULL_DECL_THREE(typename, T, class, TAllocator, class, TPredicate)
+    void parallel_sort(queue::basic_work_queue& queue, container::basic_vector<T, TAllocator>& v,
+                       TPredicate pred,
+                       uint32_t grain = MN_THREAD_CONFIG_PARALLEL_GRAINSIZE,
+                       uint8_t tasks = MN_THREAD_CONFIG_PARALLEL_TASKS) {
+        parallel_sort(queue, v.begin(), v.end(), pred, grain, tasks);
+    }
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_PRIO_
+#define MINLIB_ESP32_WORK_QUEUE_PRIO_
+
+#include "mn_workqueue.hpp"
+#include "../mn_counting_semaphore.hpp"
+#include <vector>
+
+namespace mn {
+    namespace queue {
+        /**
+         * The latency statistics of one band of the priority workqueue
+         *
+         * @ingroup queue
+         */
+        struct work_queue_band_stats {
+            uint32_t queued;        ///< How many items are queued
+            uint32_t worked;        ///< How many items are worked
+            uint32_t aged;          ///< How many items are run over the aging
+            uint32_t avg_wait_us;   ///< The average time from queue to the start of on_work
+            uint32_t max_wait_us;   ///< The max time from queue to the start of on_work
+            uint32_t avg_latency_us;///< The average time from queue to the end of on_work
+            uint32_t max_latency_us;///< The max time from queue to the end of on_work
+        };
+
+        /**
+         * This class is the priority "engine" for work_queue_items.
+         *
+         * Each priority band has a own queue, the workers run the items of the
+         * highest not empty band first. The band of a item is the item priority
+         * (work_queue_item::get_priority), priorities over the last band are in
+         * the last band. With aging, a item that waits longer as the aging time is
+         * run befor the items of the higher bands - so the lower bands starve not.
+         *
+         * @ingroup queue
+         */
+        class basic_work_queue_prio : public basic_work_queue {
+        public:
+            /**
+             * Our constructor.
+             *
+             * @param uiPriority FreeRTOS priority of the worker tasks.
+             * @param usStackDepth Number of "words" allocated for the task stack.
+             * @param uiMaxWorkItems Maximum number of items in each band.
+             * @param uiBands How many priority bands
+             * @param uiMaxWorkers How many Worker tasks run with this workqueue
+             * @param uiAgingTime The aging time in ms, 0 for no aging
+             */
+            basic_work_queue_prio(basic_task::priority uiPriority = MN_THREAD_CONFIG_WORKQUEUE_PRIO_PRIORITY,
+                        uint16_t usStackDepth = MN_THREAD_CONFIG_WORKQUEUE_PRIO_STACKSIZE,
+                        uint8_t uiMaxWorkItems = MN_THREAD_CONFIG_WORKQUEUE_PRIO_MAXITEMS,
+                        uint8_t uiBands = MN_THREAD_CONFIG_WORKQUEUE_PRIO_BANDS,
+                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_PRIO_WORKER,
+                        uint32_t uiAgingTime = MN_THREAD_CONFIG_WORKQUEUE_PRIO_AGING);
+
+            /**
+             * Our destructor.
+             */
+            ~basic_work_queue_prio();
+
+            /**
+             * Send a work_queue_item_t off to be executed, in the band of the
+             * item priority
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @note This function may block if the band is presently full.
+             *
+             * @return
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added
+             *  - ERR_WORKQUEUE_ADD If The work_queue_item_t are not added
+             */
+            virtual int queue(work_queue_item_t *work,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             * Send many work_queue_item_t off to be executed, each item is queued
+             * in the band of the item priority - no batches, so a batch can not
+             * delay the items of a higher band
+             *
+             * @see basic_work_queue::queue_bulk
+             */
+            virtual int queue_bulk(work_queue_item_t **items, uint32_t n,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT,
+                            uint32_t* queued = NULL) override;
+
+            /**
+             * Get the latency statistics of a band
+             * @param uiBand The band
+             * @param stats The statistics
+             * @return True when the band exist
+             */
+            bool get_band_stats(uint8_t uiBand, work_queue_band_stats& stats);
+            /**
+             * Reset the statistics of all bands, the counters and the histograms
+             */
+            virtual void reset_stats() override;
+
+            /**
+             * Get the number of bands
+             */
+            uint8_t get_num_bands() const { return m_uiBands; }
+            /**
+             * Get the aging time in ms, 0 for no aging
+             */
+            uint32_t get_aging_time() const { return m_uiAgingTime; }
+            /**
+             * Set the aging time in ms, 0 for no aging
+             */
+            void set_aging_time(uint32_t uiAgingTime) { m_uiAgingTime = uiAgingTime; }
+
+            /**
+             * Get the real num worker tasks for this workqueue engine
+             */
+            uint8_t get_num_worker() const;
+            /**
+             * Get the num worker tasks for this workqueue engine
+             */
+            uint8_t get_num_max_worker() const;
+        protected:
+            /**
+             * Get the next item from the highest not empty band or a aged item
+             *
+             * @param timeout How long to wait to get an item
+             * @return The next item or NULL on timeout
+             */
+            virtual work_queue_item* get_next_item(unsigned int timeout) override;
+
+            /**
+             * Wake a waiting worker, the next due delayed item is changed
+             */
+            virtual void wake_for_timer() override;
+
+            /**
+             * Run a item and update the statistics of the band
+             */
+            virtual void run_item(work_queue_item* item) override;
+
+            /**
+             * Create this priority work queue
+             *
+             * @param iCore run on whith core
+             * @return
+             *   - ERR_WORKQUEUE_OK The engine is created
+             *   - ERR_WORKQUEUE_WARNING Not all worker tasks are created
+             *   - ERR_WORKQUEUE_CANTCREATE The engine can not created
+             */
+            int create_engine(int iCore);
+
+            /**
+             * Destroy this priority work queue
+             */
+            void destroy_engine();
+
+            /**
+             * @return The band for a item
+             */
+            uint8_t get_band(work_queue_item* item) const {
+                uint8_t _prio = item->get_priority();
+                return (_prio < m_uiBands) ? _prio : (m_uiBands - 1);
+            }
+        private:
+            /**
+             * The entry in the band queue, the queued time is copied so
+             * peek does not touch the item
+             */
+            struct band_entry {
+                work_queue_item_t* item;
+                unsigned long queued;
+            };
+
+            /**
+             * The statistics of one band
+             */
+            struct band_stats {
+                atomic_uint32_t queued;
+                atomic_uint32_t worked;
+                atomic_uint32_t aged;
+                atomic_uint32_t max_wait;
+                atomic_uint32_t max_latency;
+                basic_atomic_gcc<uint64_t> sum_wait;
+                basic_atomic_gcc<uint64_t> sum_latency;
+
+                band_stats() : queued(0), worked(0), aged(0), max_wait(0), max_latency(0),
+                    sum_wait(0), sum_latency(0) { }
+
+                void reset();
+            };
+        private:
+            /**
+             * The queues for all bands, the last band is the highest
+             */
+            std::vector<queue_t*> m_vBands;
+            /**
+             * The statistics for all bands
+             */
+            band_stats* m_pStats;
+            /**
+             * Count all items in all bands and the wake ups, the workers wait on this
+             */
+            counting_semaphore_t m_semItems;
+            /**
+             * Vector for all workqueue threads
+             */
+            std::vector<work_queue_task*> m_Workers;
+
+            uint8_t m_uiBands;
+            uint8_t m_uiMaxWorkers;
+            uint8_t m_uiMaxBandItems;
+            volatile uint32_t m_uiAgingTime;
+        };
+
+        using prio_engine_workqueue_t = basic_work_queue_prio;
+    }
+}
+
+#endif
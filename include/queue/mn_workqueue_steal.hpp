@@ -0,0 +1,261 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_STEAL_
+#define MINLIB_ESP32_WORK_QUEUE_STEAL_
+
+#include "mn_workqueue.hpp"
+#include "mn_workqueue_deque.hpp"
+#include <vector>
+
+namespace mn {
+    namespace queue {
+        class basic_work_queue_steal;
+
+        /**
+         * The worker task for the work stealing workqueue engine, each
+         * worker owns a work stealing deque
+         *
+         * @ingroup queue
+         */
+        class work_steal_task : public basic_task {
+            friend class basic_work_queue_steal;
+        public:
+            using deque_type = basic_work_deque<work_queue_item_t*,
+                                    MN_THREAD_CONFIG_WORKQUEUE_STEAL_DEQUE_SIZE>;
+            /**
+             * Constructor for this workqueue task.
+             *
+             * @param strName Name of the task. Only useful for debugging.
+             * @param uiPriority FreeRTOS priority of this Task.
+             * @param usStackDepth Number of "words" allocated for the Task stack.
+             * @param parent The work stealing workqueue for this worker Task
+             * @param uiIndex The index of this worker in the parent
+             */
+            work_steal_task(char const* strName, basic_task::priority uiPriority,
+                            unsigned short  usStackDepth,
+                            basic_work_queue_steal* parent, uint8_t uiIndex);
+
+            virtual ~work_steal_task();
+        protected:
+            /**
+             * The worker loop: run the own items, then the queued items and
+             * then steal from the other workers - when no item found, park
+             * and wait for a task notification
+             */
+            virtual void* on_task();
+
+            /**
+             * Get the next random number for the victim selection (xorshift32)
+             */
+            uint32_t next_random();
+        private:
+            /**
+             * Holder of the work stealing workqueue for this worker thread
+             */
+            basic_work_queue_steal* m_parentWorkQueue;
+            /**
+             * The deque for the items, spawned from this worker
+             */
+            deque_type m_deque;
+            /**
+             * Is this worker parked and wait for a notification
+             */
+            basic_atomic_gcc<bool> m_bParked;
+            /**
+             * The state for the random victim selection
+             */
+            uint32_t m_uiRandom;
+            /**
+             * The index of this worker in the parent
+             */
+            uint8_t m_uiIndex;
+            /**
+             * Was the worker started, only a started worker can joined
+             */
+            bool m_bStarted;
+        };
+
+        /**
+         * This class is the work stealing "engine" for work_queue_items.
+         *
+         * Each worker has a own lock free deque. Items queued from a worker
+         * (i.e. from on_work) are pushed to the worker's deque (LIFO), items
+         * from other tasks are queued into the shared queue. A worker without
+         * items steals the oldest item from a random other worker, a worker
+         * without any item parks and waits for a task notification.
+         *
+         * For fork-join: queue the child items from on_work and call
+         * try_run_one until the children are done, the worker runs then
+         * other items and blocks not.
+         *
+         * @ingroup queue
+         */
+        class basic_work_queue_steal : public basic_work_queue {
+            friend class work_steal_task;
+        public:
+            /**
+             * Our constructor.
+             *
+             * @param uiPriority FreeRTOS priority of the worker tasks.
+             * @param usStackDepth Number of "words" allocated for the task stack.
+             * @param uiMaxWorkItems Maximum number of items in the shared queue
+             * @param uiMaxWorkers How many Worker tasks run with this workqueue
+             */
+            basic_work_queue_steal(basic_task::priority uiPriority = MN_THREAD_CONFIG_WORKQUEUE_STEAL_PRIORITY,
+                        uint16_t usStackDepth = MN_THREAD_CONFIG_WORKQUEUE_STEAL_STACKSIZE,
+                        uint8_t uiMaxWorkItems = MN_THREAD_CONFIG_WORKQUEUE_STEAL_MAXITEMS,
+                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_STEAL_WORKER);
+
+            /**
+             * Our destructor.
+             */
+            ~basic_work_queue_steal();
+
+            /**
+             * Send a work_queue_item_t off to be executed. From a worker of this
+             * workqueue the item is pushed to the worker's deque (when the deque
+             * and the shared queue are full the worker runs the item self), from
+             * other tasks the item is queued to the shared queue.
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @note This function may block if the shared queue is presently full, 
+             * a worker of this workqueue is never blocked.
+             *
+             * @return
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added
+             *  - ERR_WORKQUEUE_ADD If The work_queue_item_t are not added
+             */
+            virtual int queue(work_queue_item_t *work,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             * Send many work_queue_item_t off to be executed. From a worker of this
+             * workqueue the items are pushed to the worker's deque, from other tasks
+             * the items are queued as batches to the shared queue. A worker, that
+             * get a batch, push the rest of the batch to the own deque, so the other
+             * workers can steal it
+             *
+             * @see basic_work_queue::queue_bulk
+             */
+            virtual int queue_bulk(work_queue_item_t **items, uint32_t n,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT,
+                            uint32_t* queued = NULL) override;
+
+            /**
+             * Run one item from a worker of this workqueue, for waiting on
+             * child items without blocking the worker
+             *
+             * @return True when a item was run, false when no item found or
+             * the caller is not a worker of this workqueue
+             */
+            virtual bool try_run_one() override;
+
+            /**
+             * Get the real num worker tasks for this workqueue engine
+             */
+            uint8_t get_num_worker() const;
+            /**
+             * Get the num worker tasks for this workqueue engine
+             */
+            uint8_t get_num_max_worker() const;
+            /**
+             * How many items are stolen from other workers
+             */
+            uint32_t get_num_steals();
+        protected:
+            /**
+             * Create this work stealing work queue
+             *
+             * @param iCore run on whith core
+             * @return
+             *   - ERR_WORKQUEUE_OK The engine is created
+             *   - ERR_WORKQUEUE_WARNING Not all worker tasks are created
+             *   - ERR_WORKQUEUE_CANTCREATE The engine can not created
+             */
+            int create_engine(int iCore);
+
+            /**
+             * Destroy this work stealing work queue, the workers end after
+             * the current item and the not run items are released
+             */
+            void destroy_engine();
+
+            /**
+             * Get the worker object of the calling task
+             * @return The worker or NULL, when the caller is not a worker of this workqueue
+             */
+            work_steal_task* get_current_worker();
+
+            /**
+             * Find the next item for the worker: the own deque, the shared
+             * queue and then steal from a random worker
+             *
+             * @param worker The calling worker
+             * @return The item or NULL, when the item is the first of a batch, the
+             * rest of the batch is linked, that does not fit in the worker's deque
+             */
+            work_queue_item_t* find_work(work_steal_task* worker);
+
+            /**
+             * Push a item from a worker to the worker's deque, when the deque is
+             * full to the shared queue and when the shared queue is full the 
+             * worker runs the item self
+             * 
+             * @note The item must be counted as pending
+             */
+            void push_or_run(work_steal_task* worker, work_queue_item_t *work);
+
+            /**
+             * Wake a parked worker, the next due delayed item is changed
+             */
+            virtual void wake_for_timer() override;
+
+            /**
+             * Queue a due delayed item to the shared queue, never to the deque of
+             * the servicing worker - so the item is never run with the timer lock
+             */
+            virtual int queue_due(work_queue_item_t *work) override;
+
+            /**
+             * Wake one parked worker with a task notification
+             */
+            void wake_one();
+        private:
+            /**
+             * Vector for all workqueue threads
+             */
+            std::vector<work_steal_task*> m_Workers;
+            /**
+             * Holder of num worker threads for this workqueue engine
+             */
+            uint8_t m_uiMaxWorkers;
+            /**
+             * How many workers are parked
+             */
+            atomic_uint32_t m_uiParked;
+            /**
+             * How many items are stolen
+             */
+            atomic_uint32_t m_uiSteals;
+        };
+
+        using steal_engine_workqueue_t = basic_work_queue_steal;
+    }
+}
+
+#endif
@@ -0,0 +1,225 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_STRAND_
+#define MINLIB_ESP32_WORK_QUEUE_STRAND_
+
+#include "mn_workqueue.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * A strand is a serial queue on the workers of a work queue: the items
+         * posted to one strand run one after the other in the post order, never
+         * concurrently - but on any worker of the work queue. So many devices 
+         * can share one worker pool, with a strand for each device.
+         *
+         * The strand is a work item self and is queued to the work queue, when
+         * the first item is posted. Posting is lock free: the producers push the
+         * items on a atomic list, the running strand takes the whole list.
+         * After MN_THREAD_CONFIG_WORKQUEUE_STRAND_BATCH items the strand is
+         * queued again, so the other items of the work queue are not starved.
+         *
+         * @code
+         *  basic_work_queue_multi workqueue(...);
+         *  basic_work_strand i2c(workqueue);
+         * 
+         *  i2c.post(&readTemp);
+         *  i2c.post_fn([]() { return write_display(); });
+         * @endcode
+         *
+         * @note The items of a strand are counted in the strand (get_num_items_worked),
+         * the work queue counts each run of the strand as one item. The strand 
+         * must be idle befor it is destroyed
+         * 
+         * @ingroup queue
+         */
+        class basic_work_strand : public work_queue_item {
+        public:
+            /**
+             * Our constructor.
+             *
+             * @param queue The work queue for the strand, must be created befor post
+             * @param uiBatch How many items run in one go
+             */
+            explicit basic_work_strand(basic_work_queue& queue, 
+                                       uint8_t uiBatch = MN_THREAD_CONFIG_WORKQUEUE_STRAND_BATCH);
+
+            basic_work_strand(const basic_work_strand&) = delete;
+            basic_work_strand& operator = (const basic_work_strand&) = delete;
+
+            /**
+             * Post a item to the strand, it runs after all items posted befor
+             * 
+             * @param work The item, must not be in a other queue or strand
+             * @param timeout How long to wait, when the strand must be queued
+             * and the work queue is full - after the timeout the strand runs 
+             * in the calling task
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The item is posted
+             *  - ERR_WORKQUEUE_ADD The item is NULL
+             */
+            int post(work_queue_item_t* work, 
+                     unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
+
+            /**
+             * Post a callable to the strand, the item is created in the item 
+             * pool of the work queue
+             * 
+             * @return 
+             *  - ERR_WORKQUEUE_OK The callable is posted
+             *  - ERR_WORKQUEUE_ADD The item pool is empty
+             */
+            template <class TFn>
+            int post_fn(TFn fn, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                work_queue_item_t* _item = m_pQueue->create_item<work_queue_fn_item<TFn>>(mn::move(fn));
+                if(_item == NULL) return ERR_WORKQUEUE_ADD;
+
+                return post(_item, timeout);
+            }
+
+            /**
+             * Has the strand no posted item, that is not finished
+             */
+            bool is_idle() { return m_uiCount.load() == 0; }
+            /**
+             * How many items are posted and not finished
+             */
+            uint32_t get_num_items_pending() { return m_uiCount.load(); }
+            /**
+             * How many items are sucessfull worked
+             */
+            uint64_t get_num_items_worked() { return m_uiNumWorks.load(); }
+            /**
+             * How many items are not sucessfull worked
+             */
+            uint64_t get_num_items_error() { return m_uiErrorsNumWorks.load(); }
+
+            /**
+             * Get the work queue of this strand
+             */
+            basic_work_queue* get_queue() { return m_pQueue; }
+
+            /**
+             * Run the posted items, called from a worker of the work queue
+             */
+            virtual bool on_work() override;
+        protected:
+            /**
+             * Take the next item, only from the running strand
+             * @return The next item in post order or NULL
+             */
+            work_queue_item_t* next_item();
+            /**
+             * Queue the strand to the work queue, or run it here when the queue is full
+             */
+            void schedule(unsigned int timeout);
+        private:
+            /**
+             * The work queue
+             */
+            basic_work_queue* m_pQueue;
+            /**
+             * The posted items, the last posted first
+             */
+            basic_atomic_gcc<work_queue_item_t*> m_pPosted;
+            /**
+             * The taken items in post order, only used from the running strand
+             */
+            work_queue_item_t* m_pReady;
+            /**
+             * The posted and not finished items, the strand is queued on 0 -> 1
+             */
+            atomic_uint32_t m_uiCount;
+            /**
+             * The successfull and the not successfull worked items
+             */
+            basic_atomic_gcc<uint64_t> m_uiNumWorks;
+            basic_atomic_gcc<uint64_t> m_uiErrorsNumWorks;
+
+            uint8_t m_uiBatch;
+        };
+
+        /**
+         * A fixed set of strands on one work queue, a item is posted to the 
+         * strand of a key (i.e. the device id): key % number of strands. Items
+         * with the same key run serial, other keys can run parallel
+         * 
+         * @ingroup queue
+         */
+        class basic_work_strand_set {
+        public:
+            /**
+             * Our constructor, all strands are allocated here
+             *
+             * @param queue The work queue for the strands
+             * @param uiStrands The number of strands, min 1
+             */
+            basic_work_strand_set(basic_work_queue& queue, uint16_t uiStrands);
+            /**
+             * Delete the strands, all strands must be idle
+             */
+            ~basic_work_strand_set();
+
+            basic_work_strand_set(const basic_work_strand_set&) = delete;
+            basic_work_strand_set& operator = (const basic_work_strand_set&) = delete;
+
+            /**
+             * Post a item to the strand of the key
+             * @see basic_work_strand::post
+             */
+            int post(uint32_t uiKey, work_queue_item_t* work, 
+                     unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return get_strand(uiKey)->post(work, timeout);
+            }
+            /**
+             * Post a callable to the strand of the key
+             * @see basic_work_strand::post_fn
+             */
+            template <class TFn>
+            int post_fn(uint32_t uiKey, TFn fn, 
+                        unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return get_strand(uiKey)->post_fn(mn::move(fn), timeout);
+            }
+
+            /**
+             * Get the strand of a key
+             */
+            basic_work_strand* get_strand(uint32_t uiKey) { 
+                return m_pStrands[uiKey % m_uiStrands]; 
+            }
+            /**
+             * Get the number of strands
+             */
+            uint16_t get_num_strands() const { return m_uiStrands; }
+
+            /**
+             * Are all strands idle
+             */
+            bool is_idle();
+        private:
+            basic_work_strand** m_pStrands;
+            uint16_t m_uiStrands;
+        };
+
+        using work_strand_t = basic_work_strand;
+        using work_strand_set_t = basic_work_strand_set;
+    }
+}
+
+#endif
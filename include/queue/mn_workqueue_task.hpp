@@ -46,6 +46,15 @@ namespace mn {
 
                 virtual ~work_queue_task();
 
+                /**
+                 * Start the worker and remember it for is_started
+                 */
+                virtual int start(int uiCore = MN_THREAD_CONFIG_DEFAULT_CORE) override;
+
+                /**
+                 * Was the worker started, only a started worker can joined
+                 */
+                bool is_started() const { return m_bStarted; }
             protected:
                 /**
                  * Implementation of your actual work queue working code ( Omg ...)
@@ -57,6 +66,10 @@ namespace mn {
                  * Holder of the base work_queue for this worker thread
                  */
                 basic_work_queue* m_parentWorkQueue;
+                /**
+                 * Was the worker started
+                 */
+                bool m_bStarted;
         };
     }
 }
@@ -19,6 +19,7 @@
 #define _MINLIB_CITCALLOCK_NEW_H_
 
 #include "mn_system_lock.hpp"
+#include <limits.h>
 
 
 namespace mn {
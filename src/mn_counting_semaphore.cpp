@@ -36,9 +36,8 @@ namespace mn {
         m_pSpinlock = xSemaphoreCreateCounting(m_uiMaxCount, m_uiCount);
       #endif
 
-        if (m_pSpinlock) {
-          unlock();
-        } else {
+        // the semaphore is created with the initial count, no give here
+        if (m_pSpinlock == NULL) {
           THROW_LOCK_EXP(ERR_SPINLOCK_CANTCREATESPINLOCK);
         }
       }
@@ -0,0 +1,152 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "mn_future.hpp"
+
+namespace mn {
+    namespace {
+        /**
+         * A waiting task, on the stack of the task while it waits
+         */
+        struct future_waiter {
+            TaskHandle_t task;
+            basic_atomic_gcc<bool> fired;
+
+            explicit future_waiter(TaskHandle_t hTask) : task(hTask), fired(false) { }
+        };
+    }
+
+    //-----------------------------------
+    //  wait
+    //-----------------------------------
+    int basic_future_state_base::wait(unsigned int timeout) {
+        if(is_ready()) return ERR_FUTURE_OK;
+
+        future_waiter _waiter(xTaskGetCurrentTaskHandle());
+
+        uintptr_t _expected = Empty;
+        uintptr_t _desired = reinterpret_cast<uintptr_t>(&_waiter);
+
+        if(!m_uiWaiter.compare_exchange_strong(_expected, _desired, memory_order::AcqRel))
+            return (_expected == Ready) ? ERR_FUTURE_OK : ERR_FUTURE_BUSY;
+
+        TickType_t _start = xTaskGetTickCount();
+
+        // a other notification of this task wakes too, wait again for the rest
+        while(!_waiter.fired.load(memory_order::Acquire)) {
+            TickType_t _wait = timeout;
+
+            if(timeout != portMAX_DELAY) {
+                TickType_t _elapsed = xTaskGetTickCount() - _start;
+                if(_elapsed >= timeout) break;
+                _wait = timeout - _elapsed;
+            }
+            ulTaskNotifyTake(pdTRUE, _wait);
+        }
+        if(_waiter.fired.load(memory_order::Acquire)) return ERR_FUTURE_OK;
+
+        // the timeout: take the waiter back
+        _expected = reinterpret_cast<uintptr_t>(&_waiter);
+        _desired = Empty;
+
+        if(m_uiWaiter.compare_exchange_strong(_expected, _desired, memory_order::AcqRel))
+            return ERR_FUTURE_TIMEOUT;
+
+        // the setter has the waiter and wakes it now, the waiter is on this stack
+        while(!_waiter.fired.load(memory_order::Acquire))
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        return ERR_FUTURE_OK;
+    }
+
+    //-----------------------------------
+    //  then
+    //-----------------------------------
+    int basic_future_state_base::then(queue::basic_work_queue& workqueue, queue::work_queue_item_t* item) {
+        // claim the word first, only the claimer writes the continuation
+        uintptr_t _expected = Empty;
+        uintptr_t _desired = Claiming;
+
+        if(!m_uiWaiter.compare_exchange_strong(_expected, _desired, memory_order::AcqRel)) {
+            if(_expected != Ready) return ERR_FUTURE_BUSY;
+
+            queue_then(&workqueue, item);
+            return ERR_FUTURE_OK;
+        }
+        // written befor the publish, read from the setter after Then
+        m_pThenQueue = &workqueue;
+        m_pThenItem = item;
+
+        _expected = Claiming;
+        _desired = Then;
+
+        if(m_uiWaiter.compare_exchange_strong(_expected, _desired, memory_order::AcqRel))
+            return ERR_FUTURE_OK;
+
+        // the value was set while claiming, the setter leaves the continuation to us
+        queue_then(&workqueue, item);
+        return ERR_FUTURE_OK;
+    }
+
+    //-----------------------------------
+    //  reset
+    //-----------------------------------
+    void basic_future_state_base::reset() {
+        m_pThenQueue = NULL;
+        m_pThenItem = NULL;
+
+        m_uiWaiter.store(Empty);
+        m_bSet.store(false);
+    }
+
+    //-----------------------------------
+    //  make_ready
+    //-----------------------------------
+    void basic_future_state_base::make_ready() {
+        uintptr_t _old = m_uiWaiter.exchange(Ready, memory_order::AcqRel);
+
+        // with Claiming the continuation is queued from then
+        if(_old == Empty || _old == Claiming) return;
+
+        if(_old == Then) {
+            // the state lives until the continuation runs
+            queue_then(m_pThenQueue, m_pThenItem);
+        } else {
+            // the waiting task can return after fired, do not touch the waiter then
+            future_waiter* _waiter = reinterpret_cast<future_waiter*>(_old);
+            TaskHandle_t _task = _waiter->task;
+
+            _waiter->fired.store(true, memory_order::Release);
+            xTaskNotifyGive(_task);
+        }
+    }
+
+    //-----------------------------------
+    //  queue_then
+    //-----------------------------------
+    void basic_future_state_base::queue_then(queue::basic_work_queue* workqueue, 
+                                             queue::work_queue_item_t* item) {
+        if(workqueue->queue(item, 0) == ERR_WORKQUEUE_OK) return;
+
+        // the queue is full, run the continuation here
+        bool _delete = item->can_delete();
+        item->on_work();
+
+        if(_delete && item->can_release()) item->release();
+    }
+}
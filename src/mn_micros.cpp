@@ -15,11 +15,14 @@
 *License along with the Mini Thread  Library; if not, see
 *<https://www.gnu.org/licenses/>.  
 */
+#include "mn_config.hpp"
 #include "mn_micros.hpp"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+
+#if MN_THREAD_CONFIG_BOARD != MN_THREAD_CONFIG_LINUX
 #include "esp_log.h"
 #include "esp_err.h"
 #include "nvs_flash.h"
@@ -28,9 +31,18 @@
 
 #include "esp_attr.h"
 #include "esp_partition.h"
+#endif
 #include <sys/time.h>
 
 namespace mn {
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+  //-----------------------------------
+  //  micros
+  //-----------------------------------
+  unsigned long micros() {
+      return (unsigned long)mn_port_micros();
+  }
+#else
   portMUX_TYPE microsMux = portMUX_INITIALIZER_UNLOCKED;
   
   //-----------------------------------
@@ -49,6 +61,7 @@ namespace mn {
       portEXIT_CRITICAL_ISR(&microsMux);
       return overflow + (ccount / CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ);
   }
+#endif
 
   //-----------------------------------
   //  millis
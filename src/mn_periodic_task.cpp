@@ -0,0 +1,138 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "mn_periodic_task.hpp"
+#include "mn_micros.hpp"
+
+#include <string.h>
+
+namespace mn {
+    //-----------------------------------
+    //  constructor
+    //-----------------------------------
+    basic_periodic_task::basic_periodic_task(std::string strName, unsigned int uiPeriod, unsigned int uiPhase,
+                                             unsigned int uiDeadline, basic_task::priority uiPriority,
+                                             unsigned short usStackDepth)
+        : basic_task(strName, uiPriority, usStackDepth), 
+          m_uiPeriod((uiPeriod > 0) ? uiPeriod : 1), 
+          m_uiPhase(uiPhase),
+          m_uiDeadline((uiDeadline > 0) ? uiDeadline : m_uiPeriod),
+          m_ePolicy(SkipMissed), 
+          m_bStop(false) {
+
+        reset_stats();
+    }
+
+    //-----------------------------------
+    //  get_stats
+    //-----------------------------------
+    periodic_stats basic_periodic_task::get_stats() {
+        automutx_t lock(m_statsLock);
+        return m_stats;
+    }
+
+    //-----------------------------------
+    //  reset_stats
+    //-----------------------------------
+    void basic_periodic_task::reset_stats() {
+        automutx_t lock(m_statsLock);
+
+        memset(&m_stats, 0, sizeof(periodic_stats));
+        m_stats.jitter_min = UINT32_MAX;
+    }
+
+    //-----------------------------------
+    //  ticks_to_us
+    //-----------------------------------
+    static inline uint64_t ticks_to_us(uint64_t ticks) {
+        // exact for all tick rates, portTICK_PERIOD_MS is 0 above 1000 Hz
+        return (ticks * 1000000ULL) / configTICK_RATE_HZ;
+    }
+
+    //-----------------------------------
+    //  on_task
+    //-----------------------------------
+    void* basic_periodic_task::on_task() {
+        uint64_t _periodUs = ticks_to_us(m_uiPeriod);
+        if(_periodUs == 0) _periodUs = 1;
+
+        m_bStop = false;
+
+        // start on a tick, then the grid in micro seconds has the phase of the wake ups
+        TickType_t _wake = xTaskGetTickCount();
+        vTaskDelayUntil(&_wake, 1);
+        unsigned long _base = micros();
+
+        // the release in ticks since the base, the grid is computed from the 
+        // ticks and not summed up, so a rounded period does not drift
+        uint64_t _offset = m_uiPhase;
+        if(m_uiPhase > 0) vTaskDelayUntil(&_wake, m_uiPhase);
+
+        while(!m_bStop) {
+            unsigned long _release = _base + (unsigned long)ticks_to_us(_offset);
+
+            unsigned long _start = micros();
+            bool _continue = on_period();
+            unsigned long _end = micros();
+
+            // the differences are signed, micros overflows
+            unsigned long _next = _base + (unsigned long)ticks_to_us(_offset + m_uiPeriod);
+            unsigned long _deadline = _base + (unsigned long)ticks_to_us(_offset + m_uiDeadline);
+            bool _overrun = (long)(_end - _next) >= 0;
+            bool _miss = (long)(_end - _deadline) > 0;
+
+            uint32_t _skipped = 0;
+            if(_overrun && m_ePolicy == SkipMissed)
+                _skipped = (uint32_t)((_end - _next) / _periodUs) + 1;
+
+            account((long)(_start - _release), _end - _start, _overrun, _miss, _skipped);
+            if(!_continue) break;
+
+            vTaskDelayUntil(&_wake, m_uiPeriod * (1 + _skipped));
+            _offset += (uint64_t)m_uiPeriod * (1 + _skipped);
+        }
+        return NULL;
+    }
+
+    //-----------------------------------
+    //  account
+    //-----------------------------------
+    void basic_periodic_task::account(long jitter, unsigned long exec, bool overrun, bool miss, uint32_t skipped) {
+        // the tick can wake a little before the grid
+        uint32_t _jitter = (jitter > 0) ? (uint32_t)jitter : 0;
+
+        int _bucket = 0;
+        if(_jitter > 0) _bucket = 32 - __builtin_clz(_jitter);
+        if(_bucket >= MN_THREAD_CONFIG_PERIODIC_HIST_BUCKETS) _bucket = MN_THREAD_CONFIG_PERIODIC_HIST_BUCKETS - 1;
+
+        automutx_t lock(m_statsLock);
+
+        m_stats.periods++;
+        if(overrun) m_stats.overruns++;
+        if(miss) m_stats.misses++;
+        m_stats.skipped += skipped;
+
+        if(_jitter < m_stats.jitter_min) m_stats.jitter_min = _jitter;
+        if(_jitter > m_stats.jitter_max) m_stats.jitter_max = _jitter;
+        m_stats.jitter_sum += _jitter;
+        m_stats.jitter_hist[_bucket]++;
+
+        if(exec > m_stats.exec_max) m_stats.exec_max = (uint32_t)exec;
+        m_stats.exec_sum += exec;
+    }
+}
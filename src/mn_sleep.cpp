@@ -15,11 +15,14 @@
 *License along with the Mini Thread  Library; if not, see
 *<https://www.gnu.org/licenses/>.  
 */
+#include "mn_config.hpp"
 #include "mn_sleep.hpp"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+
+#if MN_THREAD_CONFIG_BOARD != MN_THREAD_CONFIG_LINUX
 #include "esp_log.h"
 #include "esp_err.h"
 #include "nvs_flash.h"
@@ -29,7 +32,9 @@
 
 #include "esp_attr.h"
 #include "esp_partition.h"
+#endif
 #include <sys/time.h>
+#include <errno.h>
 
 namespace mn {
 	//-----------------------------------
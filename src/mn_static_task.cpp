@@ -0,0 +1,94 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "mn_static_task.hpp"
+
+#include <string.h>
+
+namespace mn {
+    //-----------------------------------
+    //  constructor
+    //-----------------------------------
+    basic_static_task_base::basic_static_task_base(const char* strName, basic_task::priority uiPriority)
+        : m_uiPriority(uiPriority), m_pHandle(NULL) {
+
+        strncpy(m_strName, (strName != NULL) ? strName : "", sizeof(m_strName) - 1);
+        m_strName[sizeof(m_strName) - 1] = '\0';
+    }
+
+    //-----------------------------------
+    //  deconstructor
+    //-----------------------------------
+    basic_static_task_base::~basic_static_task_base() {
+        join(portMAX_DELAY);
+    }
+
+    //-----------------------------------
+    //  create
+    //-----------------------------------
+    int basic_static_task_base::create(TaskFunction_t pStub, StackType_t* pStack,
+                                       uint32_t uiStackDepth, int iCore) {
+        if(m_pHandle != NULL)
+            return ERR_TASK_ALREADYRUNNING;
+
+        m_stateDone.reset();
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        m_pHandle = xTaskCreateStaticPinnedToCore(pStub, m_strName, uiStackDepth,
+                    this, (int)m_uiPriority, pStack, &m_TaskBuffer, iCore);
+    #else
+        (void)pStack;
+        xTaskCreatePinnedToCore(pStub, m_strName, uiStackDepth,
+                    this, (int)m_uiPriority, &m_pHandle, iCore);
+    #endif
+
+        return (m_pHandle == NULL) ? ERR_TASK_CANTSTARTTHREAD : ERR_TASK_OK;
+    }
+
+    //-----------------------------------
+    //  finished
+    //-----------------------------------
+    void basic_static_task_base::finished() {
+        m_stateDone.set_value();
+
+        // the joiner deletes the task, a suspended task is not on a cpu
+        for(;;) vTaskSuspend(NULL);
+    }
+
+    //-----------------------------------
+    //  join
+    //-----------------------------------
+    int basic_static_task_base::join(unsigned int timeout) {
+        if(m_pHandle == NULL)
+            return ERR_TASK_NOTRUNNING;
+
+        if(m_stateDone.wait(timeout) != ERR_FUTURE_OK)
+            return ERR_TASK_TIMEOUT;
+
+        // the task is woken the joiner, wait until it is suspended - the
+        // joiner can have a higher priority, so sleep after some yields
+        for(int i = 0; eTaskGetState(m_pHandle) != eSuspended; i++) {
+            if(i < 16) taskYIELD();
+            else vTaskDelay(1);
+        }
+        vTaskDelete(m_pHandle);
+        m_pHandle = NULL;
+
+        return ERR_TASK_OK;
+    }
+}
@@ -24,15 +24,27 @@
 
 #include "mn_task_list.hpp"
 
-
+#if( MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX < 0 )
+  /** get_self is disabled by the user config and returns always NULL */
+  #define MN_THREAD_TASK_SELF_TLS 0
+#elif( configNUM_THREAD_LOCAL_STORAGE_POINTERS > MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX )
+  /** get_self use the thread local storage pointer */
+  #define MN_THREAD_TASK_SELF_TLS 1
+#elif( MN_THREAD_CONFIG_TASK_SELF_TLS_REQUIRED == MN_THREAD_CONFIG_YES )
+  #error "MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX is out of range: set CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS to 2 or more"
+#else
+  #warning "MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX is out of range, basic_task::get_self returns always NULL: set CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS to 2 or more"
+  #define MN_THREAD_TASK_SELF_TLS 0
+#endif
 
 namespace mn {
+  basic_task::exit_hook* basic_task::m_pExitHooks = NULL;
+
   namespace internal {
     int32_t __id_rnioeu = 0;
 
     inline int32_t get_new_id() {
-      __id_rnioeu++;
-      return __id_rnioeu;
+      return __atomic_add_fetch(&__id_rnioeu, 1, __ATOMIC_RELAXED);
     }
   }
   //-----------------------------------
@@ -53,7 +65,13 @@ namespace mn {
           m_pHandle(NULL),
           m_pChild(NULL),
           m_pParent(NULL),
-          m_event() { }
+          m_event(),
+          m_pListNext(),
+          m_pListPrev(),
+          m_iListId(0),
+          m_uiListNameHash(0),
+          m_bInTaskList(false),
+          m_pJoinWaiter(NULL) { }
 
   //-----------------------------------
   //  deconstrutor
@@ -63,9 +81,9 @@ namespace mn {
       vTaskDelete(m_pHandle);
     
 
-  #if MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST == MN_THREAD_CONFIG_YES
-    basic_task_list::instance().remove_task(this);
-  #endif
+    // a task can be added by hand, so remove it always
+    if(m_bInTaskList)
+      basic_task_list::instance().remove_task(this);
   }
 
   //-----------------------------------
@@ -123,10 +141,13 @@ namespace mn {
     }
     m_runningMutex.unlock();
 
+    // a task can start again, the events of the last run are gone
+    m_event.clear(EventStarted | EventJoin);
+
     #if( configSUPPORT_STATIC_ALLOCATION == 1 )
-      xTaskCreateStaticPinnedToCore(&runtaskstub, m_strName.c_str(),
+      m_pHandle = xTaskCreateStaticPinnedToCore(&runtaskstub, m_strName.c_str(),
                   m_usStackDepth,
-                  this, (int)m_uiPriority, &m_pHandle, m_stackBuffer, m_TaskBuffer m_iCore);
+                  this, (int)m_uiPriority, m_stackBuffer, &m_TaskBuffer, m_iCore);
     #else
       xTaskCreatePinnedToCore(&runtaskstub, m_strName.c_str(),
                   m_usStackDepth,
@@ -162,9 +183,102 @@ namespace mn {
   //  join
   //-----------------------------------
   void basic_task::join(unsigned int timeout) {
-    while(m_event.wait(EventJoin | EventStarted, false, true, timeout) == 0) { 
+    while( (m_event.wait(EventJoin, false, true, timeout) & EventJoin) == 0) { 
+
+    }
+  }
+
+  //-----------------------------------
+  //  join_all
+  //-----------------------------------
+  int basic_task::join_all(basic_task* const* tasks, size_t count, unsigned int timeout, bool* finished) {
+    return join_many(tasks, count, timeout, true, finished, NULL);
+  }
+
+  //-----------------------------------
+  //  join_any
+  //-----------------------------------
+  int basic_task::join_any(basic_task* const* tasks, size_t count, unsigned int timeout,
+                           int* index, bool* finished) {
+    return join_many(tasks, count, timeout, false, finished, index);
+  }
+
+  //-----------------------------------
+  //  join_many
+  //-----------------------------------
+  int basic_task::join_many(basic_task* const* tasks, size_t count, unsigned int timeout,
+                            bool waitAll, bool* finished, int* index) {
+    join_waiter _waiter = { xTaskGetCurrentTaskHandle(), 0 };
+    uint32_t _registered = 0, _consumed = 0, _ending = 0;
+    size_t _done = 0;
+    int _first = -1;
+
+    // the ending tasks take the waiter under the running mutex
+    for(size_t i = 0; i < count; i++) {
+      autolock_t autolock(tasks[i]->m_runningMutex);
+
+      if(tasks[i]->m_event.get() & EventJoin) continue;
+      // the waiter was already taken, EventJoin follows without a notification
+      if(tasks[i]->is_ending()) { _ending++; continue; }
+
+      tasks[i]->m_pJoinWaiter = &_waiter;
+      _registered++;
+    }
+
+    TickType_t _start = xTaskGetTickCount();
+
+    for(;;) {
+      _done = 0;
+      for(size_t i = 0; i < count; i++) {
+        bool _ended = (tasks[i]->m_event.get() & EventJoin) != 0;
+        
+        if(_ended) { 
+          _done++; 
+          if(_first == -1) _first = (int)i; 
+        }
+        if(finished != NULL) finished[i] = _ended;
+      }
+      if(waitAll ? (_done == count) : (_done > 0 || count == 0)) break;
+
+      TickType_t _waited = xTaskGetTickCount() - _start;
+      if(timeout != portMAX_DELAY && _waited >= timeout) break;
+
+      TickType_t _wait = (timeout == portMAX_DELAY) ? portMAX_DELAY : timeout - _waited;
+      // poll the ending tasks, they signal only with EventJoin
+      if(_ending > 0) {
+        _ending = 0;
+        for(size_t i = 0; i < count; i++) {
+          autolock_t autolock(tasks[i]->m_runningMutex);
+          if((tasks[i]->m_event.get() & EventJoin) == 0 && tasks[i]->is_ending()) _ending++;
+        }
+        if(_ending > 0) _wait = 1;
+      }
+      if(ulTaskNotifyTake(pdFALSE, _wait) != 0)
+        _consumed++;
+    }
+
+    // the not taken waiters are removed, the taken are signaled soon
+    uint32_t _taken = _registered;
+    for(size_t i = 0; i < count; i++) {
+      autolock_t autolock(tasks[i]->m_runningMutex);
 
+      if(tasks[i]->m_pJoinWaiter != &_waiter) continue;
+      tasks[i]->m_pJoinWaiter = NULL;
+      _taken--;
     }
+    for(int i = 0; __atomic_load_n(&_waiter.signaled, __ATOMIC_ACQUIRE) != _taken; i++) {
+      if(i < 16) taskYIELD();
+      else vTaskDelay(1);
+    }
+
+    // take exactly the notifications of the tasks, the others stay
+    for(; _consumed < _taken; _consumed++) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    for(; _consumed > _taken; _consumed--) xTaskNotifyGive(_waiter.handle);
+
+    if(index != NULL) *index = _first;
+
+    if(waitAll) return (_done == count) ? ERR_TASK_OK : ERR_TASK_TIMEOUT;
+    return (_first != -1) ? ERR_TASK_OK : ERR_TASK_TIMEOUT;
   }
   //-----------------------------------
   //  join
@@ -181,7 +295,7 @@ namespace mn {
   //  wait
   //-----------------------------------
   void basic_task::wait(unsigned int timeout) {
-    while(m_event.wait(EventJoin | EventStarted, false, true, timeout) == 0) { 
+    while( (m_event.wait(EventStarted, false, true, timeout) & EventStarted) == 0) { 
 
     }
   }
@@ -209,12 +323,27 @@ namespace mn {
 
       return ERR_TASK_NOTRUNNING;
     }
-    vTaskDelete(m_pHandle); m_pHandle = 0;
+    // no exit hooks here: the killed task can be in the middle of a hook
+    // protected operation until the delete takes effect
+    vTaskDelete(m_pHandle); 
+
+    m_pHandle = 0;
     m_bRunning = false;
     on_kill();
 
+    join_waiter* _waiter = m_pJoinWaiter;
+    m_pJoinWaiter = NULL;
+
     m_runningMutex.unlock();
     m_continuemutex.unlock();
+
+    // the killed task ends never self, signal the join like runtaskstub
+    m_event.set(EventJoin);
+
+    if(_waiter != NULL) {
+      xTaskNotifyGive(_waiter->handle);
+      __atomic_add_fetch(&_waiter->signaled, 1, __ATOMIC_RELEASE);
+    }
     
     return ERR_TASK_OK;
   }
@@ -318,18 +447,13 @@ namespace mn {
   //  get_self
   //-----------------------------------
   basic_task* basic_task::get_self() {
-    auto _pHandle = xTaskGetCurrentTaskHandle();
-
-    if (_pHandle == 0) return NULL;
-    
-    basic_task* _task = new basic_task();
-
-    _task->m_runningMutex.lock();
-    _task->m_iID = -1;
-    _task->m_pHandle = _pHandle;
-    _task->m_runningMutex.unlock();
-
-    return _task;
+  #if MN_THREAD_TASK_SELF_TLS == 1
+    // set from runtaskstub, NULL for tasks not created with basic_task
+    return static_cast<basic_task*>(
+      pvTaskGetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX) );
+  #else
+    return NULL;
+  #endif
   }
 
   //-----------------------------------
@@ -358,6 +482,46 @@ namespace mn {
     vTaskResume(m_pHandle);
   }
 
+  //-----------------------------------
+  //  exit_hook_mutex
+  //-----------------------------------
+  mutex_t& basic_task::exit_hook_mutex() {
+    static mutex_t _mutex;
+    return _mutex;
+  }
+
+  //-----------------------------------
+  //  add_exit_hook
+  //-----------------------------------
+  void basic_task::add_exit_hook(exit_hook* hook) {
+    if(hook == NULL) return;
+
+    automutx_t lock(exit_hook_mutex());
+    hook->next = m_pExitHooks;
+    m_pExitHooks = hook;
+  }
+
+  //-----------------------------------
+  //  remove_exit_hook
+  //-----------------------------------
+  void basic_task::remove_exit_hook(exit_hook* hook) {
+    automutx_t lock(exit_hook_mutex());
+
+    for(exit_hook** _it = &m_pExitHooks; *_it != NULL; _it = &(*_it)->next) {
+      if(*_it == hook) { *_it = hook->next; break; }
+    }
+  }
+
+  //-----------------------------------
+  //  call_exit_hooks
+  //-----------------------------------
+  void basic_task::call_exit_hooks(xTaskHandle handle) {
+    automutx_t lock(exit_hook_mutex());
+
+    for(exit_hook* _it = m_pExitHooks; _it != NULL; _it = _it->next)
+      _it->func(_it->arg, handle);
+  }
+
   //-----------------------------------
   //  runtaskstub
   //-----------------------------------
@@ -367,6 +531,10 @@ namespace mn {
 
     esp_task = (static_cast<basic_task*>(parm));
 
+  #if MN_THREAD_TASK_SELF_TLS == 1
+    vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX, esp_task);
+  #endif
+
     esp_task->m_event.set(EventStarted); 
 
     esp_task->m_runningMutex.lock();
@@ -380,14 +548,31 @@ namespace mn {
     ret = esp_task->on_task();
     esp_task->on_cleanup();
 
+    call_exit_hooks(xTaskGetCurrentTaskHandle());
+
     esp_task->m_runningMutex.lock();
     esp_task->m_bRunning = false;
     esp_task->m_retval = ret;
-    vTaskDelete(esp_task->m_pHandle);
     esp_task->m_pHandle = 0;
 
+    join_waiter* _waiter = esp_task->m_pJoinWaiter;
+    esp_task->m_pJoinWaiter = NULL;
+
     esp_task->m_runningMutex.unlock();
 
+  #if MN_THREAD_TASK_SELF_TLS == 1
+    vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TASK_SELF_TLS_INDEX, NULL);
+  #endif
+
+    // vTaskDelete does not return, signal the join before. After the join
+    // signal the object can be destroyed, so do not touch it anymore
     esp_task->m_event.set(EventJoin);
+
+    // the waiter of join_all / join_any is alive until signaled
+    if(_waiter != NULL) {
+      xTaskNotifyGive(_waiter->handle);
+      __atomic_add_fetch(&_waiter->signaled, 1, __ATOMIC_RELEASE);
+    }
+    vTaskDelete(NULL);
   }
 }
\ No newline at end of file
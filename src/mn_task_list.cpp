@@ -18,6 +18,8 @@
 #include "mn_task.hpp"
 #include "mn_task_list.hpp"
 
+#include <string.h>
+
 namespace mn {
     basic_task_list* basic_task_list::m_pInstance = NULL;
     mutex_t  basic_task_list::m_staticInstanceMux = mutex_t();
@@ -26,87 +28,172 @@ namespace mn {
     //  construtor
     //-----------------------------------
     basic_task_list::basic_task_list() 
-        : m_pLock(), m_mapTaskOnCore() {  }
+        : m_pLock(), m_pBuckets(), m_uiEpoch(0), m_uiReaders(), m_uiSize(0) {  }
 
     //-----------------------------------
     //  add_task
     //-----------------------------------
     void basic_task_list::add_task(basic_task* task) {
+        if(task == NULL) return;
+
         autolock_t lock(m_pLock);
 
-        if(task == NULL) return;
+        // a started again task has a new id, the readers must leave the old bucket first
+        if(task->m_bInTaskList) {
+            unlink_task(task);
+            synchronize();
+        }
+
+        task->m_iListId = task->m_iID;
+        task->m_uiListNameHash = hash_name(task->m_strName.c_str());
 
-        int core = task->get_on_core();
-        m_mapTaskOnCore[core].push_front(task);
+        link(task, IndexId, bucket_of((uint32_t)task->m_iListId));
+        link(task, IndexName, bucket_of(task->m_uiListNameHash));
+
+        task->m_bInTaskList = true;
+        __atomic_add_fetch(&m_uiSize, 1, __ATOMIC_RELAXED);
     }
 
     //-----------------------------------
     //  remove_task
     //-----------------------------------
     void basic_task_list::remove_task(basic_task* task) {
+        if(task == NULL) return;
+
         autolock_t lock(m_pLock);
 
-        if(task == NULL) return;
+        if(!task->m_bInTaskList) return;
 
-        int core = task->get_on_core();
-        m_mapTaskOnCore[core].remove(task);
+        unlink_task(task);
+        synchronize();
     } 
 
     //-----------------------------------
     //  get_task
     //-----------------------------------
     basic_task* basic_task_list::get_task(int id) {
-        basic_task* _ret = get_task(0);
-        if(_ret == NULL) _ret = get_task(1);
+        uint32_t _epoch = begin_read();
+
+        basic_task* _task = __atomic_load_n(&m_pBuckets[IndexId][bucket_of((uint32_t)id)], __ATOMIC_SEQ_CST);
+        while(_task != NULL && _task->m_iListId != id)
+            _task = next(_task, IndexId);
 
-        return _ret;
+        end_read(_epoch);
+        return _task;
     }
 
     //-----------------------------------
     //  get_task
     //-----------------------------------
-    basic_task* basic_task_list::get_task(std::string name) {
-        basic_task* _ret = get_task(name);
-        if(_ret == NULL) _ret = get_task(name);
+    basic_task* basic_task_list::get_task(const char* name) {
+        if(name == NULL) return NULL;
+
+        uint32_t _hash = hash_name(name);
+        uint32_t _epoch = begin_read();
 
-        return _ret;
+        basic_task* _task = __atomic_load_n(&m_pBuckets[IndexName][bucket_of(_hash)], __ATOMIC_SEQ_CST);
+        while(_task != NULL) {
+            if(_task->m_uiListNameHash == _hash && 
+               strcmp(_task->m_strName.c_str(), name) == 0) break;
+
+            _task = next(_task, IndexName);
+        }
+
+        end_read(_epoch);
+        return _task;
     }
 
     //-----------------------------------
-    //  get_task
+    //  begin_read
     //-----------------------------------
-    basic_task* basic_task_list::get_task(int core, int id) {
-        autolock_t lock(m_pLock);
+    uint32_t basic_task_list::begin_read() {
+        uint32_t _epoch = __atomic_load_n(&m_uiEpoch, __ATOMIC_ACQUIRE) & 1;
 
-        basic_task* _retTask = NULL;
+        // seq cst: a remove sees this reader or this reader sees the remove
+        __atomic_add_fetch(&m_uiReaders[_epoch], 1, __ATOMIC_SEQ_CST);
+        return _epoch;
+    }
 
-        for(std::list<basic_task*>::iterator i = m_mapTaskOnCore[core].begin();
-            i != m_mapTaskOnCore[core].end(); i++) {
+    //-----------------------------------
+    //  end_read
+    //-----------------------------------
+    void basic_task_list::end_read(uint32_t epoch) {
+        __atomic_sub_fetch(&m_uiReaders[epoch], 1, __ATOMIC_RELEASE);
+    }
 
-            if( (*i)->get_id() == id ) {
-                _retTask = (*i);
-                break;
+    //-----------------------------------
+    //  synchronize
+    //-----------------------------------
+    void basic_task_list::synchronize() {
+        // flip the epoch two times, a late reader of the old epoch can
+        // count himself after the first wait
+        for(int k = 0; k < 2; k++) {
+            uint32_t _old = __atomic_fetch_add(&m_uiEpoch, 1, __ATOMIC_SEQ_CST) & 1;
+
+            for(int i = 0; __atomic_load_n(&m_uiReaders[_old], __ATOMIC_SEQ_CST) != 0; i++) {
+                if(i < 16) taskYIELD();
+                else vTaskDelay(1);
             }
         }
-        return _retTask;
     }
 
     //-----------------------------------
-    //  get_task
+    //  next
     //-----------------------------------
-    basic_task* basic_task_list::get_task(int core, std::string name) {
-        autolock_t lock(m_pLock);
-        
-        basic_task* _retTask = NULL;
+    basic_task* basic_task_list::next(basic_task* task, int idx) {
+        return __atomic_load_n(&task->m_pListNext[idx], __ATOMIC_ACQUIRE);
+    }
 
-        for(std::list<basic_task*>::iterator i = m_mapTaskOnCore[core].begin();
-            i != m_mapTaskOnCore[core].end(); i++) {
+    //-----------------------------------
+    //  link
+    //-----------------------------------
+    void basic_task_list::link(basic_task* task, int idx, uint32_t bucket) {
+        basic_task* _head = m_pBuckets[idx][bucket];
 
-            if( (*i)->get_name() == name ) {
-                _retTask = (*i);
-                break;
-            }
+        task->m_pListPrev[idx] = NULL;
+        task->m_pListNext[idx] = _head;
+        if(_head != NULL) _head->m_pListPrev[idx] = task;
+
+        // publish the linked task
+        __atomic_store_n(&m_pBuckets[idx][bucket], task, __ATOMIC_SEQ_CST);
+    }
+
+    //-----------------------------------
+    //  unlink
+    //-----------------------------------
+    void basic_task_list::unlink(basic_task* task, int idx, uint32_t bucket) {
+        basic_task* _prev = task->m_pListPrev[idx];
+        basic_task* _next = task->m_pListNext[idx];
+
+        // the next link of the task stays, a reader on the task goes on
+        if(_prev != NULL) __atomic_store_n(&_prev->m_pListNext[idx], _next, __ATOMIC_RELEASE);
+        else __atomic_store_n(&m_pBuckets[idx][bucket], _next, __ATOMIC_SEQ_CST);
+
+        if(_next != NULL) _next->m_pListPrev[idx] = _prev;
+        task->m_pListPrev[idx] = NULL;
+    }
+
+    //-----------------------------------
+    //  unlink_task
+    //-----------------------------------
+    void basic_task_list::unlink_task(basic_task* task) {
+        unlink(task, IndexId, bucket_of((uint32_t)task->m_iListId));
+        unlink(task, IndexName, bucket_of(task->m_uiListNameHash));
+
+        task->m_bInTaskList = false;
+        __atomic_sub_fetch(&m_uiSize, 1, __ATOMIC_RELAXED);
+    }
+
+    //-----------------------------------
+    //  hash_name
+    //-----------------------------------
+    uint32_t basic_task_list::hash_name(const char* name) {
+        uint32_t _hash = 2166136261u;
+
+        while(*name != '\0') {
+            _hash ^= (uint8_t)(*name++);
+            _hash *= 16777619u;
         }
-        return _retTask;
+        return _hash;
     }
-}
\ No newline at end of file
+}
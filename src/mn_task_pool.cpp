@@ -0,0 +1,233 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "mn_task_pool.hpp"
+#include "mn_autolock.hpp"
+
+namespace mn {
+    //-----------------------------------
+    //  basic_pooled_task::constructor
+    //-----------------------------------
+    basic_pooled_task::basic_pooled_task(const char* strName, basic_task::priority uiPriority,
+                                         unsigned short usStackDepth, basic_task_pool* pool, int iSubPool)
+        : basic_task(strName, uiPriority, usStackDepth), m_pPool(pool), m_iSubPool(iSubPool),
+          m_pItem(NULL), m_bStop(false), m_uiNumRuns(0), m_pNextIdle(NULL) { }
+
+    //-----------------------------------
+    //  basic_pooled_task::hand
+    //-----------------------------------
+    void basic_pooled_task::hand(queue::work_queue_item_t* item) {
+        m_pItem = item;
+        xTaskNotifyGive(get_handle());
+    }
+
+    //-----------------------------------
+    //  basic_pooled_task::stop
+    //-----------------------------------
+    void basic_pooled_task::stop() {
+        m_bStop = true;
+        xTaskNotifyGive(get_handle());
+    }
+
+    //-----------------------------------
+    //  basic_pooled_task::on_task
+    //-----------------------------------
+    void* basic_pooled_task::on_task() {
+        queue::work_queue_item_t* _inplace = reinterpret_cast<queue::work_queue_item_t*>(&m_fnBlock);
+
+        for(;;) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            queue::work_queue_item_t* _item = m_pItem;
+            if(_item == NULL) {
+                if(m_bStop) break;
+                continue;
+            }
+            m_pItem = NULL;
+
+            _item->on_work();
+
+            // the item of run_fn is in this task, the others are released like in a work queue
+            if(_item == _inplace)
+                _item->~work_queue_item();
+            else if(_item->can_delete() && _item->can_release())
+                _item->release();
+
+            m_uiNumRuns++;
+            m_pPool->park(this);
+        }
+        return NULL;
+    }
+
+    //-----------------------------------
+    //  constructor
+    //-----------------------------------
+    basic_task_pool::basic_task_pool(basic_task::priority uiPriority, unsigned short usStackDepth)
+        : m_uiPriority(uiPriority), m_usStackDepth(usStackDepth) { }
+
+    //-----------------------------------
+    //  deconstructor
+    //-----------------------------------
+    basic_task_pool::~basic_task_pool() {
+        destroy();
+    }
+
+    //-----------------------------------
+    //  create
+    //-----------------------------------
+    int basic_task_pool::create(uint32_t uiPerCore, uint32_t uiUnpinned) {
+        if(is_created()) return ERR_TASKPOOL_OK;
+
+        int _cores = portNUM_PROCESSORS;
+
+        for(int i = 0; i < _cores; i++)
+            m_vSubPools.push_back(new sub_pool(uiPerCore));
+        m_vSubPools.push_back(new sub_pool(uiUnpinned));
+
+        for(int i = 0; i <= _cores; i++) {
+            uint32_t _count = (i < _cores) ? uiPerCore : uiUnpinned;
+
+            for(uint32_t k = 0; k < _count; k++) {
+                basic_pooled_task* _task = new basic_pooled_task("pool", m_uiPriority,
+                                                                 m_usStackDepth, this, i);
+
+                if(_task->start((i < _cores) ? i : MN_THREAD_CONFIG_CORE_IFNO) != ERR_TASK_OK) {
+                    delete _task;
+                    destroy();
+                    return ERR_TASKPOOL_CREATE;
+                }
+                m_vTasks.push_back(_task);
+                park(_task);
+            }
+        }
+        return ERR_TASKPOOL_OK;
+    }
+
+    //-----------------------------------
+    //  destroy
+    //-----------------------------------
+    void basic_task_pool::destroy() {
+        // a running task parks first, then it sees the stop
+        for(size_t i = 0; i < m_vTasks.size(); i++)
+            m_vTasks[i]->stop();
+
+        for(size_t i = 0; i < m_vTasks.size(); i++) {
+            m_vTasks[i]->join();
+            delete m_vTasks[i];
+        }
+        m_vTasks.clear();
+
+        for(size_t i = 0; i < m_vSubPools.size(); i++)
+            delete m_vSubPools[i];
+        m_vSubPools.clear();
+    }
+
+    //-----------------------------------
+    //  run
+    //-----------------------------------
+    int basic_task_pool::run(queue::work_queue_item_t* item, int iCore, unsigned int timeout) {
+        if(item == NULL) return ERR_TASKPOOL_EMPTY;
+
+        basic_pooled_task* _task = NULL;
+        int ret = acquire(iCore, timeout, &_task);
+
+        if(ret == ERR_TASKPOOL_OK)
+            _task->hand(item);
+
+        return ret;
+    }
+
+    //-----------------------------------
+    //  get_idle
+    //-----------------------------------
+    uint32_t basic_task_pool::get_idle(int iCore) {
+        int _index = sub_pool_index(iCore);
+        if(_index < 0) return 0;
+
+        return m_vSubPools[_index]->idle.get_count();
+    }
+
+    //-----------------------------------
+    //  sub_pool_index
+    //-----------------------------------
+    int basic_task_pool::sub_pool_index(int iCore) const {
+        if(!is_created()) return -1;
+
+        int _unpinned = (int)m_vSubPools.size() - 1;
+
+        if(iCore == MN_THREAD_CONFIG_CORE_IFNO) return _unpinned;
+        if(iCore < 0 || iCore >= _unpinned) return -1;
+
+        return iCore;
+    }
+
+    //-----------------------------------
+    //  acquire
+    //-----------------------------------
+    int basic_task_pool::acquire(int iCore, unsigned int timeout, basic_pooled_task** task) {
+        if(!is_created()) return ERR_TASKPOOL_NOTCREATED;
+
+        int _index = sub_pool_index(iCore);
+        if(_index < 0) return ERR_TASKPOOL_CORE;
+
+        sub_pool* _pool = m_vSubPools[_index];
+
+        if(_pool->idle.lock(0) != ERR_SPINLOCK_OK) {
+            // not pinned: a idle task of any core is good
+            if(iCore == MN_THREAD_CONFIG_CORE_IFNO) {
+                for(int i = 0; i < _index; i++) {
+                    if(m_vSubPools[i]->idle.lock(0) != ERR_SPINLOCK_OK) continue;
+
+                    *task = pop(m_vSubPools[i]);
+                    return ERR_TASKPOOL_OK;
+                }
+            }
+            if(timeout == 0 || _pool->idle.lock(timeout) != ERR_SPINLOCK_OK)
+                return ERR_TASKPOOL_EMPTY;
+        }
+        *task = pop(_pool);
+
+        return ERR_TASKPOOL_OK;
+    }
+
+    //-----------------------------------
+    //  pop
+    //-----------------------------------
+    basic_pooled_task* basic_task_pool::pop(sub_pool* pool) {
+        automutx_t lock(pool->lock);
+
+        basic_pooled_task* _task = pool->head;
+        pool->head = _task->m_pNextIdle;
+        _task->m_pNextIdle = NULL;
+
+        return _task;
+    }
+
+    //-----------------------------------
+    //  park
+    //-----------------------------------
+    void basic_task_pool::park(basic_pooled_task* task) {
+        sub_pool* _pool = m_vSubPools[task->m_iSubPool];
+        {
+            automutx_t lock(_pool->lock);
+            task->m_pNextIdle = _pool->head;
+            _pool->head = task;
+        }
+        _pool->idle.unlock();
+    }
+}
@@ -0,0 +1,213 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "mn_task_stats.hpp"
+#include "mn_task_list.hpp"
+
+#include <string.h>
+
+namespace mn {
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+    static_assert((int)task_stats::BlockMax == (int)MN_PORT_BLOCK_MAX,
+        "task_stats::block_reason and mn_port_block_reason differ");
+
+    /** the host counts the run time of the threads and the total in 64 bit */
+    using run_counter_t = uint64_t;
+#elif defined(configRUN_TIME_COUNTER_TYPE)
+    using run_counter_t = configRUN_TIME_COUNTER_TYPE;
+#else
+    /** the width of ulRunTimeCounter, the task and the total counter wraps together */
+    using run_counter_t = uint32_t;
+#endif
+
+    //-----------------------------------
+    //  get_utilization
+    //-----------------------------------
+    static uint32_t get_utilization(run_counter_t run, run_counter_t total) {
+        if(total == 0) return 0;
+
+        // a reused handle can have more run time as the interval
+        uint64_t _share = ((uint64_t)run * 10000ULL) / total;
+        return (_share > 10000) ? 10000 : (uint32_t)_share;
+    }
+
+    //-----------------------------------
+    //  get_run_time_counter
+    //-----------------------------------
+    uint64_t get_run_time_counter() {
+    #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+        return mn_port_micros();
+    #elif ( configGENERATE_RUN_TIME_STATS == 1 )
+        // the same width as the run time of the tasks
+        return (uint64_t)(run_counter_t)portGET_RUN_TIME_COUNTER_VALUE();
+    #else
+        return 0;
+    #endif
+    }
+
+    //-----------------------------------
+    //  get_task_stats
+    //-----------------------------------
+    int get_task_stats(xTaskHandle handle, task_stats& stats) {
+        if(handle == NULL) return ERR_TASK_NOTRUNNING;
+
+        memset(&stats, 0, sizeof(task_stats));
+
+        stats.handle = handle;
+        stats.id = -1;
+        stats.core = xTaskGetAffinity(handle);
+        stats.priority = uxTaskPriorityGet(handle);
+        stats.state = (basic_task::state)eTaskGetState(handle);
+
+        strncpy(stats.name, pcTaskGetTaskName(handle), sizeof(stats.name) - 1);
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        TaskStatus_t _status;
+        vTaskGetInfo(handle, &_status, pdTRUE, eInvalid);
+
+        stats.stack_free_min = _status.usStackHighWaterMark;
+        stats.flags |= task_stats::HasStack;
+      #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        stats.run_time = _status.ulRunTimeCounter;
+        stats.flags |= task_stats::HasRunTime;
+      #endif
+    #elif ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+        stats.stack_free_min = uxTaskGetStackHighWaterMark(handle);
+        stats.flags |= task_stats::HasStack;
+    #endif
+
+    #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+        // the host counts the blocking waits, but can not measure the stack
+        mn_port_task_trace _trace;
+        stats.flags &= ~task_stats::HasStack;
+
+        if(mn_port_get_task_trace(handle, &_trace) == pdPASS) {
+            stats.run_time = _trace.runTimeUs;
+            stats.switches = _trace.switches;
+            for(int i = 0; i < task_stats::BlockMax; i++)
+                stats.blocked_us[i] = _trace.blockedUs[i];
+
+            stats.flags |= task_stats::HasRunTime | task_stats::HasSwitches | task_stats::HasBlocked;
+        }
+    #endif
+
+        if(stats.has(task_stats::HasRunTime))
+            stats.utilization = get_utilization((run_counter_t)stats.run_time, 
+                                                (run_counter_t)get_run_time_counter());
+
+        return ERR_TASK_OK;
+    }
+
+    //-----------------------------------
+    //  get_task_stats
+    //-----------------------------------
+    int get_task_stats(basic_task* task, task_stats& stats) {
+        if(task == NULL || !task->is_running())
+            return ERR_TASK_NOTRUNNING;
+
+        int ret = get_task_stats(task->get_handle(), stats);
+        if(ret != ERR_TASK_OK) return ret;
+
+        stats.id = task->get_id();
+        stats.stack_depth = task->get_stackdepth();
+
+        return ERR_TASK_OK;
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::take
+    //-----------------------------------
+    size_t basic_task_snapshot::take() {
+        begin();
+        basic_task_list::instance().each_task([this](basic_task* task) { add(task); });
+        end();
+
+        return m_vStats.size();
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::take
+    //-----------------------------------
+    size_t basic_task_snapshot::take(basic_task* const* tasks, size_t count) {
+        begin();
+        for(size_t i = 0; i < count; i++) add(tasks[i]);
+        end();
+
+        return m_vStats.size();
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::find
+    //-----------------------------------
+    const task_stats* basic_task_snapshot::find(int32_t id) const {
+        for(size_t i = 0; i < m_vStats.size(); i++) {
+            if(m_vStats[i].id == id) return &m_vStats[i];
+        }
+        return NULL;
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::begin
+    //-----------------------------------
+    void basic_task_snapshot::begin() {
+        // remember the run times of the last snapshot for the utilization
+        m_vLast.clear();
+        for(size_t i = 0; i < m_vStats.size(); i++) {
+            last_run _run = { m_vStats[i].handle, m_vStats[i].run_time };
+            m_vLast.push_back(_run);
+        }
+        m_vStats.clear();
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::add
+    //-----------------------------------
+    void basic_task_snapshot::add(basic_task* task) {
+        task_stats _stats;
+
+        if(get_task_stats(task, _stats) == ERR_TASK_OK)
+            m_vStats.push_back(_stats);
+    }
+
+    //-----------------------------------
+    //  basic_task_snapshot::end
+    //-----------------------------------
+    void basic_task_snapshot::end() {
+        uint64_t _total = get_run_time_counter();
+
+        // the deltas in the width of the counter, so one wrap between two snapshots is fine
+        m_uiInterval = (m_uiLastTotal != 0) ? (run_counter_t)(_total - m_uiLastTotal) : 0;
+        m_uiLastTotal = _total;
+
+        // the first snapshot of a task keeps the share since his start
+        if(m_uiInterval == 0) return;
+
+        for(size_t i = 0; i < m_vStats.size(); i++) {
+            task_stats& _stats = m_vStats[i];
+            if(!_stats.has(task_stats::HasRunTime)) continue;
+
+            for(size_t j = 0; j < m_vLast.size(); j++) {
+                if(m_vLast[j].handle != _stats.handle) continue;
+
+                run_counter_t _run = (run_counter_t)(_stats.run_time - m_vLast[j].run_time);
+                _stats.utilization = get_utilization(_run, (run_counter_t)m_uiInterval);
+                break;
+            }
+        }
+    }
+}
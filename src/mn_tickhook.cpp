@@ -25,14 +25,26 @@
 #include "mn_tickhook.hpp"
 #include "mn_micros.hpp"
 
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+/**
+ * The host port calls the tick hook from a task and not from a ISR, so the
+ * dispatch can lock. On the target the application owns vApplicationTickHook,
+ * the dispatch of base_tickhook locks mutexes and is not ISR safe.
+ */
+void vApplicationTickHook(void) {
+    mn::base_tickhook::instance().onApplicationTickHook();
+}
+#endif
+
 namespace mn {
     base_tickhook* base_tickhook::m_pInstance = NULL;
     mutex_t  base_tickhook::m_staticInstanceMux = mutex_t();
 
-
+#if MN_THREAD_CONFIG_BOARD != MN_THREAD_CONFIG_LINUX
     void vApplicationTickHook(void) {
         base_tickhook::instance().onApplicationTickHook();
     }
+#endif
 
     base_tickhook::base_tickhook() 
         : m_listHooks((unsigned int)MN_THREAD_CONFIG_TICKHOOK_MAXENTRYS, (unsigned int)sizeof(base_tickhook_entry*) ),
@@ -55,19 +67,17 @@ namespace mn {
 
         if(m_listHooks.is_empty()) return;
 
-        while( (dequeue(entry) == ERR_QUEUE_OK) ) {
+        while( (dequeue(&entry, 0) == ERR_QUEUE_OK) ) {
 
             time = entry->get_ticks();
 
-            if(entry->is_ready()) {
+            if(entry->is_ready() && ( (time == 0) || ((m_iCurrent % time) == 0) ) ) {
+                entry->onTick(m_iCurrent);
 
-                if( (time == 0) || ((m_iCurrent % time) == 0) )  {
-                    entry->onTick(m_iCurrent);
-
-                    if(!entry->is_oneshoted())  
-                        m_listToAdd.enqueue(entry);
-                }
+                if(entry->is_oneshoted()) continue;
             }
+            // hold all other entrys for the next tick
+            m_listToAdd.enqueue(&entry, 0);
         }
 
 
@@ -79,7 +89,7 @@ namespace mn {
     * -------------------------------------*/
     base_tickhook& base_tickhook::instance() {
         automutx_t lock(m_staticInstanceMux);
-        if(m_pInstance != NULL) 
+        if(m_pInstance == NULL) 
             m_pInstance = new base_tickhook();
         return *m_pInstance;
     }
@@ -89,70 +99,28 @@ namespace mn {
     int base_tickhook::enqueue(base_tickhook_entry* entry, unsigned int timeout) {
         if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
 
-        TickType_t xTicksEnd = xTaskGetTickCount() + timeout;
-        TickType_t xTicksRemaining = timeout;
-        int _ret = ERR_TIMEOUT;
-
-        while(xTicksRemaining <= timeout) {
-        if(m_mutexAdd.lock(xTicksRemaining) != NO_ERROR){
-                    break;
-            }
-
-            _ret = m_listHooks.enqueue(entry, xTicksRemaining);
-
-            if(_ret == ERR_QUEUE_OK) {
-                m_mutexAdd.unlock();
-                break;
-            }
-            
-
-            if (timeout != portMAX_DELAY) {
-                xTicksRemaining = xTicksEnd - xTaskGetTickCount();
-            }
-            m_mutexAdd.unlock();
-        }
+        if(m_mutexAdd.lock(timeout) != NO_ERROR) 
+            return ERR_TIMEOUT;
 
-        // Old with out RTOS timeout support
-        /*m_mutexAdd.lock();
-        m_listHooks.enqueue(entry, timeout);
-        m_mutexAdd.unlock();*/
+        int _ret = m_listHooks.enqueue(&entry, timeout);
 
+        m_mutexAdd.unlock();
         return _ret;
     }
 
     /*--------------------------------------
     * dequeue()
     * -------------------------------------*/
-    int base_tickhook::dequeue(base_tickhook_entry* entry, unsigned int timeout) {
+    int base_tickhook::dequeue(base_tickhook_entry** entry, unsigned int timeout) {
         if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
 
-        TickType_t xTicksEnd = xTaskGetTickCount() + timeout;
-        TickType_t xTicksRemaining = timeout;
-        int _ret = ERR_TIMEOUT;
-
-        while(xTicksRemaining <= timeout) {
-        if(m_mutexAdd.lock(xTicksRemaining) != NO_ERROR){
-                    break;
-            }
-
-            _ret = m_listHooks.dequeue(entry, xTicksRemaining);
+        if(m_mutexAdd.lock(timeout) != NO_ERROR) 
+            return ERR_TIMEOUT;
 
-            if(_ret == ERR_QUEUE_OK) {
-                m_mutexAdd.unlock();
-                break;
-            }
-            
+        int _ret = m_listHooks.dequeue(entry, timeout);
 
-            if (timeout != portMAX_DELAY) {
-                xTicksRemaining = xTicksEnd - xTaskGetTickCount();
-            }
-            m_mutexAdd.unlock();
-        }
+        m_mutexAdd.unlock();
         return _ret;
-        
-        
-        //automutx_t lock(m_mutexAdd);
-        //m_listHooks.dequeue(entry, timeout);
     }
 
     /*--------------------------------------
@@ -188,11 +156,10 @@ namespace mn {
     * swap()
     * -------------------------------------*/
     void base_tickhook::swap() {
-        automutx_t lock(m_mutexAdd);
-
         base_tickhook_entry *entry = 0;
         
-        while( (m_listToAdd.dequeue(entry) == ERR_QUEUE_OK) ) {
+        // enqueue locks m_mutexAdd self
+        while( (m_listToAdd.dequeue(&entry, 0) == ERR_QUEUE_OK) ) {
             enqueue(entry);
         }
     }
@@ -52,7 +52,7 @@ namespace mn {
         if (m_pHandle == NULL) 
             return ERR_TIMER_CANTCREATE;
 
-        m_iTimerID = ( int32_t )pvTimerGetTimerID(m_pHandle);
+        m_iTimerID = ( int32_t )( intptr_t )pvTimerGetTimerID(m_pHandle);
 
         return ERR_TIMER_OK;
     }
@@ -166,7 +166,7 @@ namespace mn {
     //-----------------------------------
     void basic_timer::set_id(int nId) {
         vTimerSetTimerID(m_pHandle, &nId);
-        m_iTimerID = ( int32_t )pvTimerGetTimerID(m_pHandle);
+        m_iTimerID = ( int32_t )( intptr_t )pvTimerGetTimerID(m_pHandle);
     }
 
     //-----------------------------------
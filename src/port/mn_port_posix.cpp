@@ -0,0 +1,1606 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include <deque>
+
+#include "port/mn_port_posix.hpp"
+
+/**
+ * The max time a blocked task sleeps before it looks for a pending
+ * vTaskDelete or vTaskSuspend from a other task
+ */
+#define MN_PORT_POSIX_WAIT_SLICE_NS     (50ULL * 1000ULL * 1000ULL)
+#define MN_PORT_POSIX_NS_PER_SEC        (1000ULL * 1000ULL * 1000ULL)
+#define MN_PORT_POSIX_INFINITE          (~0ULL)
+
+/**
+ * The host task control block
+ */
+struct mn_port_task {
+    pthread_t           thread;
+    TaskFunction_t      func;
+    void*               arg;
+    char                name[16];
+    UBaseType_t         priority;
+    BaseType_t          core;
+    UBaseType_t         number;
+    uint32_t            stackDepth;
+    bool                adopted;
+
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
+    uint32_t            notifyValue;
+    uint8_t             notifyState;
+
+    volatile bool       deleted;
+    volatile bool       suspended;
+    volatile bool       blocked;
+
+    /** The blocking waits and the blocked time per reason, written only from the task */
+    uint32_t            switches;
+    uint64_t            blockedNs[MN_PORT_BLOCK_MAX];
+
+    void*               tls[configNUM_THREAD_LOCAL_STORAGE_POINTERS];
+
+    mn_port_task*       prev;
+    mn_port_task*       next;
+};
+
+enum mn_port_notify_state {
+    MN_PORT_NOTIFY_NONE = 0,
+    MN_PORT_NOTIFY_WAITING,
+    MN_PORT_NOTIFY_RECEIVED
+};
+
+enum mn_port_queue_type {
+    MN_PORT_QUEUE_BASE = 0,
+    MN_PORT_QUEUE_MUTEX,
+    MN_PORT_QUEUE_RECURSIVE_MUTEX,
+    MN_PORT_QUEUE_BINARY,
+    MN_PORT_QUEUE_COUNTING
+};
+
+/**
+ * The host queue, used for queues and all semaphore types
+ */
+struct mn_port_queue {
+    pthread_mutex_t     lock;
+    pthread_cond_t      canRecv;
+    pthread_cond_t      canSend;
+    uint8_t*            buffer;
+    UBaseType_t         length;
+    UBaseType_t         itemSize;
+    UBaseType_t         head;
+    UBaseType_t         count;
+    uint8_t             type;
+    mn_port_task*       holder;
+    UBaseType_t         recursion;
+};
+
+/**
+ * A task waiting in xEventGroupWaitBits, the bits are evaluated by the setter,
+ * like the FreeRTOS kernel, so that all waiters see the bits before they are cleared
+ */
+struct mn_port_eventwaiter {
+    EventBits_t             waitFor;
+    bool                    waitAll;
+    bool                    clearOnExit;
+    bool                    done;
+    EventBits_t             result;
+    mn_port_eventwaiter*    next;
+};
+
+struct mn_port_eventgroup {
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    EventBits_t             bits;
+    mn_port_eventwaiter*    waiters;
+};
+
+struct mn_port_timer {
+    char                    name[16];
+    TickType_t              period;
+    bool                    autoReload;
+    void*                   id;
+    TimerCallbackFunction_t callback;
+    bool                    active;
+    bool                    deleted;
+    uint64_t                expiry;
+    mn_port_timer*          next;
+};
+
+struct mn_port_pended_call {
+    PendedFunction_t        func;
+    void*                   param1;
+    uint32_t                param2;
+};
+
+namespace {
+    pthread_mutex_t     g_portLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_t     g_criticalNested;
+    pthread_mutex_t     g_schedularLock;
+    pthread_cond_t      g_schedularCond;
+    pthread_cond_t      g_exitCond;
+    pthread_once_t      g_portOnce = PTHREAD_ONCE_INIT;
+    pthread_key_t       g_adoptedKey;
+
+    mn_port_task*       g_taskList = NULL;
+    UBaseType_t         g_taskCount = 0;
+    UBaseType_t         g_taskNumber = 0;
+    bool                g_schedularRunning = true;
+    uint64_t            g_startTime = 0;
+    volatile bool       g_tickStarted = false;
+    TaskHandle_t        g_tickTask = NULL;
+
+    thread_local mn_port_task* t_current = NULL;
+
+    // Timer service
+    pthread_mutex_t     g_timerLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t      g_timerCond;
+    mn_port_timer*      g_timerList = NULL;
+    mn_port_timer*      g_timerRunning = NULL;
+    TaskHandle_t        g_timerTask = NULL;
+    std::deque<mn_port_pended_call> g_pendedCalls;
+
+    //-----------------------------------
+    //  handle helpers
+    //-----------------------------------
+    inline mn_port_queue* mn_port_queue_of(QueueHandle_t handle) {
+        return static_cast<mn_port_queue*>(handle);
+    }
+    inline mn_port_eventgroup* mn_port_eventgroup_of(EventGroupHandle_t handle) {
+        return static_cast<mn_port_eventgroup*>(handle);
+    }
+    inline mn_port_timer* mn_port_timer_of(TimerHandle_t handle) {
+        return static_cast<mn_port_timer*>(handle);
+    }
+
+    //-----------------------------------
+    //  time helpers
+    //-----------------------------------
+    inline uint64_t mn_port_now_ns() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * MN_PORT_POSIX_NS_PER_SEC + (uint64_t)ts.tv_nsec;
+    }
+
+    inline uint64_t mn_port_ticks_to_ns(TickType_t ticks) {
+        return ((uint64_t)ticks * MN_PORT_POSIX_NS_PER_SEC) / configTICK_RATE_HZ;
+    }
+
+    inline uint64_t mn_port_deadline(TickType_t ticks) {
+        if(ticks == portMAX_DELAY) return MN_PORT_POSIX_INFINITE;
+        return mn_port_now_ns() + mn_port_ticks_to_ns(ticks);
+    }
+
+    inline struct timespec mn_port_to_timespec(uint64_t ns) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)(ns / MN_PORT_POSIX_NS_PER_SEC);
+        ts.tv_nsec = (long)(ns % MN_PORT_POSIX_NS_PER_SEC);
+        return ts;
+    }
+
+    inline void mn_port_cond_init(pthread_cond_t* cond) {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(cond, &attr);
+        pthread_condattr_destroy(&attr);
+    }
+
+    inline void mn_port_recursive_init(pthread_mutex_t* mutex) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+
+    //-----------------------------------
+    //  task registry
+    //-----------------------------------
+    void mn_port_register(mn_port_task* task) {
+        pthread_mutex_lock(&g_portLock);
+        task->number = ++g_taskNumber;
+        task->prev = NULL;
+        task->next = g_taskList;
+        if(g_taskList) g_taskList->prev = task;
+        g_taskList = task;
+        g_taskCount++;
+        pthread_mutex_unlock(&g_portLock);
+    }
+
+    void mn_port_unregister(mn_port_task* task) {
+        pthread_mutex_lock(&g_portLock);
+        if(task->prev) task->prev->next = task->next;
+        else g_taskList = task->next;
+        if(task->next) task->next->prev = task->prev;
+        g_taskCount--;
+        pthread_cond_broadcast(&g_exitCond);
+        pthread_mutex_unlock(&g_portLock);
+    }
+
+    /**
+     * Is the task registered, g_portLock must be locked
+     */
+    bool mn_port_is_task_locked(mn_port_task* task) {
+        for(mn_port_task* it = g_taskList; it != NULL; it = it->next) {
+            if(it == task) return true;
+        }
+        return false;
+    }
+
+    bool mn_port_is_task(mn_port_task* task) {
+        pthread_mutex_lock(&g_portLock);
+        bool _ret = mn_port_is_task_locked(task);
+        pthread_mutex_unlock(&g_portLock);
+        return _ret;
+    }
+
+    mn_port_task* mn_port_alloc_task(const char* name, UBaseType_t priority, BaseType_t core) {
+        mn_port_task* task = (mn_port_task*)calloc(1, sizeof(mn_port_task));
+        if(task == NULL) return NULL;
+
+        strncpy(task->name, name ? name : "", sizeof(task->name) - 1);
+        task->priority = priority;
+        task->core = core;
+
+        pthread_mutex_init(&task->lock, NULL);
+        mn_port_cond_init(&task->cond);
+
+        return task;
+    }
+
+    void mn_port_free_task(void* parm) {
+        mn_port_task* task = static_cast<mn_port_task*>(parm);
+
+        mn_port_unregister(task);
+        pthread_cond_destroy(&task->cond);
+        pthread_mutex_destroy(&task->lock);
+        free(task);
+    }
+
+    void mn_port_init_once() {
+        g_startTime = mn_port_now_ns();
+
+        mn_port_recursive_init(&g_criticalNested);
+        pthread_mutex_init(&g_schedularLock, NULL);
+        mn_port_cond_init(&g_schedularCond);
+        mn_port_cond_init(&g_exitCond);
+        mn_port_cond_init(&g_timerCond);
+
+        pthread_key_create(&g_adoptedKey, mn_port_free_task);
+    }
+
+    inline void mn_port_init() {
+        pthread_once(&g_portOnce, mn_port_init_once);
+    }
+
+    /**
+     * Get the current task, threads not created with xTaskCreate (i.e. main)
+     * are adopted on the first call
+     */
+    mn_port_task* mn_port_self() {
+        if(t_current != NULL) return t_current;
+
+        mn_port_init();
+
+        mn_port_task* task = mn_port_alloc_task("main", tskIDLE_PRIORITY + 1, tskNO_AFFINITY);
+        if(task == NULL) return NULL;
+
+        task->thread = pthread_self();
+        task->adopted = true;
+
+        mn_port_register(task);
+        pthread_setspecific(g_adoptedKey, task);
+
+        t_current = task;
+        return task;
+    }
+
+    /**
+     * @return The task of the handle, the current task when the handle is NULL
+     */
+    inline mn_port_task* mn_port_task_of(TaskHandle_t handle) {
+        return (handle == NULL) ? mn_port_self() : static_cast<mn_port_task*>(handle);
+    }
+
+    /**
+     * End the calling task, used by vTaskDelete. Unwinds the stack of the task
+     */
+    void mn_port_exit_self() {
+        mn_port_task* self = mn_port_self();
+        self->deleted = true;
+        pthread_exit(NULL);
+    }
+
+    /**
+     * Count a blocking wait of the calling task, only the task self writes
+     */
+    inline void mn_port_account_block(mn_port_task* self, uint8_t reason, uint64_t start) {
+        uint64_t elapsed = mn_port_now_ns() - start;
+
+        __atomic_store_n(&self->switches, self->switches + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&self->blockedNs[reason], self->blockedNs[reason] + elapsed, __ATOMIC_RELAXED);
+    }
+
+    void mn_port_suspend_self(mn_port_task* self) {
+        uint64_t start = mn_port_now_ns();
+
+        pthread_mutex_lock(&self->lock);
+        while(self->suspended && !self->deleted) {
+            pthread_cond_wait(&self->cond, &self->lock);
+        }
+        pthread_mutex_unlock(&self->lock);
+
+        mn_port_account_block(self, MN_PORT_BLOCK_SUSPEND, start);
+
+        if(self->deleted) mn_port_exit_self();
+    }
+
+    /**
+     * Wait on a condition of a port object.
+     * The mutex must be locked, the caller must re-check the predicate.
+     *
+     * @param reason Why the task waits, for the task trace (MN_PORT_BLOCK_*)
+     * @return false on timeout, true when woken up
+     */
+    bool mn_port_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, uint64_t deadline, uint8_t reason) {
+        mn_port_task* self = mn_port_self();
+        uint64_t start = mn_port_now_ns();
+
+        for(;;) {
+            uint64_t now = mn_port_now_ns();
+            if(now >= deadline) {
+                mn_port_account_block(self, reason, start);
+                return false;
+            }
+
+            uint64_t slice = now + MN_PORT_POSIX_WAIT_SLICE_NS;
+            struct timespec ts = mn_port_to_timespec( (slice < deadline) ? slice : deadline );
+
+            self->blocked = true;
+            int rc = pthread_cond_timedwait(cond, mutex, &ts);
+            self->blocked = false;
+
+            if(self->deleted) {
+                pthread_mutex_unlock(mutex);
+                mn_port_exit_self();
+            }
+            if(self->suspended) {
+                mn_port_account_block(self, reason, start);
+
+                pthread_mutex_unlock(mutex);
+                mn_port_suspend_self(self);
+                pthread_mutex_lock(mutex);
+                return true;
+            }
+            if(rc == 0) {
+                mn_port_account_block(self, reason, start);
+                return true;
+            }
+        }
+    }
+
+    void* mn_port_task_main(void* parm) {
+        mn_port_task* task = static_cast<mn_port_task*>(parm);
+        t_current = task;
+
+        pthread_cleanup_push(mn_port_free_task, task);
+
+        if(task->core != tskNO_AFFINITY) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(task->core, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        if(!task->deleted)
+            task->func(task->arg);
+
+        pthread_cleanup_pop(1);
+        return NULL;
+    }
+
+#if ( configUSE_TICK_HOOK == 1 )
+    /**
+     * The host tick "interrupt", call vApplicationTickHook every tick
+     */
+    void mn_port_tick_task(void* parm) {
+        (void)parm;
+
+        mn_port_task* self = mn_port_self();
+        uint64_t next = mn_port_now_ns();
+
+        for(;;) {
+            next += mn_port_ticks_to_ns(1);
+
+            pthread_mutex_lock(&self->lock);
+            while(mn_port_wait(&self->cond, &self->lock, next, MN_PORT_BLOCK_DELAY)) { }
+            pthread_mutex_unlock(&self->lock);
+
+            vApplicationTickHook();
+
+            // we are to late, drop the lost ticks
+            uint64_t now = mn_port_now_ns();
+            if(now > next + mn_port_ticks_to_ns(configTICK_RATE_HZ / 10)) next = now;
+        }
+    }
+#endif
+
+#if ( configUSE_TICK_HOOK == 1 )
+    /**
+     * Stop the tick hook task on exit
+     */
+    void mn_port_tick_stop() {
+        if(g_tickTask != NULL) {
+            vTaskDelete(g_tickTask); g_tickTask = NULL;
+        }
+    }
+#endif
+
+    /**
+     * Start the tick hook task with the first created task
+     */
+    void mn_port_tick_start() {
+#if ( configUSE_TICK_HOOK == 1 )
+        if(__atomic_exchange_n(&g_tickStarted, true, __ATOMIC_ACQ_REL)) return;
+
+        if(xTaskCreatePinnedToCore(mn_port_tick_task, "Tick", configMINIMAL_STACK_SIZE,
+                        NULL, configMAX_PRIORITIES - 1, &g_tickTask, tskNO_AFFINITY) == pdPASS) {
+            // the hooks are often static objects, stop the tick before they are destroyed
+            atexit(mn_port_tick_stop);
+        }
+#endif
+    }
+
+    //-----------------------------------
+    //  queue helpers
+    //-----------------------------------
+    mn_port_queue* mn_port_queue_create(UBaseType_t length, UBaseType_t itemSize, uint8_t type) {
+        mn_port_init();
+
+        mn_port_queue* queue = (mn_port_queue*)calloc(1, sizeof(mn_port_queue));
+        if(queue == NULL) return NULL;
+
+        if(itemSize > 0) {
+            queue->buffer = (uint8_t*)malloc(length * itemSize);
+            if(queue->buffer == NULL) { free(queue); return NULL; }
+        }
+        queue->length = length;
+        queue->itemSize = itemSize;
+        queue->type = type;
+
+        pthread_mutex_init(&queue->lock, NULL);
+        mn_port_cond_init(&queue->canRecv);
+        mn_port_cond_init(&queue->canSend);
+
+        return queue;
+    }
+
+    BaseType_t mn_port_queue_send(mn_port_queue* queue, const void* item, TickType_t ticks, bool front) {
+        if(queue == NULL) return pdFAIL;
+
+        uint64_t deadline = mn_port_deadline(ticks);
+
+        pthread_mutex_lock(&queue->lock);
+        while(queue->count == queue->length) {
+            if(ticks == 0 || !mn_port_wait(&queue->canSend, &queue->lock, deadline, MN_PORT_BLOCK_QUEUE)) {
+                if(queue->count == queue->length) {
+                    pthread_mutex_unlock(&queue->lock);
+                    return errQUEUE_FULL;
+                }
+            }
+        }
+
+        if(queue->itemSize > 0 && item != NULL) {
+            UBaseType_t pos;
+            if(front) {
+                queue->head = (queue->head + queue->length - 1) % queue->length;
+                pos = queue->head;
+            } else {
+                pos = (queue->head + queue->count) % queue->length;
+            }
+            memcpy(queue->buffer + pos * queue->itemSize, item, queue->itemSize);
+        }
+        queue->count++;
+
+        if(queue->type == MN_PORT_QUEUE_MUTEX || queue->type == MN_PORT_QUEUE_RECURSIVE_MUTEX)
+            queue->holder = NULL;
+
+        pthread_cond_signal(&queue->canRecv);
+        pthread_mutex_unlock(&queue->lock);
+
+        return pdPASS;
+    }
+
+    BaseType_t mn_port_queue_receive(mn_port_queue* queue, void* buffer, TickType_t ticks, bool peek) {
+        if(queue == NULL) return pdFAIL;
+
+        uint64_t deadline = mn_port_deadline(ticks);
+
+        pthread_mutex_lock(&queue->lock);
+        while(queue->count == 0) {
+            if(ticks == 0 || !mn_port_wait(&queue->canRecv, &queue->lock, deadline, MN_PORT_BLOCK_QUEUE)) {
+                if(queue->count == 0) {
+                    pthread_mutex_unlock(&queue->lock);
+                    return errQUEUE_EMPTY;
+                }
+            }
+        }
+
+        if(queue->itemSize > 0 && buffer != NULL) {
+            memcpy(buffer, queue->buffer + queue->head * queue->itemSize, queue->itemSize);
+        }
+
+        if(peek) {
+            // an other receiver can use the item
+            pthread_cond_signal(&queue->canRecv);
+        } else {
+            queue->head = (queue->head + 1) % queue->length;
+            queue->count--;
+
+            if(queue->type == MN_PORT_QUEUE_MUTEX || queue->type == MN_PORT_QUEUE_RECURSIVE_MUTEX)
+                queue->holder = mn_port_self();
+
+            pthread_cond_signal(&queue->canSend);
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        return pdPASS;
+    }
+
+    //-----------------------------------
+    //  timer service helpers
+    //-----------------------------------
+    void mn_port_timer_free(mn_port_timer* timer) {
+        mn_port_timer** it = &g_timerList;
+        while(*it != NULL) {
+            if(*it == timer) { *it = timer->next; break; }
+            it = &(*it)->next;
+        }
+        free(timer);
+    }
+
+    void mn_port_timer_task(void* parm) {
+        (void)parm;
+
+        pthread_mutex_lock(&g_timerLock);
+        for(;;) {
+            if(!g_pendedCalls.empty()) {
+                mn_port_pended_call call = g_pendedCalls.front();
+                g_pendedCalls.pop_front();
+
+                pthread_mutex_unlock(&g_timerLock);
+                call.func(call.param1, call.param2);
+                pthread_mutex_lock(&g_timerLock);
+                continue;
+            }
+
+            uint64_t now = mn_port_now_ns();
+            uint64_t next = MN_PORT_POSIX_INFINITE;
+            mn_port_timer* expired = NULL;
+
+            for(mn_port_timer* it = g_timerList; it != NULL; it = it->next) {
+                if(!it->active || it->deleted) continue;
+                if(it->expiry <= now) { expired = it; break; }
+                if(it->expiry < next) next = it->expiry;
+            }
+
+            if(expired != NULL) {
+                if(expired->autoReload) {
+                    expired->expiry += mn_port_ticks_to_ns(expired->period);
+                    if(expired->expiry <= now) expired->expiry = now + mn_port_ticks_to_ns(expired->period);
+                } else {
+                    expired->active = false;
+                }
+                g_timerRunning = expired;
+
+                pthread_mutex_unlock(&g_timerLock);
+                expired->callback(expired);
+                pthread_mutex_lock(&g_timerLock);
+
+                g_timerRunning = NULL;
+                if(expired->deleted) mn_port_timer_free(expired);
+
+                pthread_cond_broadcast(&g_timerCond);
+                continue;
+            }
+            mn_port_wait(&g_timerCond, &g_timerLock, next, MN_PORT_BLOCK_QUEUE);
+        }
+    }
+
+    /**
+     * Start the timer service task, must be called with g_timerLock locked
+     */
+    bool mn_port_timer_service() {
+        if(g_timerTask != NULL) return true;
+
+        return xTaskCreatePinnedToCore(mn_port_timer_task, "Tmr Svc", configMINIMAL_STACK_SIZE,
+                        NULL, configTIMER_TASK_PRIORITY, &g_timerTask, tskNO_AFFINITY) == pdPASS;
+    }
+}
+
+//-----------------------------------
+//  port
+//-----------------------------------
+BaseType_t mn_port_num_processors() {
+    long _num = sysconf(_SC_NPROCESSORS_ONLN);
+    return (_num > 0) ? (BaseType_t)_num : 1;
+}
+
+uint64_t mn_port_micros() {
+    mn_port_init();
+    return (mn_port_now_ns() - g_startTime) / 1000ULL;
+}
+
+BaseType_t mn_port_get_task_trace(TaskHandle_t xTask, mn_port_task_trace* pxTrace) {
+    if(pxTrace == NULL) return pdFAIL;
+
+    mn_port_task* task = mn_port_task_of(xTask);
+    BaseType_t _ret = pdFAIL;
+
+    // a registered thread is alive, it unregisters self on the exit
+    pthread_mutex_lock(&g_portLock);
+    if(mn_port_is_task_locked(task)) {
+        clockid_t cid;
+        struct timespec ts;
+
+        pxTrace->runTimeUs = 0;
+        if(pthread_getcpuclockid(task->thread, &cid) == 0 && clock_gettime(cid, &ts) == 0)
+            pxTrace->runTimeUs = (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+
+        pxTrace->switches = __atomic_load_n(&task->switches, __ATOMIC_RELAXED);
+        for(int i = 0; i < MN_PORT_BLOCK_MAX; i++)
+            pxTrace->blockedUs[i] = __atomic_load_n(&task->blockedNs[i], __ATOMIC_RELAXED) / 1000ULL;
+
+        _ret = pdPASS;
+    }
+    pthread_mutex_unlock(&g_portLock);
+
+    return _ret;
+}
+
+BaseType_t mn_port_get_core_id() {
+    int _core = sched_getcpu();
+    return (_core < 0) ? 0 : _core;
+}
+
+void vPortCPUInitializeMutex(portMUX_TYPE *mux) {
+    mux->owner = portMUX_FREE_VAL;
+    mux->count = 0;
+}
+
+bool vPortCPUAcquireMutexTimeout(portMUX_TYPE *mux, int timeout_cycles) {
+    uintptr_t self = (uintptr_t)mn_port_self();
+    uint64_t deadline = (timeout_cycles < 0) ? MN_PORT_POSIX_INFINITE :
+                         mn_port_now_ns() + (uint64_t)timeout_cycles;
+
+    if(__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == self) {
+        mux->count++;
+        return true;
+    }
+
+    for(;;) {
+        uintptr_t expected = portMUX_FREE_VAL;
+        if(__atomic_compare_exchange_n(&mux->owner, &expected, self, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            mux->count = 1;
+            return true;
+        }
+        if(timeout_cycles == portMUX_TRY_LOCK || mn_port_now_ns() >= deadline)
+            return false;
+
+        sched_yield();
+    }
+}
+
+void vPortCPUReleaseMutex(portMUX_TYPE *mux) {
+    if(__atomic_load_n(&mux->owner, __ATOMIC_RELAXED) != (uintptr_t)mn_port_self()) return;
+
+    if(--mux->count == 0) {
+        __atomic_store_n(&mux->owner, (uintptr_t)portMUX_FREE_VAL, __ATOMIC_RELEASE);
+    }
+}
+
+void mn_port_enter_critical(portMUX_TYPE *mux) {
+    vPortCPUAcquireMutexTimeout(mux, portMUX_NO_TIMEOUT);
+}
+
+void mn_port_exit_critical(portMUX_TYPE *mux) {
+    vPortCPUReleaseMutex(mux);
+}
+
+uint32_t mn_port_enter_critical_nested() {
+    mn_port_init();
+    pthread_mutex_lock(&g_criticalNested);
+    return 0;
+}
+
+void mn_port_exit_critical_nested(uint32_t state) {
+    (void)state;
+    pthread_mutex_unlock(&g_criticalNested);
+}
+
+BaseType_t xPortStartScheduler() {
+    mn_port_init();
+
+    pthread_mutex_lock(&g_schedularLock);
+    g_schedularRunning = true;
+    pthread_mutex_unlock(&g_schedularLock);
+
+    return pdTRUE;
+}
+
+void vPortEndScheduler() {
+    mn_port_init();
+
+    pthread_mutex_lock(&g_schedularLock);
+    g_schedularRunning = false;
+    pthread_cond_broadcast(&g_schedularCond);
+    pthread_mutex_unlock(&g_schedularLock);
+}
+
+//-----------------------------------
+//  task
+//-----------------------------------
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char * const pcName,
+                const uint32_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority,
+                TaskHandle_t * const pvCreatedTask, const BaseType_t xCoreID) {
+    mn_port_init();
+
+    if(pvCreatedTask) *pvCreatedTask = NULL;
+
+    if(xCoreID != tskNO_AFFINITY && (xCoreID < 0 || xCoreID >= portNUM_PROCESSORS))
+        return pdFAIL;
+
+    mn_port_task* task = mn_port_alloc_task(pcName, uxPriority, xCoreID);
+    if(task == NULL) return pdFAIL;
+
+    task->func = pvTaskCode;
+    task->arg = pvParameters;
+    task->stackDepth = usStackDepth;
+
+    mn_port_register(task);
+
+    // The handle must be valid befor the task run
+    if(pvCreatedTask) *pvCreatedTask = task;
+
+    size_t stacksize = usStackDepth;
+    if(stacksize < MN_PORT_POSIX_MIN_STACK_SIZE) stacksize = MN_PORT_POSIX_MIN_STACK_SIZE;
+    if(stacksize < (size_t)PTHREAD_STACK_MIN) stacksize = (size_t)PTHREAD_STACK_MIN;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, stacksize);
+
+    int rc = pthread_create(&task->thread, &attr, mn_port_task_main, task);
+    pthread_attr_destroy(&attr);
+
+    if(rc != 0) {
+        if(pvCreatedTask) *pvCreatedTask = NULL;
+        mn_port_free_task(task);
+        return pdFAIL;
+    }
+    mn_port_tick_start();
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char * const pcName,
+                const uint32_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority,
+                TaskHandle_t * const pvCreatedTask) {
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters,
+                                    uxPriority, pvCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete) {
+    mn_port_task* self = mn_port_self();
+    mn_port_task* task = mn_port_task_of(xTaskToDelete);
+
+    if(task == self) {
+        mn_port_exit_self();
+    }
+
+    pthread_mutex_lock(&g_portLock);
+    if(!mn_port_is_task_locked(task)) {
+        pthread_mutex_unlock(&g_portLock);
+        return;
+    }
+
+    pthread_mutex_lock(&task->lock);
+    task->deleted = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+
+    // Like the kernel the task is gone after the call. The task leaves at
+    // his next blocking call, an adopted thread can not wait for
+    if(!task->adopted) {
+        while(mn_port_is_task_locked(task)) {
+            pthread_cond_wait(&g_exitCond, &g_portLock);
+        }
+    }
+    pthread_mutex_unlock(&g_portLock);
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay) {
+    mn_port_task* self = mn_port_self();
+
+    if(xTicksToDelay == 0) {
+        sched_yield();
+        return;
+    }
+    uint64_t deadline = mn_port_deadline(xTicksToDelay);
+
+    pthread_mutex_lock(&self->lock);
+    while(mn_port_wait(&self->cond, &self->lock, deadline, MN_PORT_BLOCK_DELAY)) { }
+    pthread_mutex_unlock(&self->lock);
+}
+
+void vTaskDelayUntil(TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement) {
+    TickType_t xTimeToWake = *pxPreviousWakeTime + xTimeIncrement;
+    TickType_t xNow = xTaskGetTickCount();
+
+    // the signed difference handles the tick overflow, like the kernel
+    if((int32_t)(xTimeToWake - xNow) > 0) {
+        vTaskDelay(xTimeToWake - xNow);
+    }
+    *pxPreviousWakeTime = xTimeToWake;
+}
+
+void vTaskSuspend(TaskHandle_t xTaskToSuspend) {
+    mn_port_task* self = mn_port_self();
+    mn_port_task* task = mn_port_task_of(xTaskToSuspend);
+
+    pthread_mutex_lock(&task->lock);
+    task->suspended = true;
+    pthread_mutex_unlock(&task->lock);
+
+    if(task == self) mn_port_suspend_self(self);
+}
+
+void vTaskResume(TaskHandle_t xTaskToResume) {
+    if(xTaskToResume == NULL) return;
+
+    mn_port_task* task = mn_port_task_of(xTaskToResume);
+
+    pthread_mutex_lock(&task->lock);
+    task->suspended = false;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+}
+
+BaseType_t xTaskResumeFromISR(TaskHandle_t xTaskToResume) {
+    vTaskResume(xTaskToResume);
+    return pdFALSE;
+}
+
+void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority) {
+    mn_port_task* task = mn_port_task_of(xTask);
+    task->priority = (uxNewPriority < configMAX_PRIORITIES) ? uxNewPriority : configMAX_PRIORITIES - 1;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask) {
+    mn_port_task* task = mn_port_task_of(xTask);
+    return task->priority;
+}
+
+UBaseType_t uxTaskPriorityGetFromISR(TaskHandle_t xTask) {
+    return uxTaskPriorityGet(xTask);
+}
+
+eTaskState eTaskGetState(TaskHandle_t xTask) {
+    mn_port_task* task = mn_port_task_of(xTask);
+
+    if(task == mn_port_self()) return eRunning;
+    if(!mn_port_is_task(task)) return eDeleted;
+
+    if(task->deleted) return eDeleted;
+    if(task->suspended) return eSuspended;
+    if(task->blocked) return eBlocked;
+
+    return eReady;
+}
+
+BaseType_t xTaskGetAffinity(TaskHandle_t xTask) {
+    mn_port_task* task = mn_port_task_of(xTask);
+    return task->core;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks() {
+    mn_port_init();
+
+    pthread_mutex_lock(&g_portLock);
+    UBaseType_t _ret = g_taskCount;
+    pthread_mutex_unlock(&g_portLock);
+
+    return _ret;
+}
+
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask) {
+    return (xTask != NULL) ? mn_port_task_of(xTask)->number : 0;
+}
+
+void vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t *pxTaskStatus,
+                BaseType_t xGetFreeStackSpace, eTaskState eState) {
+    mn_port_task* task = mn_port_task_of(xTask);
+    mn_port_task_trace trace;
+
+    pxTaskStatus->xHandle = task;
+    pxTaskStatus->pcTaskName = task->name;
+    pxTaskStatus->xTaskNumber = task->number;
+    pxTaskStatus->eCurrentState = (eState == eInvalid) ? eTaskGetState(task) : eState;
+    pxTaskStatus->uxCurrentPriority = task->priority;
+    pxTaskStatus->uxBasePriority = task->priority;
+    pxTaskStatus->ulRunTimeCounter = (mn_port_get_task_trace(task, &trace) == pdPASS) ?
+                                        (uint32_t)trace.runTimeUs : 0;
+    pxTaskStatus->pxStackBase = NULL;
+    pxTaskStatus->usStackHighWaterMark = (xGetFreeStackSpace != pdFALSE) ? task->stackDepth : 0;
+    pxTaskStatus->xCoreID = task->core;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+    return mn_port_task_of(xTask)->stackDepth;
+}
+
+char* pcTaskGetTaskName(TaskHandle_t xTaskToQuery) {
+    mn_port_task* task = mn_port_task_of(xTaskToQuery);
+    return task->name;
+}
+
+TickType_t xTaskGetTickCount() {
+    mn_port_init();
+    return (TickType_t)(((mn_port_now_ns() - g_startTime) * configTICK_RATE_HZ) / MN_PORT_POSIX_NS_PER_SEC);
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return mn_port_self();
+}
+
+TaskHandle_t xTaskGetIdleTaskHandle() {
+    // The host has no idle tasks
+    return NULL;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t cpuid) {
+    (void)cpuid;
+    return NULL;
+}
+
+void vTaskStartScheduler() {
+    xPortStartScheduler();
+
+    pthread_mutex_lock(&g_schedularLock);
+    while(g_schedularRunning) {
+        pthread_cond_wait(&g_schedularCond, &g_schedularLock);
+    }
+    pthread_mutex_unlock(&g_schedularLock);
+}
+
+void vTaskEndScheduler() {
+    vPortEndScheduler();
+}
+
+void vTaskSuspendAll() {
+    mn_port_enter_critical_nested();
+}
+
+BaseType_t xTaskResumeAll() {
+    mn_port_exit_critical_nested(0);
+    return pdFALSE;
+}
+
+void taskYIELD() {
+    sched_yield();
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                eNotifyAction eAction, uint32_t *pulPreviousNotificationValue) {
+    if(xTaskToNotify == NULL) return pdFAIL;
+
+    mn_port_task* task = mn_port_task_of(xTaskToNotify);
+
+    BaseType_t _ret = pdPASS;
+
+    pthread_mutex_lock(&task->lock);
+
+    if(pulPreviousNotificationValue) *pulPreviousNotificationValue = task->notifyValue;
+
+    uint8_t _oldState = task->notifyState;
+
+    switch(eAction) {
+        case eSetBits:
+            task->notifyValue |= ulValue; break;
+        case eIncrement:
+            task->notifyValue++; break;
+        case eSetValueWithOverwrite:
+            task->notifyValue = ulValue; break;
+        case eSetValueWithoutOverwrite:
+            if(_oldState != MN_PORT_NOTIFY_RECEIVED) task->notifyValue = ulValue;
+            else _ret = pdFAIL;
+            break;
+        case eNoAction:
+        default:
+            break;
+    }
+    task->notifyState = MN_PORT_NOTIFY_RECEIVED;
+
+    if(_oldState == MN_PORT_NOTIFY_WAITING)
+        pthread_cond_broadcast(&task->cond);
+
+    pthread_mutex_unlock(&task->lock);
+
+    return _ret;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                uint32_t *pulNotificationValue, TickType_t xTicksToWait) {
+    mn_port_task* self = mn_port_self();
+    uint64_t deadline = mn_port_deadline(xTicksToWait);
+    BaseType_t _ret = pdFALSE;
+
+    pthread_mutex_lock(&self->lock);
+
+    if(self->notifyState != MN_PORT_NOTIFY_RECEIVED) {
+        self->notifyValue &= ~ulBitsToClearOnEntry;
+        self->notifyState = MN_PORT_NOTIFY_WAITING;
+
+        while(self->notifyState != MN_PORT_NOTIFY_RECEIVED) {
+            if(xTicksToWait == 0 || !mn_port_wait(&self->cond, &self->lock, deadline, MN_PORT_BLOCK_NOTIFY)) break;
+        }
+    }
+
+    if(pulNotificationValue) *pulNotificationValue = self->notifyValue;
+
+    if(self->notifyState == MN_PORT_NOTIFY_RECEIVED) {
+        self->notifyValue &= ~ulBitsToClearOnExit;
+        _ret = pdTRUE;
+    }
+    self->notifyState = MN_PORT_NOTIFY_NONE;
+
+    pthread_mutex_unlock(&self->lock);
+
+    return _ret;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+    mn_port_task* self = mn_port_self();
+    uint64_t deadline = mn_port_deadline(xTicksToWait);
+
+    pthread_mutex_lock(&self->lock);
+
+    if(self->notifyValue == 0) {
+        self->notifyState = MN_PORT_NOTIFY_WAITING;
+
+        // like FreeRTOS each notification unblocks the task, also eNoAction - 
+        // a wait for the value only lost the next notification (the state was not waiting)
+        while(self->notifyState == MN_PORT_NOTIFY_WAITING) {
+            if(xTicksToWait == 0 || !mn_port_wait(&self->cond, &self->lock, deadline, MN_PORT_BLOCK_NOTIFY)) break;
+        }
+    }
+
+    uint32_t _ret = self->notifyValue;
+
+    if(_ret != 0) {
+        if(xClearCountOnExit != pdFALSE) self->notifyValue = 0;
+        else self->notifyValue = _ret - 1;
+    }
+    self->notifyState = MN_PORT_NOTIFY_NONE;
+
+    pthread_mutex_unlock(&self->lock);
+
+    return _ret;
+}
+
+BaseType_t xTaskNotifyStateClear(TaskHandle_t xTask) {
+    mn_port_task* task = mn_port_task_of(xTask);
+    BaseType_t _ret = pdFAIL;
+
+    pthread_mutex_lock(&task->lock);
+    if(task->notifyState == MN_PORT_NOTIFY_RECEIVED) {
+        task->notifyState = MN_PORT_NOTIFY_NONE;
+        _ret = pdPASS;
+    }
+    pthread_mutex_unlock(&task->lock);
+
+    return _ret;
+}
+
+void vTaskSetThreadLocalStoragePointer(TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue) {
+    mn_port_task* task = mn_port_task_of(xTaskToSet);
+
+    if(xIndex >= 0 && xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS)
+        task->tls[xIndex] = pvValue;
+}
+
+void* pvTaskGetThreadLocalStoragePointer(TaskHandle_t xTaskToQuery, BaseType_t xIndex) {
+    mn_port_task* task = mn_port_task_of(xTaskToQuery);
+
+    if(xIndex >= 0 && xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS)
+        return task->tls[xIndex];
+    return NULL;
+}
+
+//-----------------------------------
+//  queue
+//-----------------------------------
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
+    if(uxQueueLength == 0) return NULL;
+    return mn_port_queue_create(uxQueueLength, uxItemSize, MN_PORT_QUEUE_BASE);
+}
+
+void vQueueDelete(QueueHandle_t xQueue) {
+    if(xQueue == NULL) return;
+
+    pthread_cond_destroy(&mn_port_queue_of(xQueue)->canRecv);
+    pthread_cond_destroy(&mn_port_queue_of(xQueue)->canSend);
+    pthread_mutex_destroy(&mn_port_queue_of(xQueue)->lock);
+
+    free(mn_port_queue_of(xQueue)->buffer);
+    free(xQueue);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait) {
+    return mn_port_queue_send(mn_port_queue_of(xQueue), pvItemToQueue, xTicksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait) {
+    return mn_port_queue_send(mn_port_queue_of(xQueue), pvItemToQueue, xTicksToWait, true);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t xQueue, const void * const pvItemToQueue) {
+    if(xQueue == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&mn_port_queue_of(xQueue)->lock);
+    mn_port_queue_of(xQueue)->head = 0;
+    mn_port_queue_of(xQueue)->count = 1;
+    memcpy(mn_port_queue_of(xQueue)->buffer, pvItemToQueue, mn_port_queue_of(xQueue)->itemSize);
+    pthread_cond_signal(&mn_port_queue_of(xQueue)->canRecv);
+    pthread_mutex_unlock(&mn_port_queue_of(xQueue)->lock);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait) {
+    return mn_port_queue_receive(mn_port_queue_of(xQueue), pvBuffer, xTicksToWait, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait) {
+    return mn_port_queue_receive(mn_port_queue_of(xQueue), pvBuffer, xTicksToWait, true);
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue) {
+    if(xQueue == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&mn_port_queue_of(xQueue)->lock);
+    mn_port_queue_of(xQueue)->head = 0;
+    mn_port_queue_of(xQueue)->count = 0;
+    pthread_cond_broadcast(&mn_port_queue_of(xQueue)->canSend);
+    pthread_mutex_unlock(&mn_port_queue_of(xQueue)->lock);
+
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue) {
+    if(xQueue == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_queue_of(xQueue)->lock);
+    UBaseType_t _ret = mn_port_queue_of(xQueue)->count;
+    pthread_mutex_unlock(&mn_port_queue_of(xQueue)->lock);
+
+    return _ret;
+}
+
+UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t xQueue) {
+    if(xQueue == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_queue_of(xQueue)->lock);
+    UBaseType_t _ret = mn_port_queue_of(xQueue)->length - mn_port_queue_of(xQueue)->count;
+    pthread_mutex_unlock(&mn_port_queue_of(xQueue)->lock);
+
+    return _ret;
+}
+
+//-----------------------------------
+//  semaphore
+//-----------------------------------
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    mn_port_queue* queue = mn_port_queue_create(1, 0, MN_PORT_QUEUE_MUTEX);
+    if(queue) queue->count = 1;
+    return queue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    mn_port_queue* queue = mn_port_queue_create(1, 0, MN_PORT_QUEUE_RECURSIVE_MUTEX);
+    if(queue) queue->count = 1;
+    return queue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return mn_port_queue_create(1, 0, MN_PORT_QUEUE_BINARY);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount) {
+    if(uxMaxCount == 0 || uxInitialCount > uxMaxCount) return NULL;
+
+    mn_port_queue* queue = mn_port_queue_create(uxMaxCount, 0, MN_PORT_QUEUE_COUNTING);
+    if(queue) queue->count = uxInitialCount;
+    return queue;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait) {
+    return mn_port_queue_receive(mn_port_queue_of(xSemaphore), NULL, xTicksToWait, false);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+    return mn_port_queue_send(mn_port_queue_of(xSemaphore), NULL, 0, false);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xTicksToWait) {
+    if(xMutex == NULL) return pdFAIL;
+
+    mn_port_task* self = mn_port_self();
+
+    pthread_mutex_lock(&mn_port_queue_of(xMutex)->lock);
+    if(mn_port_queue_of(xMutex)->holder == self) {
+        mn_port_queue_of(xMutex)->recursion++;
+        pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+        return pdPASS;
+    }
+    pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+
+    if(mn_port_queue_receive(mn_port_queue_of(xMutex), NULL, xTicksToWait, false) != pdPASS)
+        return pdFAIL;
+
+    pthread_mutex_lock(&mn_port_queue_of(xMutex)->lock);
+    mn_port_queue_of(xMutex)->recursion = 1;
+    pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex) {
+    if(xMutex == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&mn_port_queue_of(xMutex)->lock);
+    if(mn_port_queue_of(xMutex)->holder != mn_port_self()) {
+        pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+        return pdFAIL;
+    }
+    if(--mn_port_queue_of(xMutex)->recursion > 0) {
+        pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+        return pdPASS;
+    }
+    pthread_mutex_unlock(&mn_port_queue_of(xMutex)->lock);
+
+    return mn_port_queue_send(mn_port_queue_of(xMutex), NULL, 0, false);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t xSemaphore) {
+    return uxQueueMessagesWaiting(xSemaphore);
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t xSemaphore) {
+    if(xSemaphore == NULL) return NULL;
+
+    pthread_mutex_lock(&mn_port_queue_of(xSemaphore)->lock);
+    TaskHandle_t _ret = mn_port_queue_of(xSemaphore)->holder;
+    pthread_mutex_unlock(&mn_port_queue_of(xSemaphore)->lock);
+
+    return _ret;
+}
+
+//-----------------------------------
+//  event group
+//-----------------------------------
+EventGroupHandle_t xEventGroupCreate() {
+    mn_port_init();
+
+    mn_port_eventgroup* group = (mn_port_eventgroup*)calloc(1, sizeof(mn_port_eventgroup));
+    if(group == NULL) return NULL;
+
+    pthread_mutex_init(&group->lock, NULL);
+    mn_port_cond_init(&group->cond);
+
+    return group;
+}
+
+void vEventGroupDelete(EventGroupHandle_t xEventGroup) {
+    if(xEventGroup == NULL) return;
+
+    pthread_cond_destroy(&mn_port_eventgroup_of(xEventGroup)->cond);
+    pthread_mutex_destroy(&mn_port_eventgroup_of(xEventGroup)->lock);
+    free(xEventGroup);
+}
+
+static inline bool mn_port_bits_match(EventBits_t bits, EventBits_t waitFor, bool waitAll) {
+    return waitAll ? ((bits & waitFor) == waitFor) : ((bits & waitFor) != 0);
+}
+
+#if defined(__GNUC__) && (__GNUC__ >= 12)
+// the waiter is on the stack, but it is removed from the list before the return:
+// the setter removes a done waiter, the wait removes a timed out one
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdangling-pointer"
+#endif
+/**
+ * Wait on the event group, must be called with the group locked
+ */
+static EventBits_t mn_port_eventgroup_wait(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                        bool clearOnExit, bool waitAll, TickType_t xTicksToWait) {
+    EventBits_t _ret = mn_port_eventgroup_of(xEventGroup)->bits;
+
+    if(mn_port_bits_match(_ret, uxBitsToWaitFor, waitAll)) {
+        if(clearOnExit) mn_port_eventgroup_of(xEventGroup)->bits &= ~uxBitsToWaitFor;
+        return _ret;
+    }
+    if(xTicksToWait == 0) return _ret;
+
+    uint64_t deadline = mn_port_deadline(xTicksToWait);
+
+    mn_port_eventwaiter waiter;
+    waiter.waitFor = uxBitsToWaitFor;
+    waiter.waitAll = waitAll;
+    waiter.clearOnExit = clearOnExit;
+    waiter.done = false;
+    waiter.result = 0;
+    waiter.next = mn_port_eventgroup_of(xEventGroup)->waiters;
+    mn_port_eventgroup_of(xEventGroup)->waiters = &waiter;
+
+    while(!waiter.done) {
+        if(!mn_port_wait(&mn_port_eventgroup_of(xEventGroup)->cond, &mn_port_eventgroup_of(xEventGroup)->lock, deadline, MN_PORT_BLOCK_EVENT)) break;
+    }
+
+    if(!waiter.done) {
+        mn_port_eventwaiter** it = &mn_port_eventgroup_of(xEventGroup)->waiters;
+        while(*it != NULL) {
+            if(*it == &waiter) { *it = waiter.next; break; }
+            it = &(*it)->next;
+        }
+        return mn_port_eventgroup_of(xEventGroup)->bits;
+    }
+    return waiter.result;
+}
+#if defined(__GNUC__) && (__GNUC__ >= 12)
+#pragma GCC diagnostic pop
+#endif
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                        const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait) {
+    if(xEventGroup == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_eventgroup_of(xEventGroup)->lock);
+    EventBits_t _ret = mn_port_eventgroup_wait(xEventGroup, uxBitsToWaitFor,
+                            xClearOnExit != pdFALSE, xWaitForAllBits != pdFALSE, xTicksToWait);
+    pthread_mutex_unlock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    return _ret;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet) {
+    if(xEventGroup == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    mn_port_eventgroup_of(xEventGroup)->bits |= uxBitsToSet;
+
+    EventBits_t _clear = 0;
+    bool _woken = false;
+    mn_port_eventwaiter** it = &mn_port_eventgroup_of(xEventGroup)->waiters;
+
+    while(*it != NULL) {
+        mn_port_eventwaiter* waiter = *it;
+
+        if(mn_port_bits_match(mn_port_eventgroup_of(xEventGroup)->bits, waiter->waitFor, waiter->waitAll)) {
+            waiter->result = mn_port_eventgroup_of(xEventGroup)->bits;
+            waiter->done = true;
+            if(waiter->clearOnExit) _clear |= waiter->waitFor;
+
+            *it = waiter->next;
+            _woken = true;
+        } else {
+            it = &waiter->next;
+        }
+    }
+    mn_port_eventgroup_of(xEventGroup)->bits &= ~_clear;
+
+    EventBits_t _ret = mn_port_eventgroup_of(xEventGroup)->bits;
+
+    if(_woken) pthread_cond_broadcast(&mn_port_eventgroup_of(xEventGroup)->cond);
+    pthread_mutex_unlock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    return _ret;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear) {
+    if(xEventGroup == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_eventgroup_of(xEventGroup)->lock);
+    EventBits_t _ret = mn_port_eventgroup_of(xEventGroup)->bits;
+    mn_port_eventgroup_of(xEventGroup)->bits &= ~uxBitsToClear;
+    pthread_mutex_unlock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    return _ret;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t xEventGroup) {
+    if(xEventGroup == NULL) return 0;
+
+    pthread_mutex_lock(&mn_port_eventgroup_of(xEventGroup)->lock);
+    EventBits_t _ret = mn_port_eventgroup_of(xEventGroup)->bits;
+    pthread_mutex_unlock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    return _ret;
+}
+
+EventBits_t xEventGroupSync(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet,
+                        const EventBits_t uxBitsToWaitFor, TickType_t xTicksToWait) {
+    if(xEventGroup == NULL) return 0;
+
+    xEventGroupSetBits(xEventGroup, uxBitsToSet);
+
+    pthread_mutex_lock(&mn_port_eventgroup_of(xEventGroup)->lock);
+    EventBits_t _ret = mn_port_eventgroup_wait(xEventGroup, uxBitsToWaitFor,
+                            true, true, xTicksToWait);
+    pthread_mutex_unlock(&mn_port_eventgroup_of(xEventGroup)->lock);
+
+    return _ret;
+}
+
+//-----------------------------------
+//  timer
+//-----------------------------------
+TimerHandle_t xTimerCreate(const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+                    const UBaseType_t uxAutoReload, void * const pvTimerID, TimerCallbackFunction_t pxCallbackFunction) {
+    mn_port_init();
+
+    if(xTimerPeriodInTicks == 0 || pxCallbackFunction == NULL) return NULL;
+
+    mn_port_timer* timer = (mn_port_timer*)calloc(1, sizeof(mn_port_timer));
+    if(timer == NULL) return NULL;
+
+    strncpy(timer->name, pcTimerName ? pcTimerName : "", sizeof(timer->name) - 1);
+    timer->period = xTimerPeriodInTicks;
+    timer->autoReload = uxAutoReload != pdFALSE;
+    timer->id = pvTimerID;
+    timer->callback = pxCallbackFunction;
+
+    pthread_mutex_lock(&g_timerLock);
+    if(!mn_port_timer_service()) {
+        pthread_mutex_unlock(&g_timerLock);
+        free(timer);
+        return NULL;
+    }
+    timer->next = g_timerList;
+    g_timerList = timer;
+    pthread_mutex_unlock(&g_timerLock);
+
+    return timer;
+}
+
+BaseType_t xTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if(xTimer == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&g_timerLock);
+    mn_port_timer_of(xTimer)->active = false;
+    mn_port_timer_of(xTimer)->deleted = true;
+
+    // the service task free the timer after the running callback
+    if(g_timerRunning != xTimer) mn_port_timer_free(mn_port_timer_of(xTimer));
+    pthread_mutex_unlock(&g_timerLock);
+
+    return pdPASS;
+}
+
+BaseType_t xTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if(xTimer == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&g_timerLock);
+    mn_port_timer_of(xTimer)->expiry = mn_port_now_ns() + mn_port_ticks_to_ns(mn_port_timer_of(xTimer)->period);
+    mn_port_timer_of(xTimer)->active = true;
+    pthread_cond_broadcast(&g_timerCond);
+    pthread_mutex_unlock(&g_timerLock);
+
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if(xTimer == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&g_timerLock);
+    mn_port_timer_of(xTimer)->active = false;
+    pthread_mutex_unlock(&g_timerLock);
+
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    return xTimerStart(xTimer, xTicksToWait);
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait) {
+    if(xTimer == NULL || xNewPeriod == 0) return pdFAIL;
+
+    pthread_mutex_lock(&g_timerLock);
+    mn_port_timer_of(xTimer)->period = xNewPeriod;
+    pthread_mutex_unlock(&g_timerLock);
+
+    return xTimerStart(xTimer, xTicksToWait);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t xTimer) {
+    if(xTimer == NULL) return pdFALSE;
+
+    pthread_mutex_lock(&g_timerLock);
+    BaseType_t _ret = mn_port_timer_of(xTimer)->active ? pdTRUE : pdFALSE;
+    pthread_mutex_unlock(&g_timerLock);
+
+    return _ret;
+}
+
+void* pvTimerGetTimerID(const TimerHandle_t xTimer) {
+    return (xTimer != NULL) ? mn_port_timer_of(xTimer)->id : NULL;
+}
+
+void vTimerSetTimerID(TimerHandle_t xTimer, void *pvNewID) {
+    if(xTimer != NULL) mn_port_timer_of(xTimer)->id = pvNewID;
+}
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t xFunctionToPend, void *pvParameter1,
+                    uint32_t ulParameter2, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    mn_port_init();
+
+    if(xFunctionToPend == NULL) return pdFAIL;
+
+    pthread_mutex_lock(&g_timerLock);
+    if(!mn_port_timer_service()) {
+        pthread_mutex_unlock(&g_timerLock);
+        return pdFAIL;
+    }
+    g_pendedCalls.push_back( mn_port_pended_call{ xFunctionToPend, pvParameter1, ulParameter2 } );
+    pthread_cond_broadcast(&g_timerCond);
+    pthread_mutex_unlock(&g_timerLock);
+
+    return pdPASS;
+}
+
+#endif // MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_LINUX
@@ -39,16 +39,42 @@ namespace mn {
             m_uiMaxWorkItems(uiMaxWorkItems),
             m_uiNumWorks(0),
             m_uiErrorsNumWorks(0),
+            m_uiPending(0),
+            m_uiTimers(0),
+            m_pItemPool(NULL),
             m_bRunning(false) { 
 
-            m_pWorkItemQueue = new queue_t(uiMaxWorkItems, sizeof(work_queue_item_t *));
+            // engines with own queues, i.e. the priority engine, have no job queue
+            if(uiMaxWorkItems != 0) {
+                m_pWorkItemQueue = new queue_t(uiMaxWorkItems, sizeof(work_queue_item_t *));
+                m_pWorkItemQueue->create();
+            }
+            // the item pool is allocated on the first create_item, see alloc_block
         }
 
         //-----------------------------------
         //  deconstructor
         //-----------------------------------
         basic_work_queue::~basic_work_queue() {
-            destroy();
+            // the engine is destroyed from the engine destructor, 
+            // destroy_engine is pure virtual here
+            // the not fired delayed items
+            for(size_t i = 0; i < m_vTimers.size(); i++) {
+                if(m_vTimers[i].item->can_delete() && m_vTimers[i].item->can_release()) 
+                    m_vTimers[i].item->release();
+            }
+            m_vTimers.clear();
+
+            if(m_pWorkItemQueue) {
+                m_pWorkItemQueue->destroy();
+                delete m_pWorkItemQueue; m_pWorkItemQueue = NULL;
+            }
+            // after the timer items, a pooled item gives the block back to the pool
+#if MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE > 0
+            if(m_pItemPool) {
+                delete m_pItemPool; m_pItemPool = NULL;
+            }
+#endif
         }
 
         //-----------------------------------
@@ -85,55 +111,524 @@ namespace mn {
         //  queue
         //-----------------------------------
         int basic_work_queue::queue(work_queue_item_t *work, unsigned int timeout) {
-            automutx_t lock(m_ThreadJob);
+            // the queue is thread safe, no lock here - a producer waits only 
+            // when the queue is full, never on a worker's dequeue timeout
+            m_uiPending++;
+            stamp_queued(work);
+
+            // the queue holds the pointer to the item, not the item
+            if(m_pWorkItemQueue->enqueue(&work, timeout) != ERR_QUEUE_OK) {
+                m_uiPending--;
+                return ERR_WORKQUEUE_ADD;
+            }
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  queue_bulk
+        //-----------------------------------
+        int basic_work_queue::queue_bulk(work_queue_item_t **items, uint32_t n, 
+                                        unsigned int timeout, uint32_t* queued) {
+            uint32_t _queued = 0;
+            int ret = ERR_WORKQUEUE_OK;
+
+            m_uiPending += n;
+
+            while(_queued < n) {
+                uint32_t _count = n - _queued;
+                if(_count > MN_THREAD_CONFIG_WORKQUEUE_BATCH_SIZE) 
+                    _count = MN_THREAD_CONFIG_WORKQUEUE_BATCH_SIZE;
+
+                work_queue_item_t** _batch = items + _queued;
+
+                for(uint32_t i = 0; i + 1 < _count; i++) 
+                    link_next(_batch[i], _batch[i + 1]);
+                link_next(_batch[_count - 1], NULL);
+
+                for(uint32_t i = 0; i < _count; i++) 
+                    stamp_queued(_batch[i]);
+
+                // one entry for the batch, the queue holds the pointer to the first item
+                if(m_pWorkItemQueue->enqueue(_batch, timeout) != ERR_QUEUE_OK) {
+                    for(uint32_t i = 0; i < _count; i++) 
+                        link_next(_batch[i], NULL);
+
+                    m_uiPending -= (n - _queued);
+                    ret = ERR_WORKQUEUE_ADD;
+                    break;
+                }
+                _queued += _count;
+            }
+
+            if(queued) *queued = _queued;
+            return ret;
+        }
+
+        //-----------------------------------
+        //  timer heap helpers
+        //-----------------------------------
+        static inline bool timer_before(TickType_t a, TickType_t b) {
+            // the tick count wraps around
+            return (int32_t)(a - b) < 0;
+        }
+
+        template <class TENTRY>
+        static void timer_heap_up(std::vector<TENTRY>& heap, size_t pos) {
+            while(pos > 0) {
+                size_t _parent = (pos - 1) / 2;
+                if(!timer_before(heap[pos].due, heap[_parent].due)) break;
+
+                TENTRY _tmp = heap[pos]; heap[pos] = heap[_parent]; heap[_parent] = _tmp;
+                pos = _parent;
+            }
+        }
+
+        template <class TENTRY>
+        static void timer_heap_down(std::vector<TENTRY>& heap, size_t pos) {
+            size_t _size = heap.size();
+
+            for(;;) {
+                size_t _min = pos;
+                size_t _left = pos * 2 + 1;
+                size_t _right = _left + 1;
+
+                if(_left < _size && timer_before(heap[_left].due, heap[_min].due)) _min = _left;
+                if(_right < _size && timer_before(heap[_right].due, heap[_min].due)) _min = _right;
+                if(_min == pos) break;
+
+                TENTRY _tmp = heap[pos]; heap[pos] = heap[_min]; heap[_min] = _tmp;
+                pos = _min;
+            }
+        }
+
+        template <class TENTRY>
+        static void timer_heap_remove(std::vector<TENTRY>& heap, size_t pos) {
+            heap[pos] = heap.back();
+            heap.pop_back();
+
+            if(pos < heap.size()) {
+                timer_heap_down(heap, pos);
+                timer_heap_up(heap, pos);
+            }
+        }
+
+        //-----------------------------------
+        //  queue_after
+        //-----------------------------------
+        int basic_work_queue::queue_after(work_queue_item_t *work, unsigned int delay) {
+            if(delay == 0) return queue(work, 0);
+
+            timer_entry _entry = { xTaskGetTickCount() + delay, 0, work };
+            bool _first = false;
+
+            // a delayed item is pending, is_ready is false until it is worked
+            m_uiPending++;
+
+            m_TimerLock.lock();
+                m_vTimers.push_back(_entry);
+                timer_heap_up(m_vTimers, m_vTimers.size() - 1);
+                _first = (m_vTimers[0].item == work);
+                m_uiTimers++;
+            m_TimerLock.unlock();
+
+            // the next due item is changed, the waiting worker must calculate the new wait time
+            if(_first) wake_for_timer();
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  queue_every
+        //-----------------------------------
+        int basic_work_queue::queue_every(work_queue_item_t *work, unsigned int period) {
+            if(period == 0 || work->can_delete()) return ERR_WORKQUEUE_ADD;
+
+            timer_entry _entry = { xTaskGetTickCount() + period, period, work };
+            bool _first = false;
+
+            m_TimerLock.lock();
+                m_vTimers.push_back(_entry);
+                timer_heap_up(m_vTimers, m_vTimers.size() - 1);
+                _first = (m_vTimers[0].item == work);
+                m_uiTimers++;
+            m_TimerLock.unlock();
+
+            if(_first) wake_for_timer();
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  cancel
+        //-----------------------------------
+        int basic_work_queue::cancel(work_queue_item_t *work) {
+            automutx_t lock(m_TimerLock);
+
+            for(size_t i = 0; i < m_vTimers.size(); i++) {
+                if(m_vTimers[i].item != work) continue;
+
+                if(m_vTimers[i].period == 0) m_uiPending--;
+
+                timer_heap_remove(m_vTimers, i);
+                m_uiTimers--;
+
+                return ERR_WORKQUEUE_OK;
+            }
+            return ERR_WORKQUEUE_NOTFOUND;
+        }
+
+        //-----------------------------------
+        //  get_num_timers
+        //-----------------------------------
+        uint32_t basic_work_queue::get_num_timers() {
+            return m_uiTimers.load();
+        }
+
+        //-----------------------------------
+        //  get_pool_free
+        //-----------------------------------
+        uint32_t basic_work_queue::get_pool_free() {
+#if MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE > 0
+            item_pool_t* _pool = __atomic_load_n(&m_pItemPool, __ATOMIC_ACQUIRE);
+            return _pool ? _pool->get_free() : MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE;
+#else
+            return 0;
+#endif
+        }
+
+        //-----------------------------------
+        //  get_pool_size
+        //-----------------------------------
+        uint32_t basic_work_queue::get_pool_size() {
+#if MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE > 0
+            return MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE;
+#else
+            return 0;
+#endif
+        }
+
+        //-----------------------------------
+        //  alloc_block
+        //-----------------------------------
+        void* basic_work_queue::alloc_block() {
+#if MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE > 0
+            item_pool_t* _pool = __atomic_load_n(&m_pItemPool, __ATOMIC_ACQUIRE);
+
+            if(_pool == NULL) {
+                // the first item, a queue without create_item has no pool - 
+                // not allocated from a ISR, the pool is then empty
+                if(xPortInIsrContext()) return NULL;
+
+                _pool = new item_pool_t();
+                if(_pool == NULL) return NULL;
+
+                item_pool_t* _expected = NULL;
+                if(!__atomic_compare_exchange_n(&m_pItemPool, &_expected, _pool, false,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    // a other task was faster
+                    delete _pool;
+                    _pool = _expected;
+                }
+            }
+            return _pool->allocate();
+#else
+            return NULL;
+#endif
+        }
+
+        //-----------------------------------
+        //  free_block
+        //-----------------------------------
+        void basic_work_queue::free_block(void* block) {
+#if MN_THREAD_CONFIG_WORKQUEUE_POOL_SIZE > 0
+            // a block is only allocated from a created pool
+            item_pool_t* _pool = __atomic_load_n(&m_pItemPool, __ATOMIC_ACQUIRE);
+            if(_pool) _pool->deallocate(static_cast<item_block_t*>(block));
+#else
+            (void)block;
+#endif
+        }
 
-            int ret = m_pWorkItemQueue->enqueue(work, timeout);
+        //-----------------------------------
+        //  try_run_one
+        //-----------------------------------
+        bool basic_work_queue::try_run_one() {
+            work_queue_item_t* _item = get_next_item(0);
+            if(_item == NULL) return false;
 
-            return ret == 0 ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_ADD;
+            run_batch(_item);
+            return true;
+        }
+
+        //-----------------------------------
+        //  service_timers
+        //-----------------------------------
+        unsigned int basic_work_queue::service_timers(unsigned int timeout) {
+            if(m_uiTimers.load() == 0) return timeout;
+
+            // an other worker services the timers
+            if(m_TimerLock.lock(0) != ERR_MUTEX_OK) return timeout;
+
+            TickType_t _now = xTaskGetTickCount();
+
+            while(!m_vTimers.empty() && !timer_before(_now, m_vTimers[0].due)) {
+                timer_entry _entry = m_vTimers[0];
+                bool _periodic = (_entry.period != 0);
+
+                if(_periodic && _entry.item->m_bTimerQueued) {
+                    // the last period is not started, skip this period
+                } else {
+                    if(_periodic) _entry.item->m_bTimerQueued = true;
+
+                    if(queue_due(_entry.item) != ERR_WORKQUEUE_OK) {
+                        // the queue is full, try it on the next tick
+                        if(_periodic) _entry.item->m_bTimerQueued = false;
+
+                        m_vTimers[0].due = _now + 1;
+                        timer_heap_down(m_vTimers, 0);
+                        break;
+                    }
+                }
+
+                if(_periodic) {
+                    // fixed rate, after a long stop start again from now
+                    m_vTimers[0].due += _entry.period;
+                    if(timer_before(m_vTimers[0].due, _now)) m_vTimers[0].due = _now + _entry.period;
+                    timer_heap_down(m_vTimers, 0);
+                } else {
+                    // the item is now pending in the queue
+                    m_uiPending--;
+                    timer_heap_remove(m_vTimers, 0);
+                    m_uiTimers--;
+                }
+            }
+
+            if(!m_vTimers.empty()) {
+                unsigned int _next = (unsigned int)(m_vTimers[0].due - _now);
+                if(_next < timeout) timeout = _next;
+            }
+            m_TimerLock.unlock();
+
+            return timeout;
+        }
+
+        //-----------------------------------
+        //  wake_for_timer
+        //-----------------------------------
+        void basic_work_queue::wake_for_timer() {
+            if(m_pWorkItemQueue == NULL) return;
+
+            // the NULL item wakes a worker, the worker looks again for the timers
+            work_queue_item_t* _wake = NULL;
+            m_pWorkItemQueue->enqueue(&_wake, 0);
         }
 
         //-----------------------------------
         //  get_next_item
         //-----------------------------------
         work_queue_item* basic_work_queue::get_next_item(unsigned int timeout) {
-            automutx_t lock(m_ThreadJob);
-
             work_queue_item_t* job = 0;
 
-            if(m_pWorkItemQueue->is_empty()) return NULL;
-            
-            m_pWorkItemQueue->dequeue(&job, timeout);
+            // the queue is thread safe, do not hold m_ThreadJob while waiting,
+            // that blocks all producers in queue()
+            if(m_pWorkItemQueue->dequeue(&job, timeout) != ERR_QUEUE_OK) 
+                return NULL;
 
             return job;
         }
 
         //-----------------------------------
-        //  get_num_items_worked
+        //  run_item
+        //-----------------------------------
+        void basic_work_queue::run_item(work_queue_item* item) {
+            // a periodic item can queued again from the timer
+            item->m_bTimerQueued = false;
+            // do not touch a not deleted item after on_work, the owner can
+            // reuse or destroy it (i.e. a graph node)
+            bool _delete = item->can_delete();
+
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS == MN_THREAD_CONFIG_YES
+            unsigned long _start = micros();
+            m_histWait.add((uint32_t)(_start - item->get_queued_time()));
+
+            bool _ret = item->on_work();
+            m_histRun.add((uint32_t)(micros() - _start));
+#else
+            bool _ret = item->on_work();
+#endif
+            if(_ret)
+                m_uiNumWorks++;
+            else
+                m_uiErrorsNumWorks++;
+
+            // delete or give the block back to the item pool
+            if (_delete && item->can_release()) {
+                item->release(); 
+            }
+            m_uiPending--;
+        }
+
         //-----------------------------------
-        uint8_t basic_work_queue::get_num_items_worked() { 
-            automutx_t lock(m_ThreadStatus);
+        //  run_batch
+        //-----------------------------------
+        void basic_work_queue::run_batch(work_queue_item* item) {
+            while(item != NULL) {
+                // unlink before the run, the item can be deleted or queued again
+                work_queue_item* _next = unlink_next(item);
+
+                run_item(item);
+                item = _next;
+            }
+        }
 
-            return m_uiNumWorks; 
+        //-----------------------------------
+        //  release_batch
+        //-----------------------------------
+        void basic_work_queue::release_batch(work_queue_item* item) {
+            while(item != NULL) {
+                work_queue_item* _next = unlink_next(item);
+
+                if (item->can_delete() && item->can_release()) {
+                    item->release(); 
+                }
+                m_uiPending--;
+                item = _next;
+            }
+        }
+
+        //-----------------------------------
+        //  get_num_items_worked
+        //-----------------------------------
+        uint64_t basic_work_queue::get_num_items_worked() { 
+            return m_uiNumWorks.load(); 
         }
 
         //-----------------------------------
         //  get_num_items_error
         //-----------------------------------
-        uint8_t basic_work_queue::get_num_items_error() { 
-            automutx_t lock(m_ThreadStatus);
+        uint64_t basic_work_queue::get_num_items_error() { 
+            return m_uiErrorsNumWorks.load();
+        }
 
-            return m_uiErrorsNumWorks;
+        //-----------------------------------
+        //  get_num_items_pending
+        //-----------------------------------
+        uint32_t basic_work_queue::get_num_items_pending() { 
+            return m_uiPending.load();
         }
 
         //-----------------------------------
-        //  is_ready
+        //  get_wait_histogram
         //-----------------------------------
-        bool basic_work_queue::is_ready() {
-            automutx_t lock(m_ThreadStatus);
+        bool basic_work_queue::get_wait_histogram(work_queue_histogram& hist) {
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS == MN_THREAD_CONFIG_YES
+            m_histWait.get(hist);
+            return true;
+#else
+            (void)hist;
+            return false;
+#endif
+        }
+
+        //-----------------------------------
+        //  get_run_histogram
+        //-----------------------------------
+        bool basic_work_queue::get_run_histogram(work_queue_histogram& hist) {
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS == MN_THREAD_CONFIG_YES
+            m_histRun.get(hist);
+            return true;
+#else
+            (void)hist;
+            return false;
+#endif
+        }
 
-            uint8_t ready = m_uiNumWorks + m_uiErrorsNumWorks;
+        //-----------------------------------
+        //  reset_stats
+        //-----------------------------------
+        void basic_work_queue::reset_stats() {
+            m_uiNumWorks = 0;
+            m_uiErrorsNumWorks = 0;
+
+            m_histWait.reset();
+            m_histRun.reset();
+        }
+
+        //-----------------------------------
+        //  latency_histogram::add
+        //-----------------------------------
+        void basic_work_queue::latency_histogram::add(uint32_t us) {
+            // log2 bucket, 0 for under 1us
+            int _bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);
+            if(_bucket >= MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS) 
+                _bucket = MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS - 1;
+
+            buckets[_bucket].fetch_add(1, memory_order::Relaxed);
+            count.fetch_add(1, memory_order::Relaxed);
+            sum.fetch_add(us, memory_order::Relaxed);
+
+            uint32_t _max = max.load(memory_order::Relaxed);
+            while(us > _max) {
+                if(max.compare_exchange_weak(_max, us, memory_order::Relaxed)) break;
+            }
+        }
 
-            return (ready == m_uiMaxWorkItems) && m_pWorkItemQueue->is_empty();
+        //-----------------------------------
+        //  latency_histogram::get
+        //-----------------------------------
+        void basic_work_queue::latency_histogram::get(work_queue_histogram& hist) {
+            for(int i = 0; i < MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS; i++)
+                hist.buckets[i] = buckets[i].load(memory_order::Relaxed);
+
+            hist.count = count.load(memory_order::Relaxed);
+            hist.sum_us = sum.load(memory_order::Relaxed);
+            hist.max_us = max.load(memory_order::Relaxed);
+        }
+
+        //-----------------------------------
+        //  latency_histogram::reset
+        //-----------------------------------
+        void basic_work_queue::latency_histogram::reset() {
+            for(int i = 0; i < MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS; i++)
+                buckets[i].store(0, memory_order::Relaxed);
+
+            count.store(0, memory_order::Relaxed);
+            sum.store(0, memory_order::Relaxed);
+            max.store(0, memory_order::Relaxed);
+        }
+
+        //-----------------------------------
+        //  work_queue_histogram::percentile_us
+        //-----------------------------------
+        uint32_t work_queue_histogram::percentile_us(uint32_t uiPercent) const {
+            uint64_t _total = 0;
+            for(int i = 0; i < MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS; i++) 
+                _total += buckets[i];
+            if(_total == 0) return 0;
+
+            // the rank of the percentile, at least the first item
+            uint64_t _rank = (_total * uiPercent + 99) / 100;
+            if(_rank == 0) _rank = 1;
+
+            uint64_t _sum = 0;
+            for(int i = 0; i < MN_THREAD_CONFIG_WORKQUEUE_HIST_BUCKETS - 1; i++) {
+                _sum += buckets[i];
+                if(_sum < _rank) continue;
+
+                // the upper bound of the bucket
+                uint32_t _upper = (uint32_t)1 << i;
+                return (_upper < max_us) ? _upper : max_us;
+            }
+            return max_us;
+        }
+
+        //-----------------------------------
+        //  is_ready
+        //-----------------------------------
+        bool basic_work_queue::is_ready() {
+            // m_uiPending is counted up before the enqueue and down after the 
+            // item is worked, no item is lost between the queue and the worker
+            return m_uiPending.load() == 0;
         }
     }
-}
\ No newline at end of file
+}
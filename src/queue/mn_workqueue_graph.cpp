@@ -0,0 +1,209 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "queue/mn_workqueue_graph.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  work_graph_node::constructor
+        //-----------------------------------
+        work_graph_node::work_graph_node(basic_work_graph* graph, work_queue_item_t* work)
+            : work_queue_item_t(false, work->get_priority()), m_pGraph(graph), m_pWork(work),
+              m_pNextReady(NULL), m_uiNumPreds(0), m_uiWaiting(0) { }
+
+        //-----------------------------------
+        //  work_graph_node::succeed
+        //-----------------------------------
+        int work_graph_node::succeed(work_graph_node* node) {
+            if(node == NULL || node->m_pGraph != m_pGraph || node == this)
+                return ERR_WORKQUEUE_ADD;
+            if(m_pGraph->is_running())
+                return ERR_WORKQUEUE_BUSY;
+
+            node->m_vSuccessors.push_back(this);
+            m_uiNumPreds++;
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  work_graph_node::run_work
+        //-----------------------------------
+        bool work_graph_node::run_work() {
+            bool _ret = m_pWork->on_work();
+            if(!_ret) m_pGraph->m_uiErrors++;
+
+            return _ret;
+        }
+
+        //-----------------------------------
+        //  work_graph_node::on_work
+        //-----------------------------------
+        bool work_graph_node::on_work() {
+            basic_work_graph* _graph = m_pGraph;
+            work_graph_node* _node = this;
+            // the ready nodes, that do not fit in the full queue - run here
+            // one after the other and not recursive. A node gets ready only
+            // once in a run, so the nodes are linked without allocation
+            work_graph_node* _ready = NULL;
+            bool _ret = run_work();
+
+            while(_node != NULL) {
+                work_graph_node* _next = NULL;
+
+                // the first ready successor runs here, a chain needs no queue
+                for(size_t i = 0; i < _node->m_vSuccessors.size(); i++) {
+                    work_graph_node* _succ = _node->m_vSuccessors[i];
+
+                    if(--_succ->m_uiWaiting == 0) {
+                        if(_next == NULL) _next = _succ;
+                        else if(!_graph->schedule(_succ)) {
+                            _succ->m_pNextReady = _ready;
+                            _ready = _succ;
+                        }
+                    }
+                }
+                // do not touch the nodes after the last finished, the run is over
+                _graph->finished();
+
+                if(_next == NULL && _ready != NULL) {
+                    _next = _ready;
+                    _ready = _ready->m_pNextReady;
+                }
+                _node = _next;
+                if(_node != NULL) _node->run_work();
+            }
+            return _ret;
+        }
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_graph::basic_work_graph()
+            : m_pQueue(NULL), m_uiRemaining(0), m_uiErrors(0), m_bRunning(false) { }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_graph::~basic_work_graph() {
+            for(size_t i = 0; i < m_vNodes.size(); i++)
+                delete m_vNodes[i];
+            m_vNodes.clear();
+        }
+
+        //-----------------------------------
+        //  add
+        //-----------------------------------
+        work_graph_node* basic_work_graph::add(work_queue_item_t* work) {
+            if(work == NULL || work->can_delete() || is_running())
+                return NULL;
+
+            work_graph_node* _node = new work_graph_node(this, work);
+            if(_node) m_vNodes.push_back(_node);
+
+            return _node;
+        }
+
+        //-----------------------------------
+        //  start
+        //-----------------------------------
+        int basic_work_graph::start(basic_work_queue& queue, unsigned int timeout) {
+            bool _expected = false;
+            bool _desired = true;
+
+            if(!m_bRunning.compare_exchange_strong(_expected, _desired))
+                return ERR_WORKQUEUE_BUSY;
+
+            // the semaphore is given from the constructor
+            m_semDone.lock(0);
+
+            uint32_t _roots = 0;
+            for(size_t i = 0; i < m_vNodes.size(); i++) {
+                m_vNodes[i]->m_uiWaiting = m_vNodes[i]->m_uiNumPreds;
+                if(m_vNodes[i]->m_uiNumPreds == 0) _roots++;
+            }
+
+            if(m_vNodes.empty()) {
+                m_semDone.unlock();
+                return ERR_WORKQUEUE_OK;
+            }
+            // only a cycle has no root
+            if(_roots == 0) {
+                m_bRunning = false;
+                return ERR_WORKQUEUE_ADD;
+            }
+
+            m_pQueue = &queue;
+            m_uiErrors = 0;
+            m_uiRemaining = m_vNodes.size();
+
+            for(size_t i = 0; i < m_vNodes.size(); i++) {
+                work_graph_node* _node = m_vNodes[i];
+                if(_node->m_uiNumPreds != 0) continue;
+
+                // the queue is full, run the node self
+                if(queue.queue(_node, timeout) != ERR_WORKQUEUE_OK)
+                    _node->on_work();
+            }
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  wait
+        //-----------------------------------
+        int basic_work_graph::wait(unsigned int timeout) {
+            if(!is_running())
+                return ERR_WORKQUEUE_OK;
+
+            if(m_semDone.lock(timeout) != ERR_SPINLOCK_OK)
+                return ERR_WORKQUEUE_BUSY;
+
+            // the graph can run again, after the end is waited
+            m_bRunning = false;
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  run
+        //-----------------------------------
+        int basic_work_graph::run(basic_work_queue& queue, unsigned int timeout) {
+            int ret = start(queue, timeout);
+            if(ret != ERR_WORKQUEUE_OK) return ret;
+
+            return wait(timeout);
+        }
+
+        //-----------------------------------
+        //  schedule
+        //-----------------------------------
+        bool basic_work_graph::schedule(work_graph_node* node) {
+            // called from a worker, a worker waits never on a full queue
+            return m_pQueue->queue(node, 0) == ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  finished
+        //-----------------------------------
+        void basic_work_graph::finished() {
+            if(--m_uiRemaining == 0)
+                m_semDone.unlock();
+        }
+    }
+}
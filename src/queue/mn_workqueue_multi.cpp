@@ -16,6 +16,7 @@
 *<https://www.gnu.org/licenses/>.  
 */
 #include "mn_config.hpp"
+#include "mn_micros.hpp"
 #include "queue/mn_workqueue_multi.hpp"
 
 namespace mn {
@@ -24,25 +25,36 @@ namespace mn {
         //  constructor
         //-----------------------------------
         basic_work_queue_multi::basic_work_queue_multi( basic_task::priority uiPriority,
-                        uint16_t usStackDepth, uint8_t uiMaxWorkItems, uint8_t uiMaxWorkers) 
+                        uint16_t usStackDepth, uint8_t uiMaxWorkItems, uint8_t uiMaxWorkers,
+                        uint8_t uiMinWorkers) 
 
-            : basic_work_queue(uiPriority, usStackDepth, uiMaxWorkItems) {
+            : basic_work_queue(uiPriority, usStackDepth, uiMaxWorkItems),
+              m_uiWorkers(0), m_uiGrows(0), m_uiRetires(0), m_iCore(-1), m_iNextName(0) {
 
             m_uiMaxWorkers = uiMaxWorkers;
+            m_uiMinWorkers = (uiMinWorkers == 0) ? 1 : uiMinWorkers;
 
-            char name[32];
+            if(m_uiMinWorkers > m_uiMaxWorkers) 
+                m_uiMinWorkers = m_uiMaxWorkers;
 
-            for (int i = 0; i < m_uiMaxWorkers; i++) {
-                sprintf(name, "work_multi_%d", i);
+            set_grow_threshold(MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_DEPTH, 
+                               MN_THREAD_CONFIG_WORKQUEUE_MULTI_GROW_WAIT);
+            set_idle_time(MN_THREAD_CONFIG_WORKQUEUE_MULTI_IDLE_TIME);
 
-                work_queue_task *pWorker = new work_queue_task(name,
-                                                                m_uiPriority, 
-                                                                m_usStackDepth, 
-                                                                this);
+            for (int i = 0; i < m_uiMinWorkers; i++) {
+                work_queue_task *pWorker = new_worker();
 
                 if(pWorker)
                     m_Workers.push_back(pWorker);  
             }
+            m_uiWorkers = m_Workers.size();
+        }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_multi::~basic_work_queue_multi() {
+            destroy();
         }
 
         //-----------------------------------
@@ -50,6 +62,7 @@ namespace mn {
         //-----------------------------------
         int basic_work_queue_multi::create_engine(int iCore) {
             automutx_t lock(m_ThreadStatus);
+            automutx_t lockWorkers(m_WorkersLock);
 
             bool _errorOnCreate = false;
             bool _oneNoError = false;
@@ -59,6 +72,7 @@ namespace mn {
             }
 
             m_bRunning = true;
+            m_iCore = iCore;
 
             for(int i = 0; i < get_num_worker(); i++) {
                 if(m_Workers[i]->start(iCore) != ERR_TASK_OK) {
@@ -76,25 +90,193 @@ namespace mn {
                 return ERR_WORKQUEUE_CANTCREATE;
             }
             
-            return ( m_uiMaxWorkers == get_num_worker() ) ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_WARNING;
+            return ( m_uiMinWorkers == get_num_worker() ) ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_WARNING;
         }
 
         //-----------------------------------
         //  destroy_engine
         //-----------------------------------
         void basic_work_queue_multi::destroy_engine() {
-            for(int i = 0; i < get_num_worker(); i++) {
-                m_Workers[i]->kill();
+            // the workers take the lock never with waiting, 
+            // so the join waits not on a worker that waits on this lock
+            automutx_t lock(m_WorkersLock);
+
+            // the running flag is false, wake all waiting workers - 
+            // a worker ends after the current item
+            for(size_t i = 0; i < m_Workers.size(); i++) 
+                wake_for_timer();
+
+            for(size_t i = 0; i < m_Workers.size(); i++) {
+                if(m_Workers[i]->is_started()) m_Workers[i]->join();
+                delete m_Workers[i];
             }
             m_Workers.clear();
+            m_uiWorkers = 0;
+
+            reap();
+
+            // release the not run items, the NULL wake ups are skipped
+            work_queue_item_t* _item = NULL;
+
+            while(m_pWorkItemQueue && m_pWorkItemQueue->dequeue(&_item, 0) == ERR_QUEUE_OK) 
+                release_batch(_item);
+        }
+
+        //-----------------------------------
+        //  queue
+        //-----------------------------------
+        int basic_work_queue_multi::queue(work_queue_item_t *work, unsigned int timeout) {
+            if(m_uiMinWorkers == m_uiMaxWorkers) 
+                return basic_work_queue::queue(work, timeout);
+
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS != MN_THREAD_CONFIG_YES
+            // with the stats the base stamps the queued time
+            set_queued_time(work, micros());
+#endif
+            int ret = basic_work_queue::queue(work, timeout);
+
+            if(ret == ERR_WORKQUEUE_OK && m_pWorkItemQueue->get_num_items() >= m_uiGrowDepth) 
+                grow();
             
+            return ret;
+        }
+
+        //-----------------------------------
+        //  queue_bulk
+        //-----------------------------------
+        int basic_work_queue_multi::queue_bulk(work_queue_item_t **items, uint32_t n,
+                                            unsigned int timeout, uint32_t* queued) {
+            if(m_uiMinWorkers == m_uiMaxWorkers) 
+                return basic_work_queue::queue_bulk(items, n, timeout, queued);
+
+#if MN_THREAD_CONFIG_WORKQUEUE_STATS != MN_THREAD_CONFIG_YES
+            unsigned long _now = micros();
+            for(uint32_t i = 0; i < n; i++) 
+                set_queued_time(items[i], _now);
+#endif
+
+            int ret = basic_work_queue::queue_bulk(items, n, timeout, queued);
+
+            if(m_pWorkItemQueue->get_num_items() >= m_uiGrowDepth) 
+                grow();
+
+            return ret;
+        }
+
+        //-----------------------------------
+        //  run_item
+        //-----------------------------------
+        void basic_work_queue_multi::run_item(work_queue_item* item) {
+            // the wait time, befor the item can be deleted in the run
+            if(m_uiMinWorkers != m_uiMaxWorkers && m_uiWorkers.load() < m_uiMaxWorkers) {
+                if( (uint32_t)(micros() - item->get_queued_time()) >= m_uiGrowWait ) 
+                    grow();
+            }
+            basic_work_queue::run_item(item);
+        }
+
+        //-----------------------------------
+        //  retire_worker
+        //-----------------------------------
+        bool basic_work_queue_multi::retire_worker(work_queue_task* worker, TickType_t idle) {
+            if(idle < m_uiIdleTime || m_uiWorkers.load() <= m_uiMinWorkers) 
+                return false;
+
+            // try again on the next timeout, when a other worker holds the lock
+            if(m_WorkersLock.lock(0) != ERR_MUTEX_OK) 
+                return false;
+
+            bool _retire = false;
+
+            if(m_bRunning && m_Workers.size() > m_uiMinWorkers) {
+                for(size_t i = 0; i < m_Workers.size(); i++) {
+                    if(m_Workers[i] != worker) continue;
+
+                    // the worker ends self, the next grow or destroy deletes it
+                    m_Workers.erase(m_Workers.begin() + i);
+                    m_vRetired.push_back(worker);
+
+                    m_uiWorkers--;
+                    m_uiRetires++;
+                    _retire = true;
+                    break;
+                }
+            }
+            m_WorkersLock.unlock();
+
+            return _retire;
+        }
+
+        //-----------------------------------
+        //  grow
+        //-----------------------------------
+        void basic_work_queue_multi::grow() {
+            if(m_uiWorkers.load() >= m_uiMaxWorkers) return;
+
+            // a other task starts a worker now
+            if(m_WorkersLock.lock(0) != ERR_MUTEX_OK) return;
+
+            reap();
+
+            if(m_bRunning && m_Workers.size() < m_uiMaxWorkers) {
+                work_queue_task *pWorker = new_worker();
+
+                if(pWorker) {
+                    if(pWorker->start(m_iCore) == ERR_TASK_OK) {
+                        m_Workers.push_back(pWorker);
+                        m_uiWorkers++;
+                        m_uiGrows++;
+                    } else {
+                        delete pWorker;
+                    }
+                }
+            }
+            m_WorkersLock.unlock();
+        }
+
+        //-----------------------------------
+        //  reap
+        //-----------------------------------
+        void basic_work_queue_multi::reap() {
+            for(size_t i = 0; i < m_vRetired.size(); i++) {
+                // the worker has left on_task, wait for the end of the task
+                m_vRetired[i]->join();
+                delete m_vRetired[i];
+            }
+            m_vRetired.clear();
+        }
+
+        //-----------------------------------
+        //  new_worker
+        //-----------------------------------
+        work_queue_task* basic_work_queue_multi::new_worker() {
+            char name[32];
+            sprintf(name, "work_multi_%d", m_iNextName++);
+
+            return new work_queue_task(name, m_uiPriority, m_usStackDepth, this);
+        }
+
+        //-----------------------------------
+        //  set_grow_threshold
+        //-----------------------------------
+        void basic_work_queue_multi::set_grow_threshold(uint8_t uiDepth, uint32_t uiWaitMs) {
+            m_uiGrowDepth = (uiDepth == 0) ? 1 : uiDepth;
+            m_uiGrowWait = uiWaitMs * 1000;
+        }
+
+        //-----------------------------------
+        //  set_idle_time
+        //-----------------------------------
+        void basic_work_queue_multi::set_idle_time(uint32_t uiIdleMs) {
+            // portTICK_PERIOD_MS is 0 for tick rates over 1000 Hz
+            m_uiIdleTime = (TickType_t)(((uint64_t)uiIdleMs * configTICK_RATE_HZ) / 1000);
         }
 
         //-----------------------------------
         //  get_num_worker
         //-----------------------------------
         uint8_t basic_work_queue_multi::get_num_worker() const  {
-        return m_Workers.size();
+            return m_uiWorkers.load();
         }
 
         //-----------------------------------
@@ -104,6 +286,27 @@ namespace mn {
             return m_uiMaxWorkers;
         }
 
+        //-----------------------------------
+        //  get_num_min_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_multi::get_num_min_worker() const   {
+            return m_uiMinWorkers;
+        }
+
+        //-----------------------------------
+        //  get_num_grows
+        //-----------------------------------
+        uint32_t basic_work_queue_multi::get_num_grows() {
+            return m_uiGrows.load();
+        }
+
+        //-----------------------------------
+        //  get_num_retires
+        //-----------------------------------
+        uint32_t basic_work_queue_multi::get_num_retires() {
+            return m_uiRetires.load();
+        }
+
         //-----------------------------------
         //  workers
         //-----------------------------------
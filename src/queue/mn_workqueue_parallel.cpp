@@ -0,0 +1,119 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "queue/mn_workqueue_parallel.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  helper::on_work
+        //-----------------------------------
+        bool basic_parallel_job::helper::on_work() {
+            // the last task wakes the caller, do not touch the job after it
+            if(m_pJob->participate(m_uiSlot))
+                m_pJob->m_semDone.unlock();
+            return true;
+        }
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_parallel_job::basic_parallel_job(basic_work_queue& queue, uint32_t uiSize,
+                                               uint32_t uiGrain, uint8_t uiTasks)
+            : m_queue(queue), m_uiSize(uiSize), m_uiGrain(uiGrain == 0 ? 1 : uiGrain),
+              m_uiTasks(uiTasks), m_uiNext(0), m_uiActive(0) {
+
+            if(m_uiTasks == 0) m_uiTasks = 1;
+            if(m_uiTasks > MN_THREAD_CONFIG_PARALLEL_MAX_TASKS)
+                m_uiTasks = MN_THREAD_CONFIG_PARALLEL_MAX_TASKS;
+        }
+
+        //-----------------------------------
+        //  run
+        //-----------------------------------
+        void basic_parallel_job::run() {
+            // no more helpers as chunks
+            uint32_t _chunks = (m_uiSize + m_uiGrain - 1) / m_uiGrain;
+            uint32_t _helpers = m_uiTasks - 1;
+            if(_chunks == 0) return;
+            if(_helpers > _chunks - 1) _helpers = _chunks - 1;
+
+            m_uiNext = 0;
+            m_uiActive = _helpers + 1;
+
+            // the semaphore is given from the constructor
+            m_semDone.lock(0);
+
+            uint32_t _queued = 0;
+            for(; _queued < _helpers; _queued++) {
+                m_helpers[_queued].m_pJob = this;
+                m_helpers[_queued].m_uiSlot = (uint8_t)(_queued + 1);
+
+                // a full queue: the caller and the queued helpers run all chunks
+                if(m_queue.queue(&m_helpers[_queued], 0) != ERR_WORKQUEUE_OK) break;
+            }
+            if(_queued < _helpers) 
+                m_uiActive -= (_helpers - _queued);
+
+            // the caller was the last task, all helpers are finished
+            if(participate(0)) return;
+
+            // help the work queue, the helpers can wait behind other items
+            while(m_semDone.lock(0) != ERR_SPINLOCK_OK) {
+                if(!m_queue.try_run_one()) {
+                    m_semDone.lock(portMAX_DELAY);
+                    break;
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  next_chunk
+        //-----------------------------------
+        bool basic_parallel_job::next_chunk(uint32_t& uiFirst, uint32_t& uiLast) {
+            uint32_t _next = m_uiNext.load();
+
+            while(_next < m_uiSize) {
+                uint32_t _remaining = m_uiSize - _next;
+                uint32_t _chunk = _remaining / (2 * m_uiTasks);
+
+                if(_chunk < m_uiGrain) _chunk = m_uiGrain;
+                if(_chunk > _remaining) _chunk = _remaining;
+
+                uint32_t _end = _next + _chunk;
+                if(m_uiNext.compare_exchange_weak(_next, _end)) {
+                    uiFirst = _next; uiLast = _end;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //-----------------------------------
+        //  participate
+        //-----------------------------------
+        bool basic_parallel_job::participate(uint8_t uiSlot) {
+            uint32_t _first, _last;
+
+            while(next_chunk(_first, _last))
+                on_range(_first, _last, uiSlot);
+
+            return (--m_uiActive == 0);
+        }
+    }
+}
@@ -0,0 +1,310 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include "mn_config.hpp"
+#include "mn_micros.hpp"
+#include "queue/mn_workqueue_prio.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  band_stats::reset
+        //-----------------------------------
+        void basic_work_queue_prio::band_stats::reset() {
+            queued = 0; worked = 0; aged = 0;
+            max_wait = 0; max_latency = 0;
+            sum_wait = 0; sum_latency = 0;
+        }
+
+        //-----------------------------------
+        //  update_max
+        //-----------------------------------
+        static void update_max(atomic_uint32_t& max, uint32_t value) {
+            uint32_t _old = max.load(memory_order::Relaxed);
+
+            while(value > _old) {
+                if(max.compare_exchange_weak(_old, value, memory_order::Relaxed)) break;
+            }
+        }
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_queue_prio::basic_work_queue_prio( basic_task::priority uiPriority,
+                        uint16_t usStackDepth, uint8_t uiMaxWorkItems, uint8_t uiBands,
+                        uint8_t uiMaxWorkers, uint32_t uiAgingTime)
+
+            : basic_work_queue(uiPriority, usStackDepth, 0),
+              m_pStats(NULL),
+              // one count for each item and the room for the wake ups of the workers
+              m_semItems(0, (uiBands == 0 ? 1 : uiBands) * uiMaxWorkItems + uiMaxWorkers + 1),
+              m_uiBands(uiBands == 0 ? 1 : uiBands),
+              m_uiMaxWorkers(uiMaxWorkers),
+              m_uiMaxBandItems(uiMaxWorkItems),
+              m_uiAgingTime(uiAgingTime) {
+
+            m_pStats = new band_stats[m_uiBands];
+
+            for(int i = 0; i < m_uiBands; i++) {
+                queue_t* _band = new queue_t(m_uiMaxBandItems, sizeof(band_entry));
+                _band->create();
+
+                m_vBands.push_back(_band);
+            }
+
+            char name[32];
+
+            for (int i = 0; i < m_uiMaxWorkers; i++) {
+                sprintf(name, "work_prio_%d", i);
+
+                work_queue_task *pWorker = new work_queue_task(name,
+                                                                m_uiPriority,
+                                                                m_usStackDepth,
+                                                                this);
+                if(pWorker)
+                    m_Workers.push_back(pWorker);
+            }
+        }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_prio::~basic_work_queue_prio() {
+            destroy();
+
+            for(size_t i = 0; i < m_vBands.size(); i++) {
+                m_vBands[i]->destroy();
+                delete m_vBands[i];
+            }
+            m_vBands.clear();
+
+            delete[] m_pStats; m_pStats = NULL;
+        }
+
+        //-----------------------------------
+        //  create_engine
+        //-----------------------------------
+        int basic_work_queue_prio::create_engine(int iCore) {
+            automutx_t lock(m_ThreadStatus);
+
+            bool _errorOnCreate = false;
+            bool _oneNoError = false;
+
+            if(m_bRunning) {
+                return ERR_WORKQUEUE_ALREADYINIT;
+            }
+
+            m_bRunning = true;
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->start(iCore) != ERR_TASK_OK) {
+                    _errorOnCreate = true;
+                } else {
+                    _oneNoError = true;
+                }
+            }
+            if( !_oneNoError ) {
+                return ERR_WORKQUEUE_CANTCREATE;
+            }
+            return ( !_errorOnCreate && m_uiMaxWorkers == get_num_worker() ) ?
+                ERR_WORKQUEUE_OK : ERR_WORKQUEUE_WARNING;
+        }
+
+        //-----------------------------------
+        //  destroy_engine
+        //-----------------------------------
+        void basic_work_queue_prio::destroy_engine() {
+            // the running flag is false, wake all waiting workers - 
+            // a worker ends after the current item
+            for(int i = 0; i < get_num_worker(); i++) 
+                m_semItems.unlock();
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->is_started()) m_Workers[i]->join();
+            }
+            // release the not run items of all bands
+            band_entry _entry;
+
+            for(size_t i = 0; i < m_vBands.size(); i++) {
+                while(m_vBands[i]->dequeue(&_entry, 0) == ERR_QUEUE_OK) 
+                    release_batch(_entry.item);
+            }
+            for(int i = 0; i < get_num_worker(); i++) {
+                delete m_Workers[i];
+            }
+            m_Workers.clear();
+        }
+
+        //-----------------------------------
+        //  queue
+        //-----------------------------------
+        int basic_work_queue_prio::queue(work_queue_item_t *work, unsigned int timeout) {
+            uint8_t _band = get_band(work);
+            band_entry _entry = { work, micros() };
+
+            set_queued_time(work, _entry.queued);
+            m_uiPending++;
+
+            if(m_vBands[_band]->enqueue(&_entry, timeout) != ERR_QUEUE_OK) {
+                m_uiPending--;
+                return ERR_WORKQUEUE_ADD;
+            }
+            m_pStats[_band].queued++;
+
+            // one count for each item, a worker with a count finds a item
+            m_semItems.unlock();
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  queue_bulk
+        //-----------------------------------
+        int basic_work_queue_prio::queue_bulk(work_queue_item_t **items, uint32_t n,
+                                            unsigned int timeout, uint32_t* queued) {
+            uint32_t i = 0;
+            int ret = ERR_WORKQUEUE_OK;
+
+            for(; i < n; i++) {
+                ret = queue(items[i], timeout);
+                if(ret != ERR_WORKQUEUE_OK) break;
+            }
+            if(queued) *queued = i;
+
+            return ret;
+        }
+
+        //-----------------------------------
+        //  get_next_item
+        //-----------------------------------
+        work_queue_item* basic_work_queue_prio::get_next_item(unsigned int timeout) {
+            if(m_semItems.lock(timeout) != ERR_SPINLOCK_OK)
+                return NULL;
+
+            band_entry _entry;
+
+            uint32_t _aging = m_uiAgingTime;
+
+            // aging: the oldest item of the lower bands, that waits longer as the
+            // aging time, runs first. peek copies only the entry, not the item
+            if(_aging != 0) {
+                unsigned long _now = micros();
+                int _aged = -1;
+                unsigned long _agedWait = 0;
+
+                for(int i = 0; i < m_uiBands - 1; i++) {
+                    if(m_vBands[i]->peek(&_entry, 0) != ERR_QUEUE_OK) continue;
+
+                    unsigned long _wait = _now - _entry.queued;
+
+                    if(_wait >= _aging * 1000UL && _wait > _agedWait) {
+                        _aged = i; _agedWait = _wait;
+                    }
+                }
+                if(_aged != -1 && m_vBands[_aged]->dequeue(&_entry, 0) == ERR_QUEUE_OK) {
+                    m_pStats[_aged].aged++;
+                    return _entry.item;
+                }
+            }
+
+            for(int i = m_uiBands - 1; i >= 0; i--) {
+                if(m_vBands[i]->dequeue(&_entry, 0) == ERR_QUEUE_OK)
+                    return _entry.item;
+            }
+            // a count from wake_for_timer or the item was taken with a other count,
+            // each item is queued befor the count is given - no item is lost
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  wake_for_timer
+        //-----------------------------------
+        void basic_work_queue_prio::wake_for_timer() {
+            // a count without item, the worker looks again for the timers.
+            // only when no count is pending, else a worker wakes up anyway -
+            // so the stray counts can not fill the semaphore and a queue() 
+            // can always give the count for its item
+            if(m_semItems.get_count() == 0) 
+                m_semItems.unlock();
+        }
+
+        //-----------------------------------
+        //  run_item
+        //-----------------------------------
+        void basic_work_queue_prio::run_item(work_queue_item* item) {
+            band_stats& _stats = m_pStats[get_band(item)];
+            unsigned long _queued = item->get_queued_time();
+            uint32_t _wait = (uint32_t)(micros() - _queued);
+
+            // the item can be deleted after the run
+            basic_work_queue::run_item(item);
+
+            uint32_t _latency = (uint32_t)(micros() - _queued);
+
+            _stats.worked++;
+            _stats.sum_wait += _wait;
+            _stats.sum_latency += _latency;
+            update_max(_stats.max_wait, _wait);
+            update_max(_stats.max_latency, _latency);
+        }
+
+        //-----------------------------------
+        //  get_band_stats
+        //-----------------------------------
+        bool basic_work_queue_prio::get_band_stats(uint8_t uiBand, work_queue_band_stats& stats) {
+            if(uiBand >= m_uiBands) return false;
+
+            band_stats& _stats = m_pStats[uiBand];
+            uint32_t _worked = _stats.worked.load();
+
+            stats.queued = _stats.queued.load();
+            stats.worked = _worked;
+            stats.aged = _stats.aged.load();
+            stats.max_wait_us = _stats.max_wait.load();
+            stats.max_latency_us = _stats.max_latency.load();
+            stats.avg_wait_us = (_worked == 0) ? 0 : (uint32_t)(_stats.sum_wait.load() / _worked);
+            stats.avg_latency_us = (_worked == 0) ? 0 : (uint32_t)(_stats.sum_latency.load() / _worked);
+
+            return true;
+        }
+
+        //-----------------------------------
+        //  reset_stats
+        //-----------------------------------
+        void basic_work_queue_prio::reset_stats() {
+            for(int i = 0; i < m_uiBands; i++)
+                m_pStats[i].reset();
+
+            basic_work_queue::reset_stats();
+        }
+
+        //-----------------------------------
+        //  get_num_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_prio::get_num_worker() const  {
+            return m_Workers.size();
+        }
+
+        //-----------------------------------
+        //  get_num_max_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_prio::get_num_max_worker() const   {
+            return m_uiMaxWorkers;
+        }
+    }
+}
@@ -31,6 +31,17 @@ namespace mn {
             m_pWorker = new work_queue_task("single_workqueue_thread", uiPriority, usStackDepth, this);
         }
 
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_single::~basic_work_queue_single() {
+            destroy();
+
+            if(m_pWorker) {
+                delete m_pWorker; m_pWorker = NULL;
+            }
+        }
+
         //-----------------------------------
         //  create_engine
         //-----------------------------------
@@ -50,7 +61,17 @@ namespace mn {
         //  destroy_engine
         //-----------------------------------
         void basic_work_queue_single::destroy_engine() {
-            m_pWorker->kill();
+            // the running flag is false, wake the waiting worker - 
+            // the worker ends after the current item
+            wake_for_timer();
+
+            if(m_pWorker->is_started()) m_pWorker->join();
+
+            // release the not run items, the NULL wake up is skipped
+            work_queue_item_t* _item = NULL;
+
+            while(m_pWorkItemQueue && m_pWorkItemQueue->dequeue(&_item, 0) == ERR_QUEUE_OK) 
+                release_batch(_item);
         }
     }
 }
@@ -0,0 +1,378 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include "mn_config.hpp"
+#include "queue/mn_workqueue_steal.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  work_steal_task::constructor
+        //-----------------------------------
+        work_steal_task::work_steal_task(char const* strName,
+                                        basic_task::priority uiPriority,
+                                        unsigned short  usStackDepth,
+                                        basic_work_queue_steal* parent, uint8_t uiIndex)
+
+            : basic_task(strName, uiPriority, usStackDepth), m_parentWorkQueue(parent),
+              m_deque(), m_bParked(false), m_uiRandom(0x9e3779b9u * (uiIndex + 1)),
+              m_uiIndex(uiIndex), m_bStarted(false) { }
+
+        //-----------------------------------
+        //  work_steal_task::deconstructor
+        //-----------------------------------
+        work_steal_task::~work_steal_task() { }
+
+        //-----------------------------------
+        //  work_steal_task::next_random
+        //-----------------------------------
+        uint32_t work_steal_task::next_random() {
+            m_uiRandom ^= m_uiRandom << 13;
+            m_uiRandom ^= m_uiRandom >> 17;
+            m_uiRandom ^= m_uiRandom << 5;
+
+            return m_uiRandom;
+        }
+
+        //-----------------------------------
+        //  work_steal_task::on_task
+        //-----------------------------------
+        void* work_steal_task::on_task() {
+            basic_task::on_task();
+
+            work_queue_item_t *work_item = NULL;
+
+            while ( m_parentWorkQueue->running() ) {
+                // queue the due delayed items
+                m_parentWorkQueue->service_timers(0);
+
+                work_item = m_parentWorkQueue->find_work(this);
+
+                if(work_item == NULL) {
+                    // publish the parked flag first and then look again, a
+                    // producer queue the item first and then look for parked workers
+                    m_bParked.store(true);
+                    m_parentWorkQueue->m_uiParked++;
+                    atomic_thread_fence(memory_order::SeqCst);
+
+                    work_item = m_parentWorkQueue->find_work(this);
+
+                    if(work_item == NULL) {
+                        // a wake up is lost never, the timeout is for the running flag
+                        // and the next due delayed item
+                        ulTaskNotifyTake(pdTRUE, m_parentWorkQueue->service_timers(
+                            MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT));
+                    }
+                    // when the flag was cleared from wake_one, the counter is also changed
+                    if(m_bParked.exchange(false))
+                        m_parentWorkQueue->m_uiParked--;
+
+                    if(work_item == NULL) continue;
+                }
+                m_parentWorkQueue->run_batch(work_item);
+            }
+            return 0;
+        }
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_queue_steal::basic_work_queue_steal( basic_task::priority uiPriority,
+                        uint16_t usStackDepth, uint8_t uiMaxWorkItems, uint8_t uiMaxWorkers)
+
+            : basic_work_queue(uiPriority, usStackDepth, uiMaxWorkItems),
+              m_uiMaxWorkers(uiMaxWorkers), m_uiParked(0), m_uiSteals(0) {
+
+            char name[32];
+
+            for (int i = 0; i < m_uiMaxWorkers; i++) {
+                sprintf(name, "work_steal_%d", i);
+
+                work_steal_task *pWorker = new work_steal_task(name,
+                                                                m_uiPriority,
+                                                                m_usStackDepth,
+                                                                this, (uint8_t)i);
+
+                if(pWorker)
+                    m_Workers.push_back(pWorker);
+            }
+        }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_steal::~basic_work_queue_steal() {
+            destroy();
+        }
+
+        //-----------------------------------
+        //  create_engine
+        //-----------------------------------
+        int basic_work_queue_steal::create_engine(int iCore) {
+            automutx_t lock(m_ThreadStatus);
+
+            bool _errorOnCreate = false;
+            bool _oneNoError = false;
+
+            if(m_bRunning) {
+                return ERR_WORKQUEUE_ALREADYINIT;
+            }
+
+            m_bRunning = true;
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->start(iCore) != ERR_TASK_OK) {
+                    _errorOnCreate = true;
+                } else {
+                    m_Workers[i]->m_bStarted = true;
+                    _oneNoError = true;
+                }
+            }
+            if( (_errorOnCreate && _oneNoError) ||
+                (_oneNoError && get_num_worker() == 1) ) {
+                return ERR_WORKQUEUE_WARNING;
+            }
+            else if( !_oneNoError ) {
+                return ERR_WORKQUEUE_CANTCREATE;
+            }
+
+            return ( m_uiMaxWorkers == get_num_worker() ) ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_WARNING;
+        }
+
+        //-----------------------------------
+        //  destroy_engine
+        //-----------------------------------
+        void basic_work_queue_steal::destroy_engine() {
+            // the running flag is false, wake all parked workers - 
+            // a worker ends after the current item
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->get_handle())
+                    xTaskNotifyGive(m_Workers[i]->get_handle());
+            }
+            // wait for all workers first, a running worker can steal from all deques
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->m_bStarted) m_Workers[i]->join();
+            }
+            // release the not run items of the deques and the shared queue
+            work_queue_item_t* _item = NULL;
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                while( (_item = m_Workers[i]->m_deque.pop()) != NULL ) 
+                    release_batch(_item);
+            }
+            while(m_pWorkItemQueue && m_pWorkItemQueue->dequeue(&_item, 0) == ERR_QUEUE_OK) 
+                release_batch(_item);
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                delete m_Workers[i];
+            }
+            m_Workers.clear();
+        }
+
+        //-----------------------------------
+        //  queue
+        //-----------------------------------
+        int basic_work_queue_steal::queue(work_queue_item_t *work, unsigned int timeout) {
+            work_steal_task* _worker = get_current_worker();
+
+            if(_worker != NULL) {
+                m_uiPending++;
+                stamp_queued(work);
+                push_or_run(_worker, work);
+                wake_one();
+
+                return ERR_WORKQUEUE_OK;
+            }
+
+            int ret = basic_work_queue::queue(work, timeout);
+            if(ret == ERR_WORKQUEUE_OK) wake_one();
+
+            return ret;
+        }
+
+        //-----------------------------------
+        //  queue_bulk
+        //-----------------------------------
+        int basic_work_queue_steal::queue_bulk(work_queue_item_t **items, uint32_t n,
+                                            unsigned int timeout, uint32_t* queued) {
+            work_steal_task* _worker = get_current_worker();
+
+            if(_worker != NULL) {
+                m_uiPending += n;
+                for(uint32_t i = 0; i < n; i++) {
+                    stamp_queued(items[i]);
+                    push_or_run(_worker, items[i]);
+                }
+                wake_one();
+
+                if(queued) *queued = n;
+                return ERR_WORKQUEUE_OK;
+            }
+
+            int ret = basic_work_queue::queue_bulk(items, n, timeout, queued);
+            wake_one();
+
+            return ret;
+        }
+
+        //-----------------------------------
+        //  push_or_run
+        //-----------------------------------
+        void basic_work_queue_steal::push_or_run(work_steal_task* worker, work_queue_item_t *work) {
+            if(worker->m_deque.push(work)) return;
+
+            // the deque is full, a worker waits never on the full shared queue - 
+            // all workers can wait there, so run the item self
+            if(m_pWorkItemQueue->enqueue(&work, 0) != ERR_QUEUE_OK)
+                run_item(work);
+        }
+
+        //-----------------------------------
+        //  try_run_one
+        //-----------------------------------
+        bool basic_work_queue_steal::try_run_one() {
+            work_steal_task* _worker = get_current_worker();
+            if(_worker == NULL) return false;
+
+            work_queue_item_t* _item = find_work(_worker);
+            if(_item == NULL) return false;
+
+            run_batch(_item);
+            return true;
+        }
+
+        //-----------------------------------
+        //  wake_for_timer
+        //-----------------------------------
+        void basic_work_queue_steal::wake_for_timer() {
+            // the woken worker services the timers befor it parks again
+            wake_one();
+        }
+
+        //-----------------------------------
+        //  queue_due
+        //-----------------------------------
+        int basic_work_queue_steal::queue_due(work_queue_item_t *work) {
+            int ret = basic_work_queue::queue(work, 0);
+            if(ret == ERR_WORKQUEUE_OK) wake_one();
+
+            return ret;
+        }
+
+        //-----------------------------------
+        //  get_current_worker
+        //-----------------------------------
+        work_steal_task* basic_work_queue_steal::get_current_worker() {
+            // compare the handles, a worker is found without get_self, too
+            for(size_t i = 0; i < m_Workers.size(); i++) {
+                if(basic_task::is_current(m_Workers[i])) return m_Workers[i];
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  find_work
+        //-----------------------------------
+        work_queue_item_t* basic_work_queue_steal::find_work(work_steal_task* worker) {
+            work_queue_item_t* _item = worker->m_deque.pop();
+            if(_item != NULL) return _item;
+
+            if(m_pWorkItemQueue->dequeue(&_item, 0) == ERR_QUEUE_OK) {
+                // push the rest of a batch to the own deque, for the stealers
+                work_queue_item_t* _next = unlink_next(_item);
+                bool _pushed = false;
+
+                while(_next != NULL) {
+                    work_queue_item_t* _after = unlink_next(_next);
+
+                    if(!worker->m_deque.push(_next)) {
+                        link_next(_next, _after);
+                        break;
+                    }
+                    _pushed = true;
+                    _next = _after;
+                }
+                link_next(_item, _next);
+
+                // a other worker can steal the batch now
+                if(_pushed) wake_one();
+
+                return _item;
+            }
+
+            size_t _count = m_Workers.size();
+            if(_count < 2) return NULL;
+
+            // start by a random victim and try all other workers once
+            size_t _start = worker->next_random() % _count;
+
+            for(size_t i = 0; i < _count; i++) {
+                work_steal_task* _victim = m_Workers[(_start + i) % _count];
+                if(_victim == worker) continue;
+
+                _item = _victim->m_deque.steal();
+                if(_item != NULL) {
+                    m_uiSteals++;
+                    return _item;
+                }
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  wake_one
+        //-----------------------------------
+        void basic_work_queue_steal::wake_one() {
+            atomic_thread_fence(memory_order::SeqCst);
+
+            if(m_uiParked.load() == 0) return;
+
+            for(size_t i = 0; i < m_Workers.size(); i++) {
+                bool _expected = true;
+                bool _desired = false;
+
+                if(m_Workers[i]->m_bParked.compare_exchange_strong(_expected, _desired)) {
+                    m_uiParked--;
+                    xTaskNotifyGive(m_Workers[i]->get_handle());
+                    return;
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  get_num_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_steal::get_num_worker() const  {
+            return m_Workers.size();
+        }
+
+        //-----------------------------------
+        //  get_num_max_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_steal::get_num_max_worker() const   {
+            return m_uiMaxWorkers;
+        }
+
+        //-----------------------------------
+        //  get_num_steals
+        //-----------------------------------
+        uint32_t basic_work_queue_steal::get_num_steals() {
+            return m_uiSteals.load();
+        }
+    }
+}
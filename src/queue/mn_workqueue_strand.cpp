@@ -0,0 +1,143 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_config.hpp"
+#include "queue/mn_workqueue_strand.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_strand::basic_work_strand(basic_work_queue& queue, uint8_t uiBatch)
+            : work_queue_item_t(false), m_pQueue(&queue), m_pPosted(NULL), m_pReady(NULL),
+              m_uiCount(0), m_uiNumWorks(0), m_uiErrorsNumWorks(0), 
+              m_uiBatch(uiBatch == 0 ? 1 : uiBatch) { }
+
+        //-----------------------------------
+        //  post
+        //-----------------------------------
+        int basic_work_strand::post(work_queue_item_t* work, unsigned int timeout) {
+            if(work == NULL) return ERR_WORKQUEUE_ADD;
+
+            work_queue_item_t* _head = m_pPosted.load(memory_order::Relaxed);
+            do {
+                work->m_pNextBatch = _head;
+            } while(!m_pPosted.compare_exchange_weak(_head, work, memory_order::Release));
+
+            // count after the push, a running strand finds each counted item.
+            // only the first item queues the strand, the strand runs never twice
+            if(m_uiCount.fetch_add(1) == 0)
+                schedule(timeout);
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  schedule
+        //-----------------------------------
+        void basic_work_strand::schedule(unsigned int timeout) {
+            // the queue is full, run the strand self - the order is the same
+            if(m_pQueue->queue(this, timeout) != ERR_WORKQUEUE_OK)
+                on_work();
+        }
+
+        //-----------------------------------
+        //  next_item
+        //-----------------------------------
+        work_queue_item_t* basic_work_strand::next_item() {
+            if(m_pReady == NULL) {
+                work_queue_item_t* _list = m_pPosted.exchange(NULL, memory_order::Acquire);
+                work_queue_item_t* _ready = NULL;
+
+                // the last posted item is the first in the list, reverse to the post order
+                while(_list != NULL) {
+                    work_queue_item_t* _next = _list->m_pNextBatch;
+                    _list->m_pNextBatch = _ready;
+                    _ready = _list;
+                    _list = _next;
+                }
+                m_pReady = _ready;
+            }
+
+            work_queue_item_t* _item = m_pReady;
+            if(_item != NULL) {
+                m_pReady = _item->m_pNextBatch;
+                _item->m_pNextBatch = NULL;
+            }
+            return _item;
+        }
+
+        //-----------------------------------
+        //  on_work
+        //-----------------------------------
+        bool basic_work_strand::on_work() {
+            for(;;) {
+                for(uint8_t i = 0; i < m_uiBatch; i++) {
+                    // each counted item is pushed, it is on the list
+                    work_queue_item_t* _item = next_item();
+                    if(_item == NULL) return true;
+
+                    bool _delete = _item->can_delete();
+
+                    if(_item->on_work())
+                        m_uiNumWorks++;
+                    else
+                        m_uiErrorsNumWorks++;
+
+                    if(_delete && _item->can_release()) _item->release();
+
+                    // the last item: a new post queues the strand again, do not 
+                    // touch the strand after this
+                    if(--m_uiCount == 0) return true;
+                }
+                // queue again behind the other items, when the queue is full
+                // run the next batch here
+                if(m_pQueue->queue(this, 0) == ERR_WORKQUEUE_OK) return true;
+            }
+        }
+
+        //-----------------------------------
+        //  basic_work_strand_set::constructor
+        //-----------------------------------
+        basic_work_strand_set::basic_work_strand_set(basic_work_queue& queue, uint16_t uiStrands)
+            : m_pStrands(NULL), m_uiStrands(uiStrands == 0 ? 1 : uiStrands) {
+
+            m_pStrands = new basic_work_strand*[m_uiStrands];
+            for(uint16_t i = 0; i < m_uiStrands; i++)
+                m_pStrands[i] = new basic_work_strand(queue);
+        }
+
+        //-----------------------------------
+        //  basic_work_strand_set::deconstructor
+        //-----------------------------------
+        basic_work_strand_set::~basic_work_strand_set() {
+            for(uint16_t i = 0; i < m_uiStrands; i++)
+                delete m_pStrands[i];
+            delete[] m_pStrands;
+        }
+
+        //-----------------------------------
+        //  basic_work_strand_set::is_idle
+        //-----------------------------------
+        bool basic_work_strand_set::is_idle() {
+            for(uint16_t i = 0; i < m_uiStrands; i++)
+                if(!m_pStrands[i]->is_idle()) return false;
+            return true;
+        }
+    }
+}
@@ -32,7 +32,8 @@ namespace mn {
                                             unsigned short  usStackDepth, 
                                             basic_work_queue* parent)
 
-            : basic_task(strName, uiPriority, usStackDepth), m_parentWorkQueue(parent) { 
+            : basic_task(strName, uiPriority, usStackDepth), m_parentWorkQueue(parent),
+              m_bStarted(false) { 
 
         }
         //-----------------------------------
@@ -40,6 +41,16 @@ namespace mn {
         //-----------------------------------
         work_queue_task::~work_queue_task() { }
 
+        //-----------------------------------
+        //  start
+        //-----------------------------------
+        int work_queue_task::start(int uiCore) {
+            int ret = basic_task::start(uiCore);
+            if(ret == ERR_TASK_OK) m_bStarted = true;
+
+            return ret;
+        }
+
         //-----------------------------------
         //  on_task
         //-----------------------------------
@@ -47,27 +58,24 @@ namespace mn {
             basic_task::on_task();
 
             work_queue_item *work_item = NULL;
-
+            TickType_t _lastWork = xTaskGetTickCount();
 
             while ( m_parentWorkQueue->running() ) {
-                work_item = m_parentWorkQueue->get_next_item(MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT);
+                // queue the due delayed items and wait max until the next is due
+                work_item = m_parentWorkQueue->get_next_item(
+                    m_parentWorkQueue->service_timers(MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT) );
 
+                // timeout, look again is the workqueue running
                 if (work_item == NULL) { 
-                    break;
+                    // a elastic engine can end idle workers
+                    if(m_parentWorkQueue->retire_worker(this, xTaskGetTickCount() - _lastWork))
+                        break;
+                    continue;
                 }
 
-                m_parentWorkQueue->m_ThreadStatus.lock();
-
-                    if(work_item->on_work())
-                        m_parentWorkQueue->m_uiNumWorks++;
-                    else
-                        m_parentWorkQueue->m_uiErrorsNumWorks++;
-
-                m_parentWorkQueue->m_ThreadStatus.unlock();
-
-                if (work_item->can_delete()) {
-                    delete work_item; work_item = NULL;
-                }
+                // no lock, all workers run the items concurrently
+                m_parentWorkQueue->run_batch(work_item);
+                _lastWork = xTaskGetTickCount();
             }
             
             return 0;
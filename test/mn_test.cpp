@@ -0,0 +1,107 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace mn {
+    namespace test {
+        static int g_iFailed = 0;
+
+        //-----------------------------------
+        //  registrar
+        //-----------------------------------
+        std::vector<test_entry>& tests() {
+            static std::vector<test_entry> _tests;
+            return _tests;
+        }
+
+        registrar::registrar(const char* strSuite, const char* strName, test_fn fn) {
+            tests().push_back( test_entry{ strSuite, strName, fn } );
+        }
+
+        //-----------------------------------
+        //  fail
+        //-----------------------------------
+        void fail(const char* strExpr, const char* strFile, int iLine) {
+            __atomic_add_fetch(&g_iFailed, 1, __ATOMIC_RELAXED);
+            printf("  %s:%d: check failed: %s\n", strFile, iLine, strExpr);
+            fflush(stdout);
+        }
+
+        //-----------------------------------
+        //  run
+        //-----------------------------------
+        static bool run(const test_entry& entry) {
+            int _before = __atomic_load_n(&g_iFailed, __ATOMIC_RELAXED);
+
+            printf("[ RUN    ] %s.%s\n", entry.suite, entry.name);
+            fflush(stdout);
+
+            // each test has his own task, with a clean notification value
+            test_task _task("mn_test", entry.fn);
+            _task.start();
+            _task.join();
+
+            bool _ok = __atomic_load_n(&g_iFailed, __ATOMIC_RELAXED) == _before;
+            printf("[ %s ] %s.%s\n", _ok ? "    OK" : "FAILED", entry.suite, entry.name);
+            fflush(stdout);
+
+            return _ok;
+        }
+    }
+}
+
+static void usage(const char* name) {
+    printf("usage: %s [options]\n"
+           "  --filter=A,B   run only the named suites\n"
+           "  --list         list all tests\n", name);
+}
+
+int main(int argc, char** argv) {
+    std::string _filter;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if(strncmp(arg, "--filter=", 9) == 0) {
+            _filter = arg + 9;
+        } else if(strcmp(arg, "--list") == 0) {
+            for(auto& t : mn::test::tests()) printf("%s.%s\n", t.suite, t.name);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return (strcmp(arg, "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    int _run = 0, _failed = 0;
+    std::string _list = "," + _filter + ",";
+
+    for(auto& t : mn::test::tests()) {
+        if(!_filter.empty() && _list.find(std::string(",") + t.suite + ",") == std::string::npos)
+            continue;
+
+        _run++;
+        if(!mn::test::run(t)) _failed++;
+    }
+    printf("%d tests, %d failed\n", _run, _failed);
+
+    return (_failed == 0 && _run > 0) ? 0 : 1;
+}
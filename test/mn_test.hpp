@@ -0,0 +1,78 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef _MINLIB_TEST_H_
+#define _MINLIB_TEST_H_
+
+// the std headers first, mn_iterator.hpp defines a for_each macro
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "miniThread.hpp"
+
+namespace mn {
+    namespace test {
+        using test_fn = void (*)();
+
+        /**
+         * Register a test case, use MN_TEST
+         */
+        struct registrar {
+            registrar(const char* strSuite, const char* strName, test_fn fn);
+        };
+
+        struct test_entry {
+            const char* suite;
+            const char* name;
+            test_fn fn;
+        };
+
+        std::vector<test_entry>& tests();
+
+        /**
+         * Report a failed check of the current test, use MN_CHECK
+         */
+        void fail(const char* strExpr, const char* strFile, int iLine);
+
+        /**
+         * A task that run a callable, the tests run in a task and start helper tasks
+         */
+        class test_task : public basic_task {
+        public:
+            test_task(const char* strName, std::function<void()> fn,
+                      basic_task::priority uiPriority = basic_task::PriorityNormal)
+                : basic_task(strName, uiPriority, 8192), m_fn(fn) { }
+
+            virtual void* on_task() override { m_fn(); return NULL; }
+        private:
+            std::function<void()> m_fn;
+        };
+    }
+}
+
+#define MN_TEST(suite, name) \
+    static void __mn_test_##suite##_##name(); \
+    static mn::test::registrar __mn_test_registrar_##suite##_##name(#suite, #name, __mn_test_##suite##_##name); \
+    static void __mn_test_##suite##_##name()
+
+/** Check the expression, the test goes on after a failed check */
+#define MN_CHECK(expr) \
+    do { if(!(expr)) mn::test::fail(#expr, __FILE__, __LINE__); } while(0)
+
+#endif
@@ -0,0 +1,41 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+
+using namespace mn;
+
+MN_TEST(atomic, post_increment_returns_old) {
+    atomic_int _value(5);
+
+    MN_CHECK(_value++ == 5);
+    MN_CHECK(_value.load() == 6);
+    MN_CHECK(_value-- == 6);
+    MN_CHECK(_value.load() == 5);
+    MN_CHECK(++_value == 6);
+    MN_CHECK(--_value == 5);
+}
+
+MN_TEST(atomic, compare_exchange) {
+    atomic_int _value(1);
+    int _expected = 2, _desired = 3;
+
+    MN_CHECK(!_value.compare_exchange_strong(_expected, _desired));
+    MN_CHECK(_expected == 1);
+    MN_CHECK(_value.compare_exchange_strong(_expected, _desired));
+    MN_CHECK(_value.load() == 3);
+}
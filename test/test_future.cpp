@@ -0,0 +1,86 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "queue/mn_workqueue_single.hpp"
+#include "mn_future.hpp"
+
+using namespace mn;
+
+namespace {
+    /**
+     * A not deleted continuation, counts the runs
+     */
+    class then_item : public queue::work_queue_item_t {
+    public:
+        then_item() : queue::work_queue_item_t(false), runs(0) { }
+
+        virtual bool on_work() override { __atomic_add_fetch(&runs, 1, __ATOMIC_RELAXED); return true; }
+
+        uint32_t runs;
+    };
+
+    uint32_t get_runs(then_item& item) { return __atomic_load_n(&item.runs, __ATOMIC_RELAXED); }
+}
+
+MN_TEST(future, second_then_is_busy) {
+    queue::basic_work_queue_single _queue;
+    basic_future_state<int> _state;
+    then_item _first, _second;
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+    MN_CHECK(_state.then(_queue, &_first) == ERR_FUTURE_OK);
+    MN_CHECK(_state.then(_queue, &_second) == ERR_FUTURE_BUSY);
+    MN_CHECK(_state.set_value(42) == ERR_FUTURE_OK);
+
+    for(int i = 0; i < 1000 && get_runs(_first) == 0; i++) vTaskDelay(1);
+
+    MN_CHECK(get_runs(_first) == 1);
+    MN_CHECK(get_runs(_second) == 0);
+}
+
+MN_TEST(future, racing_then_runs_each_accepted_item) {
+    queue::basic_work_queue_single _queue;
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+    for(int round = 0; round < 200; round++) {
+        basic_future_state<int> _state;
+        then_item _items[2];
+        int _ret[2] = { -1, -1 };
+
+        test::test_task _a("then_a", [&]() { _ret[0] = _state.then(_queue, &_items[0]); });
+        test::test_task _b("then_b", [&]() { _ret[1] = _state.then(_queue, &_items[1]); });
+
+        _a.start(); _b.start();
+        if(round & 1) _state.set_value(round);
+
+        _a.join(); _b.join();
+        if((round & 1) == 0) _state.set_value(round);
+
+        // exactly one continuation is set, unless the value was set before
+        int _accepted = (_ret[0] == ERR_FUTURE_OK) + (_ret[1] == ERR_FUTURE_OK);
+        MN_CHECK(_accepted >= 1);
+        MN_CHECK((round & 1) == 1 || _accepted == 1);
+
+        for(int i = 0; i < 1000 && get_runs(_items[0]) + get_runs(_items[1]) != (uint32_t)_accepted; i++)
+            vTaskDelay(1);
+
+        for(int i = 0; i < 2; i++)
+            MN_CHECK(get_runs(_items[i]) == (_ret[i] == ERR_FUTURE_OK ? 1u : 0u));
+    }
+}
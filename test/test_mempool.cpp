@@ -0,0 +1,82 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "memory/mn_basic_mempool_magazine.hpp"
+#include "memory/mn_basic_mempool_lockfree.hpp"
+
+using namespace mn;
+
+namespace {
+    using magazine_pool_t = memory::basic_mempool_magazine< memory::basic_mempool_slab<uint32_t, 32>, 8, 2 >;
+
+    /**
+     * Allocate and free some chunks, the freed chunks stay in the magazine
+     */
+    void use_magazine(magazine_pool_t& pool) {
+        uint32_t* _items[4];
+
+        for(int i = 0; i < 4; i++) _items[i] = pool.allocate();
+        for(int i = 0; i < 4; i++) pool.free(_items[i]);
+    }
+}
+
+MN_TEST(mempool, magazine_released_on_task_end) {
+    magazine_pool_t _pool;
+    MN_CHECK(_pool.create(portMAX_DELAY) == ERR_MEMPOOL_OK);
+
+    // more tasks as magazines, each task ends without flush
+    for(int i = 0; i < 4; i++) {
+        test::test_task _task("magazine", [&_pool]() { use_magazine(_pool); });
+
+        MN_CHECK(_task.start() == ERR_TASK_OK);
+        _task.join();
+
+        MN_CHECK(_pool.get_used() == 0);
+    }
+    memory::mempool_magazine_stats _stats = _pool.get_stats();
+
+    MN_CHECK(_stats.allocs == 16);
+    MN_CHECK(_stats.alloc_hits > 0);
+}
+
+MN_TEST(mempool, lockfree_rejects_double_free) {
+    memory::basic_mempool_lockfree<uint32_t, 4> _pool;
+    uint32_t _foreign = 0;
+
+    uint32_t* _a = _pool.allocate();
+    uint32_t* _b = _pool.allocate();
+
+    MN_CHECK(_a != NULL && _b != NULL && _a != _b);
+    MN_CHECK(_pool.get_used() == 2);
+
+    MN_CHECK(_pool.deallocate(_a));
+    MN_CHECK(!_pool.deallocate(_a));
+    MN_CHECK(!_pool.deallocate(&_foreign));
+    MN_CHECK(_pool.get_used() == 1);
+
+    // the twice freed block is only once on the free stack
+    uint32_t* _blocks[4];
+    int _count = 0;
+
+    while(_count < 4 && (_blocks[_count] = _pool.allocate()) != NULL) _count++;
+
+    MN_CHECK(_count == 3);
+    for(int i = 0; i < _count; i++) MN_CHECK(_pool.deallocate(_blocks[i]));
+    MN_CHECK(_pool.deallocate(_b));
+    MN_CHECK(_pool.get_used() == 0);
+}
@@ -0,0 +1,75 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "mn_periodic_task.hpp"
+#include "mn_micros.hpp"
+
+using namespace mn;
+
+namespace {
+    /**
+     * Run count periods, each period runs busy for the given micro seconds
+     */
+    class busy_periodic : public basic_periodic_task {
+    public:
+        busy_periodic(unsigned int uiPeriod, unsigned long ulBusyUs, uint32_t uiCount)
+            : basic_periodic_task("periodic", uiPeriod, 0, 0, basic_task::PriorityUrgent, 8192), 
+              m_ulBusyUs(ulBusyUs), m_uiCount(uiCount) { }
+
+        virtual bool on_period() override {
+            unsigned long _start = micros();
+            while(micros() - _start < m_ulBusyUs) { }
+
+            return --m_uiCount > 0;
+        }
+    private:
+        unsigned long m_ulBusyUs;
+        uint32_t m_uiCount;
+    };
+}
+
+MN_TEST(periodic, no_overrun) {
+    busy_periodic _task(10, 1000, 10);
+
+    MN_CHECK(_task.start() == ERR_TASK_OK);
+    _task.join();
+
+    periodic_stats _stats = _task.get_stats();
+
+    MN_CHECK(_stats.periods == 10);
+    MN_CHECK(_stats.overruns == 0);
+    MN_CHECK(_stats.misses == 0);
+    MN_CHECK(_stats.skipped == 0);
+}
+
+MN_TEST(periodic, overrun_skips_releases) {
+    // 10 ticks of 1 ms period, each period runs 25 ms - so each period
+    // runs over two releases and misses the deadline
+    busy_periodic _task(10, 25000, 4);
+
+    MN_CHECK(_task.get_overrun_policy() == basic_periodic_task::SkipMissed);
+    MN_CHECK(_task.start() == ERR_TASK_OK);
+    _task.join();
+
+    periodic_stats _stats = _task.get_stats();
+
+    MN_CHECK(_stats.periods == 4);
+    MN_CHECK(_stats.overruns == 4);
+    MN_CHECK(_stats.misses == 4);
+    MN_CHECK(_stats.skipped >= 8 && _stats.skipped <= 12);
+}
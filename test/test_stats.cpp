@@ -0,0 +1,67 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "mn_task_stats.hpp"
+#include "mn_binary_semaphore.hpp"
+
+using namespace mn;
+
+MN_TEST(stats, busy_and_blocked_task) {
+    binary_semaphore_t _sem;
+    volatile bool _stop = false;
+
+    // the semaphore starts given, it is never given again
+    _sem.lock();
+
+    test::test_task _busy("busy", [&_stop]() { while(!_stop) { } });
+    // the port counts a wait on the end of the wait, so wait with timeouts
+    test::test_task _blocked("blocked", [&_sem, &_stop]() { while(!_stop) _sem.lock(10); });
+
+    MN_CHECK(_busy.start() == ERR_TASK_OK);
+    MN_CHECK(_blocked.start() == ERR_TASK_OK);
+
+    basic_task* _tasks[] = { &_busy, &_blocked };
+    basic_task_snapshot _snapshot;
+
+    vTaskDelay(20);
+    MN_CHECK(_snapshot.take(_tasks, 2) == 2);
+
+    vTaskDelay(200);
+    MN_CHECK(_snapshot.take(_tasks, 2) == 2);
+    MN_CHECK(_snapshot.get_interval() > 0);
+
+    const task_stats* _sBusy = _snapshot.find(_busy.get_id());
+    const task_stats* _sBlocked = _snapshot.find(_blocked.get_id());
+
+    MN_CHECK(_sBusy != NULL && _sBlocked != NULL);
+    if(_sBusy != NULL && _sBlocked != NULL) {
+        MN_CHECK(_sBusy->has(task_stats::HasRunTime));
+        MN_CHECK(_sBusy->utilization > 5000);
+        MN_CHECK(_sBusy->utilization <= 10000);
+
+        MN_CHECK(_sBlocked->has(task_stats::HasBlocked));
+        MN_CHECK(_sBlocked->utilization < 1000);
+        // waits on the semaphore since the start
+        MN_CHECK(_sBlocked->blocked_us[task_stats::BlockQueue] >= 150000);
+        MN_CHECK(_sBlocked->blocked_us[task_stats::BlockDelay] == 0);
+    }
+    _stop = true;
+
+    _busy.join();
+    _blocked.join();
+}
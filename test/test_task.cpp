@@ -0,0 +1,174 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "mn_static_task.hpp"
+#include "mn_task_pool.hpp"
+#include "mn_task_list.hpp"
+
+using namespace mn;
+
+namespace {
+    /**
+     * A callable, that checks in its destructor that the run is not in progress
+     */
+    struct sleepy_fn {
+        uint32_t* state;    ///< 1 while the callable runs, 2 after the run
+        bool* destroyedInRun;
+
+        void operator()() {
+            __atomic_store_n(state, 1, __ATOMIC_RELEASE);
+            vTaskDelay(20);
+            __atomic_store_n(state, 2, __ATOMIC_RELEASE);
+        }
+        ~sleepy_fn() {
+            if(__atomic_load_n(state, __ATOMIC_ACQUIRE) == 1) *destroyedInRun = true;
+        }
+    };
+}
+
+MN_TEST(task, join_all_short_tasks) {
+    // the tasks end while join_all registers, the join must not hang
+    for(int round = 0; round < 200; round++) {
+        test::test_task _a("join_a", []() { });
+        test::test_task _b("join_b", []() { });
+        test::test_task _c("join_c", [round]() { if(round & 1) vTaskDelay(1); });
+        basic_task* _tasks[] = { &_a, &_b, &_c };
+        bool _finished[3] = { false, false, false };
+
+        for(int i = 0; i < 3; i++) MN_CHECK(_tasks[i]->start() == ERR_TASK_OK);
+
+        MN_CHECK(basic_task::join_all(_tasks, 3, 1000, _finished) == ERR_TASK_OK);
+        MN_CHECK(_finished[0] && _finished[1] && _finished[2]);
+    }
+}
+
+MN_TEST(task, join_any_returns_first) {
+    binary_semaphore_t _sem;
+    _sem.lock();
+
+    test::test_task _slow("slow", [&_sem]() { _sem.lock(); });
+    test::test_task _fast("fast", []() { vTaskDelay(5); });
+    basic_task* _tasks[] = { &_slow, &_fast };
+    int _index = -1;
+
+    MN_CHECK(_slow.start() == ERR_TASK_OK);
+    MN_CHECK(_fast.start() == ERR_TASK_OK);
+
+    MN_CHECK(basic_task::join_any(_tasks, 2, 1000, &_index) == ERR_TASK_OK);
+    MN_CHECK(_index == 1);
+    MN_CHECK(basic_task::join_all(_tasks, 2, 10) == ERR_TASK_TIMEOUT);
+
+    _sem.unlock();
+    MN_CHECK(basic_task::join_all(_tasks, 2, 1000) == ERR_TASK_OK);
+}
+
+MN_TEST(task, join_all_killed_task) {
+    test::test_task _task("killed", []() { while(true) vTaskDelay(1); });
+    basic_task* _tasks[] = { &_task };
+
+    MN_CHECK(_task.start() == ERR_TASK_OK);
+    vTaskDelay(5);
+
+    MN_CHECK(_task.kill() == ERR_TASK_OK);
+    MN_CHECK(basic_task::join_all(_tasks, 1, 1000) == ERR_TASK_OK);
+}
+
+MN_TEST(task, static_task_destroy_running) {
+    uint32_t _state = 0;
+    bool _destroyedInRun = false;
+    {
+        basic_static_task<sleepy_fn, 8192> _task("sleepy", sleepy_fn{ &_state, &_destroyedInRun });
+        MN_CHECK(_task.start() == ERR_TASK_OK);
+
+        while(__atomic_load_n(&_state, __ATOMIC_ACQUIRE) == 0) vTaskDelay(1);
+        // the task runs, the destructor must join befor the callable is destroyed
+    }
+    MN_CHECK(_state == 2);
+    MN_CHECK(!_destroyedInRun);
+}
+
+MN_TEST(task, pool_run_fn_on_each_core) {
+    basic_task_pool _pool(basic_task::PriorityNormal, 8192);
+    uint32_t _done = 0;
+
+    MN_CHECK(_pool.create(2, 2) == ERR_TASKPOOL_OK);
+    MN_CHECK(_pool.get_size() == 2 * portNUM_PROCESSORS + 2);
+    MN_CHECK(_pool.run_fn([]() { }, portNUM_PROCESSORS, 0) == ERR_TASKPOOL_CORE);
+
+    // each round trip runs the callable and parks the task back in its sub pool
+    for(int core = -1; core < portNUM_PROCESSORS; core++) {
+        int _core = (core < 0) ? MN_THREAD_CONFIG_CORE_IFNO : core;
+
+        for(uint32_t i = 1; i <= 100; i++) {
+            MN_CHECK(_pool.run_fn([&_done]() { __atomic_add_fetch(&_done, 1, __ATOMIC_RELEASE); }, _core, 1000) == ERR_TASKPOOL_OK);
+
+            for(int w = 0; w < 1000 && _pool.get_idle(_core) != 2; w++) vTaskDelay(1);
+            MN_CHECK(_pool.get_idle(_core) == 2);
+        }
+    }
+    MN_CHECK(__atomic_load_n(&_done, __ATOMIC_ACQUIRE) == 100 * (portNUM_PROCESSORS + 1));
+
+    _pool.destroy();
+    MN_CHECK(!_pool.is_created());
+}
+
+MN_TEST(task, task_list_lookup) {
+    basic_task_list& _list = basic_task_list::instance();
+    binary_semaphore_t _sem;
+    _sem.lock();
+
+    test::test_task _a("list_a", [&_sem]() { _sem.lock(); _sem.unlock(); });
+    test::test_task _b("list_b", []() { });
+
+    MN_CHECK(_a.start() == ERR_TASK_OK);
+    MN_CHECK(_b.start() == ERR_TASK_OK);
+    _b.join();
+
+    _list.add_task(&_a);
+    _list.add_task(&_b);
+
+    int _idA = _a.get_id(), _idB = _b.get_id();
+
+    MN_CHECK(_list.get_task(_idA) == &_a);
+    MN_CHECK(_list.get_task(_idB) == &_b);
+    MN_CHECK(_list.get_task("list_a") == &_a);
+    MN_CHECK(_list.get_task(std::string("list_b")) == &_b);
+    MN_CHECK(_list.get_task("list_c") == NULL);
+
+    // after the remove the task is not found
+    _list.remove_task(&_a);
+    MN_CHECK(_list.get_task(_idA) == NULL);
+    MN_CHECK(_list.get_task("list_a") == NULL);
+    MN_CHECK(_list.get_task(_idB) == &_b);
+
+    // a restarted task has a new id, the add moves it in the id index
+    MN_CHECK(_b.start() == ERR_TASK_OK);
+    _b.join();
+    _list.add_task(&_b);
+
+    MN_CHECK(_b.get_id() != _idB);
+    MN_CHECK(_list.get_task(_b.get_id()) == &_b);
+    MN_CHECK(_list.get_task(_idB) == NULL);
+    MN_CHECK(_list.get_task("list_b") == &_b);
+
+    _list.remove_task(&_b);
+    MN_CHECK(_list.get_task("list_b") == NULL);
+
+    _sem.unlock();
+    _a.join();
+}
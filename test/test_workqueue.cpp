@@ -0,0 +1,263 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "mn_test.hpp"
+#include "queue/mn_workqueue_single.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_steal.hpp"
+#include "queue/mn_workqueue_prio.hpp"
+#include "queue/mn_workqueue_graph.hpp"
+#include "queue/mn_workqueue_strand.hpp"
+
+using namespace mn;
+
+namespace {
+    /**
+     * A heap allocated item, released from the work queue after the run
+     */
+    class count_item : public queue::work_queue_item_t {
+    public:
+        explicit count_item(uint32_t* c) : queue::work_queue_item_t(true), counter(c) { }
+
+        virtual bool on_work() override { __atomic_add_fetch(counter, 1, __ATOMIC_RELAXED); return true; }
+
+        uint32_t* counter;
+    };
+
+    /**
+     * A not deleted item for the graph nodes
+     */
+    class graph_item : public queue::work_queue_item_t {
+    public:
+        graph_item() : queue::work_queue_item_t(false), counter(NULL) { }
+
+        virtual bool on_work() override { __atomic_add_fetch(counter, 1, __ATOMIC_RELAXED); return true; }
+
+        uint32_t* counter;
+    };
+
+    /**
+     * A slow heap allocated item, counts the deletes
+     */
+    class slow_item : public queue::work_queue_item_t {
+    public:
+        explicit slow_item(uint32_t* d) : queue::work_queue_item_t(true), deleted(d) { }
+        virtual ~slow_item() { __atomic_add_fetch(deleted, 1, __ATOMIC_RELAXED); }
+
+        virtual bool on_work() override { vTaskDelay(1); return true; }
+
+        uint32_t* deleted;
+    };
+
+    /**
+     * A heap allocated strand item, checks the post order of its producer
+     * and that no other item of the strand runs at the same time
+     */
+    struct strand_check {
+        uint32_t last[4];   ///< the last run sequence of each producer
+        uint32_t running;
+        uint32_t done;
+        bool failed;
+    };
+
+    class order_item : public queue::work_queue_item_t {
+    public:
+        order_item(strand_check* c, uint32_t p, uint32_t s)
+            : queue::work_queue_item_t(true), check(c), producer(p), seq(s) { }
+
+        virtual bool on_work() override {
+            if(__atomic_add_fetch(&check->running, 1, __ATOMIC_ACQ_REL) != 1) check->failed = true;
+            if(check->last[producer] + 1 != seq) check->failed = true;
+
+            check->last[producer] = seq;
+            __atomic_sub_fetch(&check->running, 1, __ATOMIC_ACQ_REL);
+            __atomic_add_fetch(&check->done, 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        strand_check* check;
+        uint32_t producer, seq;
+    };
+
+    /**
+     * Queue items and wait until all are run
+     */
+    bool run_items(queue::basic_work_queue& wq, uint32_t count) {
+        uint32_t _done = 0;
+
+        for(uint32_t i = 0; i < count; i++) {
+            if(wq.queue(new count_item(&_done)) != ERR_WORKQUEUE_OK) return false;
+        }
+        for(int i = 0; i < 5000 && __atomic_load_n(&_done, __ATOMIC_RELAXED) != count; i++)
+            vTaskDelay(1);
+
+        return __atomic_load_n(&_done, __ATOMIC_RELAXED) == count;
+    }
+}
+
+MN_TEST(workqueue, single_runs_items) {
+    queue::basic_work_queue_single _queue;
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+    MN_CHECK(run_items(_queue, 100));
+}
+
+MN_TEST(workqueue, multi_runs_items) {
+    queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, 4);
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+    MN_CHECK(run_items(_queue, 1000));
+}
+
+MN_TEST(workqueue, single_destroy_releases_items) {
+    uint32_t _deleted = 0;
+    {
+        queue::basic_work_queue_single _queue(basic_task::PriorityNormal, 4096, 64);
+        MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+        for(int i = 0; i < 50; i++)
+            MN_CHECK(_queue.queue(new slow_item(&_deleted)) == ERR_WORKQUEUE_OK);
+
+        _queue.destroy();
+    }
+    MN_CHECK(_deleted == 50);
+}
+
+MN_TEST(workqueue, multi_destroy_releases_items) {
+    uint32_t _deleted = 0;
+    {
+        queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, 2);
+        MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+        for(int i = 0; i < 50; i++)
+            MN_CHECK(_queue.queue(new slow_item(&_deleted)) == ERR_WORKQUEUE_OK);
+
+        _queue.destroy();
+    }
+    MN_CHECK(_deleted == 50);
+}
+
+MN_TEST(workqueue, steal_destroy_releases_items) {
+    uint32_t _deleted = 0;
+    {
+        queue::basic_work_queue_steal _queue(basic_task::PriorityNormal, 4096, 64, 2);
+        MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+        for(int i = 0; i < 50; i++)
+            MN_CHECK(_queue.queue(new slow_item(&_deleted)) == ERR_WORKQUEUE_OK);
+
+        // destroy with pending items, the workers end after the current item
+        _queue.destroy();
+    }
+    MN_CHECK(_deleted == 50);
+}
+
+MN_TEST(workqueue, prio_destroy_releases_items) {
+    uint32_t _deleted = 0;
+    {
+        queue::basic_work_queue_prio _queue(basic_task::PriorityNormal, 4096, 16, 4, 2);
+        MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+        for(int i = 0; i < 50; i++) {
+            slow_item* _item = new slow_item(&_deleted);
+            _item->set_priority(i % 4);
+
+            MN_CHECK(_queue.queue(_item) == ERR_WORKQUEUE_OK);
+        }
+        _queue.destroy();
+    }
+    MN_CHECK(_deleted == 50);
+}
+
+MN_TEST(workqueue, strand_keeps_post_order) {
+    const uint32_t _perProducer = 500;
+
+    queue::basic_work_queue_multi _queue(basic_task::PriorityNormal, 4096, 64, 4);
+    queue::basic_work_strand _strand(_queue);
+    strand_check _check = { { 0, 0, 0, 0 }, 0, 0, false };
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+    {
+        // 4 producers post concurrently, the items of each producer run in order
+        test::test_task _p0("prod_0", [&]() { for(uint32_t i = 1; i <= _perProducer; i++) _strand.post(new order_item(&_check, 0, i)); });
+        test::test_task _p1("prod_1", [&]() { for(uint32_t i = 1; i <= _perProducer; i++) _strand.post(new order_item(&_check, 1, i)); });
+        test::test_task _p2("prod_2", [&]() { for(uint32_t i = 1; i <= _perProducer; i++) _strand.post(new order_item(&_check, 2, i)); });
+        test::test_task _p3("prod_3", [&]() { for(uint32_t i = 1; i <= _perProducer; i++) _strand.post(new order_item(&_check, 3, i)); });
+        basic_task* _tasks[] = { &_p0, &_p1, &_p2, &_p3 };
+
+        for(int i = 0; i < 4; i++) MN_CHECK(_tasks[i]->start() == ERR_TASK_OK);
+        MN_CHECK(basic_task::join_all(_tasks, 4, 5000) == ERR_TASK_OK);
+    }
+    for(int i = 0; i < 5000 && __atomic_load_n(&_check.done, __ATOMIC_ACQUIRE) != 4 * _perProducer; i++)
+        vTaskDelay(1);
+
+    MN_CHECK(_check.done == 4 * _perProducer);
+    MN_CHECK(!_check.failed);
+    for(int i = 0; i < 4; i++) MN_CHECK(_check.last[i] == _perProducer);
+
+    for(int i = 0; i < 100 && !_strand.is_idle(); i++) vTaskDelay(1);
+    MN_CHECK(_strand.is_idle());
+}
+
+MN_TEST(workqueue, graph_runs_on_full_queue) {
+    // a ladder of 2 nodes per layer, each node is the predecessor of both
+    // nodes of the next layer - the small queue is full most of the time
+    const int _layers = 200;
+
+    queue::basic_work_queue_single _queue(basic_task::PriorityNormal, 4096, 2);
+    queue::basic_work_graph _graph;
+    std::vector<graph_item> _items(_layers * 2);
+    std::vector<queue::work_graph_node*> _nodes;
+    uint32_t _done = 0;
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+
+    for(size_t i = 0; i < _items.size(); i++) {
+        _items[i].counter = &_done;
+        _nodes.push_back(_graph.add(&_items[i]));
+    }
+    for(int l = 1; l < _layers; l++) {
+        for(int a = 0; a < 2; a++)
+            for(int b = 0; b < 2; b++)
+                MN_CHECK(_nodes[l * 2 + a]->succeed(_nodes[(l - 1) * 2 + b]) == ERR_WORKQUEUE_OK);
+    }
+    MN_CHECK(_graph.run(_queue) == ERR_WORKQUEUE_OK);
+    MN_CHECK(_done == (uint32_t)_items.size());
+}
+
+MN_TEST(workqueue, pool_items_run) {
+    queue::basic_work_queue_single _queue;
+    uint32_t _done = 0;
+
+    MN_CHECK(_queue.create() == ERR_WORKQUEUE_OK);
+    MN_CHECK(_queue.get_pool_free() == _queue.get_pool_size());
+
+    for(int i = 0; i < 100; i++) {
+        // the pool is small, wait for a free item
+        while(_queue.queue_fn([&_done]() { __atomic_add_fetch(&_done, 1, __ATOMIC_RELAXED); }) != ERR_WORKQUEUE_OK)
+            vTaskDelay(1);
+    }
+    for(int i = 0; i < 5000 && __atomic_load_n(&_done, __ATOMIC_RELAXED) != 100; i++)
+        vTaskDelay(1);
+
+    // the last block goes back after the run of the callable
+    for(int i = 0; i < 100 && _queue.get_pool_free() != _queue.get_pool_size(); i++)
+        vTaskDelay(1);
+
+    MN_CHECK(_done == 100);
+    MN_CHECK(_queue.get_pool_free() == _queue.get_pool_size());
+}